@@ -1,11 +1,15 @@
 #include "veins/base/connectionManager/BaseConnectionManager.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 
+#include "veins/base/connectionManager/ChannelAccess.h"
 #include "veins/base/connectionManager/NicEntryDebug.h"
 #include "veins/base/connectionManager/NicEntryDirect.h"
 #include "veins/base/modules/BaseWorldUtility.h"
 #include "veins/base/utils/FindModule.h"
+#include "veins/base/utils/ThreadPool.h"
 
 #ifndef ccEV
 #define ccEV EV << getName() << ": "
@@ -55,6 +59,16 @@ void BaseConnectionManager::initialize(int stage)
 		coreDebug = hasPar("coreDebug") ? par("coreDebug").boolValue() : false;
 		drawMIR = hasPar("drawMaxIntfDist") ? par("drawMaxIntfDist").boolValue() : false;
 		sendDirect = hasPar("sendDirect") ? par("sendDirect").boolValue() : false;
+		connectionSlack = hasPar("connectionSlack") ? par("connectionSlack").doubleValue() : 0.0;
+		minGridCellSize = hasPar("minGridCellSize") ? par("minGridCellSize").doubleValue() : 50.0;
+		if (minGridCellSize <= 0) throw cRuntimeError("minGridCellSize has to be positive");
+		statsConnectionUpdates = 0;
+		statsConnectionUpdatesSkipped = 0;
+		statsRangeChecks = 0;
+
+		int analogueModelThreads = hasPar("analogueModelThreads") ? par("analogueModelThreads").longValue() : 0;
+		if (analogueModelThreads < 0) analogueModelThreads = std::thread::hardware_concurrency();
+		if (analogueModelThreads > 0) analogueModelPool = new Veins::ThreadPool(analogueModelThreads);
 
 		BaseWorldUtility* world = FindModule<BaseWorldUtility*>::findGlobalModule();
 
@@ -67,78 +81,8 @@ void BaseConnectionManager::initialize(int stage)
 		maxDistSquared = maxInterferenceDistance * maxInterferenceDistance;
 
 		//----initialize node grid-----
-		//step 1 - calculate dimension of grid
-		//one cell should have at least the size of maxInterferenceDistance
-		//but also should divide the playground in equal parts
-		Coord dim((*playgroundSize) / maxInterferenceDistance2);
-		gridDim = GridCoord(dim);
-
-		//A grid smaller or equal to 3x3 would mean that every cell has every
-		//other cell as direct neighbor (if our playground is a torus, even if
-		//not the most of the cells are direct neighbors of each other. So we
-		//reduce the grid size to 1x1.
-		if((gridDim.x <= 3) && (gridDim.y <= 3) && (gridDim.z <= 3))
-		{
-			gridDim.x = 1;
-			gridDim.y = 1;
-			gridDim.z = 1;
-		} else {
-			gridDim.x = std::max(1, gridDim.x);
-			gridDim.y = std::max(1, gridDim.y);
-			gridDim.z = std::max(1, gridDim.z);
-		}
-
-		//step 2 - initialize the matrix which represents our grid
-		NicEntries entries;
-		RowVector row;
-		NicMatrix matrix;
-
-		for (int i = 0; i < gridDim.z; ++i) {
-			row.push_back(entries);			//copy empty NicEntries to RowVector
-		}
-		for (int i = 0; i < gridDim.y; ++i) {//fill the ColVector with copies of
-			matrix.push_back(row);			 //the RowVector.
-		}
-		for (int i = 0; i < gridDim.x; ++i) {	//fill the grid with copies of
-			nicGrid.push_back(matrix);			//the matrix.
-		}
-		ccEV << " using " << gridDim.x << "x" <<
-							 gridDim.y << "x" <<
-							 gridDim.z << " grid" << endl;
-
-		//step 3 -	calculate the factor which maps the coordinate of a node
-		//			to the grid cell
-		//if we use a 1x1 grid every coordinate is mapped to (0,0, 0)
-		findDistance = Coord(std::max(playgroundSize->x, maxInterferenceDistance2),
-							 std::max(playgroundSize->y, maxInterferenceDistance2),
-							 std::max(playgroundSize->z, maxInterferenceDistance2));
-		//otherwise we divide the playground into cells of size of the maximum
-		//interference distance
-		if (gridDim.x != 1)
-			findDistance.x = playgroundSize->x / gridDim.x;
-		if (gridDim.y != 1)
-			findDistance.y = playgroundSize->y / gridDim.y;
-		if (gridDim.z != 1)
-			findDistance.z = playgroundSize->z / gridDim.z;
-
-		//since the upper playground borders (at pg-size) are part of the
-		//playground we have to assure that they are mapped to a valid
-		//(the last) grid cell we do this by increasing the find distance
-		//by a small value.
-		//This also assures that findDistance is never zero.
-		findDistance += Coord(EPSILON, EPSILON, EPSILON);
-
-		//findDistance (equals cell size) has to be greater or equal
-		//maxInt-distance
-		assert(findDistance.x >= maxInterferenceDistance2);
-		assert(findDistance.y >= maxInterferenceDistance2);
-		assert(findDistance.z >= maxInterferenceDistance2);
-
-		//playGroundSize has to be part of the playGround
-		assert(GridCoord(*playgroundSize, findDistance).x == gridDim.x - 1);
-		assert(GridCoord(*playgroundSize, findDistance).y == gridDim.y - 1);
-		assert(GridCoord(*playgroundSize, findDistance).z == gridDim.z - 1);
-		ccEV << "findDistance is " << findDistance.info() << endl;
+		//further grids are added for nics with smaller interference distances
+		getGridLevel(maxInterferenceDistance2);
 	}
 	else if (stage == 1)
 	{
@@ -146,89 +90,174 @@ void BaseConnectionManager::initialize(int stage)
 	}
 }
 
+size_t BaseConnectionManager::getGridLevel(double interferenceDistance)
+{
+	for (size_t i = 0; i < gridLevels.size(); ++i) {
+		if (gridLevels[i].interferenceDistance == interferenceDistance) return i;
+	}
+
+	gridLevels.push_back(GridLevel());
+	GridLevel& level = gridLevels.back();
+	level.interferenceDistance = interferenceDistance;
+
+	//step 1 - calculate dimension of grid
+	//one cell should have at least the size of the connection distance
+	//but also should divide the playground in equal parts; tiny interference
+	//distances would otherwise create millions of cells
+	double connectionDistance = std::max(interferenceDistance + connectionSlack, minGridCellSize);
+	Coord dim((*playgroundSize) / connectionDistance);
+	GridCoord& gridDim = level.gridDim;
+	gridDim = GridCoord(dim);
+
+	//A grid smaller or equal to 3x3 would mean that every cell has every
+	//other cell as direct neighbor (if our playground is a torus, even if
+	//not the most of the cells are direct neighbors of each other. So we
+	//reduce the grid size to 1x1.
+	if((gridDim.x <= 3) && (gridDim.y <= 3) && (gridDim.z <= 3))
+	{
+		gridDim.x = 1;
+		gridDim.y = 1;
+		gridDim.z = 1;
+	} else {
+		gridDim.x = std::max(1, gridDim.x);
+		gridDim.y = std::max(1, gridDim.y);
+		gridDim.z = std::max(1, gridDim.z);
+	}
+
+	//step 2 - initialize the matrix which represents our grid
+	NicEntries entries;
+	RowVector row;
+	NicMatrix matrix;
+
+	for (int i = 0; i < gridDim.z; ++i) {
+		row.push_back(entries);			//copy empty NicEntries to RowVector
+	}
+	for (int i = 0; i < gridDim.y; ++i) {//fill the ColVector with copies of
+		matrix.push_back(row);			 //the RowVector.
+	}
+	for (int i = 0; i < gridDim.x; ++i) {	//fill the grid with copies of
+		level.nicGrid.push_back(matrix);	//the matrix.
+	}
+	ccEV << " using " << gridDim.x << "x" <<
+						 gridDim.y << "x" <<
+						 gridDim.z << " grid" << endl;
+
+	//step 3 -	calculate the factor which maps the coordinate of a node
+	//			to the grid cell
+	//if we use a 1x1 grid every coordinate is mapped to (0,0, 0)
+	Coord& findDistance = level.findDistance;
+	findDistance = Coord(std::max(playgroundSize->x, connectionDistance),
+						 std::max(playgroundSize->y, connectionDistance),
+						 std::max(playgroundSize->z, connectionDistance));
+	//otherwise we divide the playground into cells of size of the maximum
+	//interference distance
+	if (gridDim.x != 1)
+		findDistance.x = playgroundSize->x / gridDim.x;
+	if (gridDim.y != 1)
+		findDistance.y = playgroundSize->y / gridDim.y;
+	if (gridDim.z != 1)
+		findDistance.z = playgroundSize->z / gridDim.z;
+
+	//since the upper playground borders (at pg-size) are part of the
+	//playground we have to assure that they are mapped to a valid
+	//(the last) grid cell we do this by increasing the find distance
+	//by a small value.
+	//This also assures that findDistance is never zero.
+	findDistance += Coord(EPSILON, EPSILON, EPSILON);
+
+	//findDistance (equals cell size) has to be greater or equal
+	//connection distance
+	assert(findDistance.x >= connectionDistance);
+	assert(findDistance.y >= connectionDistance);
+	assert(findDistance.z >= connectionDistance);
+
+	//playGroundSize has to be part of the playGround
+	assert(GridCoord(*playgroundSize, findDistance).x == gridDim.x - 1);
+	assert(GridCoord(*playgroundSize, findDistance).y == gridDim.y - 1);
+	assert(GridCoord(*playgroundSize, findDistance).z == gridDim.z - 1);
+	ccEV << "findDistance is " << findDistance.info() << endl;
+
+	return gridLevels.size() - 1;
+}
+
 void BaseConnectionManager::finish()
 {
     EV << "BaseConnectionManager::finish() called.\n";
+    if (connectionSlack > 0) {
+        recordScalar("connectionUpdates", statsConnectionUpdates);
+        recordScalar("connectionUpdatesSkipped", statsConnectionUpdatesSkipped);
+    }
+    recordScalar("gridLevels", gridLevels.size());
+    recordScalar("rangeChecks", statsRangeChecks);
     cComponent::finish();
 }
 
 BaseConnectionManager::GridCoord BaseConnectionManager
-	::getCellForCoordinate(const Coord& c)
+	::getCellForCoordinate(const GridLevel& level, const Coord& c)
 {
-    return GridCoord(c, findDistance);
+    return GridCoord(c, level.findDistance);
 }
 
 void BaseConnectionManager::updateConnections(int nicID,
 											  const Coord* oldPos,
 											  const Coord* newPos)
 {
-	GridCoord oldCell = getCellForCoordinate(*oldPos);
-    GridCoord newCell = getCellForCoordinate(*newPos);
+    NicEntries::mapped_type nic = nics[nicID];
+
+    // move nic to a new position in its own grid
+    GridLevel& own = gridLevels[nic->gridLevel];
+    GridCoord oldCell = getCellForCoordinate(own, *oldPos);
+    GridCoord newCell = getCellForCoordinate(own, *newPos);
+    if(oldCell != newCell) {
+        getCellEntries(own, oldCell).erase(nicID);
+        getCellEntries(own, newCell)[nicID] = nic;
+    }
+
+    // check the nics around the old and the new position in all grids
+    for (size_t l = 0; l < gridLevels.size(); ++l) {
+        GridLevel& level = gridLevels[l];
+        GridCoord rings = getNeighborRings(level, nic->interferenceDistance);
+        GridCoord oldLevelCell = getCellForCoordinate(level, *oldPos);
+        GridCoord newLevelCell = getCellForCoordinate(level, *newPos);
+
+        // structure to find union of grid squares
+        int cells = 2 * countNeighbors(level, rings);
+        CoordSet gridUnion(cells <= 54 ? 74 : 2 * cells + 1);
 
-	checkGrid(oldCell, newCell, nicID );
+        fillUnionWithNeighbors(gridUnion, level, oldLevelCell, rings);
+        if(oldLevelCell != newLevelCell) {
+            fillUnionWithNeighbors(gridUnion, level, newLevelCell, rings);
+        }
+
+        GridCoord* c = gridUnion.next();
+        while(c != 0) {
+            // ccEV << "Update cons in [" << c->info() << "]" << endl;
+            updateNicConnections(getCellEntries(level, *c), nic);
+            c = gridUnion.next();
+        }
+    }
 }
 
 BaseConnectionManager::NicEntries& BaseConnectionManager
-	::getCellEntries(BaseConnectionManager::GridCoord& cell)
+	::getCellEntries(GridLevel& level, BaseConnectionManager::GridCoord& cell)
 {
-    return nicGrid[cell.x][cell.y][cell.z];
+    return level.nicGrid[cell.x][cell.y][cell.z];
 }
 
 void BaseConnectionManager::registerNicExt(int nicID)
 {
 	NicEntries::mapped_type nicEntry = nics[nicID];
 
-	GridCoord cell = getCellForCoordinate(nicEntry->pos);
+	GridLevel& level = gridLevels[nicEntry->gridLevel];
+	GridCoord cell = getCellForCoordinate(level, nicEntry->pos);
 
 	ccEV <<" registering (ext) nic at loc " << cell.info() << std::endl;
 
 	// add to matrix
-	NicEntries& cellEntries = getCellEntries(cell);
+	NicEntries& cellEntries = getCellEntries(level, cell);
     cellEntries[nicID] = nicEntry;
 }
 
-void BaseConnectionManager::checkGrid(BaseConnectionManager::GridCoord& oldCell,
-                                      BaseConnectionManager::GridCoord& newCell,
-                                      int id)
-
-{
-
-    // structure to find union of grid squares
-    CoordSet gridUnion(74);
-
-    // find nic at old position
-    NicEntries&             oldCellEntries = getCellEntries(oldCell);
-    NicEntries::iterator    it  = oldCellEntries.find(id);
-    NicEntries::mapped_type nic = it->second;
-
-
-    // move nic to a new position in matrix
-    if(oldCell != newCell) {
-    	oldCellEntries.erase(it);
-    	getCellEntries(newCell)[id] = nic;
-    }
-
-	if((gridDim.x == 1) && (gridDim.y == 1) && (gridDim.z == 1)) {
-		gridUnion.add(oldCell);
-    } else {
-		//add grid around oldPos
-		fillUnionWithNeighbors(gridUnion, oldCell);
-
-
-        if(oldCell != newCell) {
-            //add grid around newPos
-            fillUnionWithNeighbors(gridUnion, newCell);
-        }
-    }
-
-    GridCoord* c = gridUnion.next();
-    while(c != 0) {
-		// ccEV << "Update cons in [" << c->info() << "]" << endl;
-		updateNicConnections(getCellEntries(*c), nic);
-		c = gridUnion.next();
-    }
-}
-
 int BaseConnectionManager::wrapIfTorus(int value, int max) {
 	if(value < 0) {
 		if(useTorus) {
@@ -247,20 +276,50 @@ int BaseConnectionManager::wrapIfTorus(int value, int max) {
 	}
 }
 
+BaseConnectionManager::GridCoord BaseConnectionManager::getNeighborRings(const GridLevel& level, double interferenceDistance)
+{
+	// nics are connected if either is within the interference distance of the other
+	double connectionDistance = std::max(interferenceDistance, level.interferenceDistance) + connectionSlack;
+	return GridCoord(std::max(1, (int)ceil(connectionDistance / level.findDistance.x)),
+					 std::max(1, (int)ceil(connectionDistance / level.findDistance.y)),
+					 std::max(1, (int)ceil(connectionDistance / level.findDistance.z)));
+}
+
+int BaseConnectionManager::countNeighbors(const GridLevel& level, const GridCoord& rings)
+{
+	return std::min(2 * rings.x + 1, level.gridDim.x)
+		 * std::min(2 * rings.y + 1, level.gridDim.y)
+		 * std::min(2 * rings.z + 1, level.gridDim.z);
+}
+
 void BaseConnectionManager::fillUnionWithNeighbors(CoordSet& gridUnion,
-												   GridCoord cell)
+												   const GridLevel& level,
+												   GridCoord cell,
+												   const GridCoord& rings)
 {
-	for(int iz = (int)cell.z - 1; iz <= (int)cell.z + 1; iz++) {
+	// on a torus, rings spanning the whole grid on an axis take every cell there, so they cannot wrap around twice
+	const GridCoord& gridDim = level.gridDim;
+	bool allZ = useTorus && (2 * rings.z + 1 >= gridDim.z);
+	bool allX = useTorus && (2 * rings.x + 1 >= gridDim.x);
+	bool allY = useTorus && (2 * rings.y + 1 >= gridDim.y);
+	int fromZ = allZ ? 0 : (int)cell.z - rings.z;
+	int toZ = allZ ? gridDim.z - 1 : (int)cell.z + rings.z;
+	int fromX = allX ? 0 : (int)cell.x - rings.x;
+	int toX = allX ? gridDim.x - 1 : (int)cell.x + rings.x;
+	int fromY = allY ? 0 : (int)cell.y - rings.y;
+	int toY = allY ? gridDim.y - 1 : (int)cell.y + rings.y;
+
+	for(int iz = fromZ; iz <= toZ; iz++) {
 		int cz = wrapIfTorus(iz, gridDim.z);
 		if(cz == -1) {
 			continue;
 		}
-		for(int ix = (int)cell.x - 1; ix <= (int)cell.x + 1; ix++) {
+		for(int ix = fromX; ix <= toX; ix++) {
 			int cx = wrapIfTorus(ix, gridDim.x);
 			if(cx == -1) {
 				continue;
 			}
-			for(int iy = (int)cell.y - 1; iy <= (int)cell.y + 1; iy++) {
+			for(int iy = fromY; iy <= toY; iy++) {
 				int cy = wrapIfTorus(iy, gridDim.y);
 				if(cy != -1) {
 					gridUnion.add(GridCoord(cx, cy, cz));
@@ -279,7 +338,21 @@ bool BaseConnectionManager::isInRange(BaseConnectionManager::NicEntries::mapped_
 	else
 		dDistance = sqrTorusDist(pFromNic->pos, pToNic->pos, *playgroundSize);
 
-	return dDistance <= maxInterferenceDistance2*maxInterferenceDistance2;
+	statsRangeChecks++;
+
+	double connectionDistance = std::max(pFromNic->interferenceDistance, pToNic->interferenceDistance) + connectionSlack;
+	return dDistance <= connectionDistance*connectionDistance;
+}
+
+bool BaseConnectionManager::isInInterferenceRange(const Coord& a, const Coord& b) const
+{
+	return isInInterferenceRange(a, b, maxInterferenceDistance2);
+}
+
+bool BaseConnectionManager::isInInterferenceRange(const Coord& a, const Coord& b, double distance) const
+{
+	double dDistance = useTorus ? sqrTorusDist(a, b, *playgroundSize) : a.sqrdist(b);
+	return dDistance <= distance*distance;
 }
 
 void BaseConnectionManager::updateNicConnections(NicEntries& nmap, BaseConnectionManager::NicEntries::mapped_type   nic)
@@ -302,6 +375,7 @@ void BaseConnectionManager::updateNicConnections(NicEntries& nmap, BaseConnectio
             	 << " are in range" << endl;
             nic->connectTo( nic_i );
             nic_i->connectTo( nic );
+            nic->neighborsOutdated = nic_i->neighborsOutdated = true;
         }
         else if ( !inRange && connected ) {
             // out of range: disconnect
@@ -310,6 +384,7 @@ void BaseConnectionManager::updateNicConnections(NicEntries& nmap, BaseConnectio
             	 << " are NOT in range" << endl;
             nic->disconnectFrom( nic_i );
             nic_i->disconnectFrom( nic );
+            nic->neighborsOutdated = nic_i->neighborsOutdated = true;
         }
     }
 }
@@ -336,8 +411,15 @@ bool BaseConnectionManager::registerNic(cModule* nic,
 	nicEntry->nicId = nicID;
 	nicEntry->hostId = nic->getParentModule()->getId();
 	nicEntry->pos = *nicPos;
+	nicEntry->connectionPos = *nicPos;
 	nicEntry->chAccess = chAccess;
 
+	// nics may interfere less far than the connection manager assumes
+	double interferenceDistance = chAccess->hasPar("interferenceDistance") ? chAccess->par("interferenceDistance").doubleValue() : -1;
+	if (interferenceDistance < 0 || interferenceDistance > maxInterferenceDistance2) interferenceDistance = maxInterferenceDistance2;
+	nicEntry->interferenceDistance = interferenceDistance;
+	nicEntry->gridLevel = getGridLevel(interferenceDistance);
+
 	// add to map
 	nics[nicID] = nicEntry;
 
@@ -346,7 +428,7 @@ bool BaseConnectionManager::registerNic(cModule* nic,
 	updateConnections(nicID, nicPos, nicPos);
 
 	if(drawMIR) {
-		nic->getParentModule()->getDisplayString().setTagArg("r", 0, maxInterferenceDistance2);
+		nic->getParentModule()->getDisplayString().setTagArg("r", 0, nicEntry->interferenceDistance);
 	}
 
 	return sendDirect;
@@ -365,32 +447,36 @@ bool BaseConnectionManager::unregisterNic(cModule* nicModule)
 	assert(nics.find(nicID) != nics.end());
 	NicEntries::mapped_type nicEntry = nics[nicID];
 
-	// get all affected grid squares
-	CoordSet gridUnion(74);
-	GridCoord cell = getCellForCoordinate(nicEntry->pos);
-	if((gridDim.x == 1) && (gridDim.y == 1) && (gridDim.z == 1)) {
-		gridUnion.add(cell);
-	} else {
-		fillUnionWithNeighbors(gridUnion, cell);
-	}
-
-	// disconnect from all NICs in these grid squares
-	GridCoord* c = gridUnion.next();
-	while(c != 0) {
-		ccEV << "Update cons in [" << c->info() << "]" << endl;
-		NicEntries& nmap = getCellEntries(*c);
-		for(NicEntries::iterator i = nmap.begin(); i != nmap.end(); ++i) {
-			NicEntries::mapped_type other = i->second;
-			if (other == nicEntry) continue;
-			if (!other->isConnected(nicEntry)) continue;
-			other->disconnectFrom(nicEntry);
-			nicEntry->disconnectFrom(other);
+	for (size_t l = 0; l < gridLevels.size(); ++l) {
+		GridLevel& level = gridLevels[l];
+
+		// get all affected grid squares
+		GridCoord rings = getNeighborRings(level, nicEntry->interferenceDistance);
+		int cells = countNeighbors(level, rings);
+		CoordSet gridUnion(cells <= 54 ? 74 : 2 * cells + 1);
+		fillUnionWithNeighbors(gridUnion, level, getCellForCoordinate(level, nicEntry->pos), rings);
+
+		// disconnect from all NICs in these grid squares
+		GridCoord* c = gridUnion.next();
+		while(c != 0) {
+			ccEV << "Update cons in [" << c->info() << "]" << endl;
+			NicEntries& nmap = getCellEntries(level, *c);
+			for(NicEntries::iterator i = nmap.begin(); i != nmap.end(); ++i) {
+				NicEntries::mapped_type other = i->second;
+				if (other == nicEntry) continue;
+				if (!other->isConnected(nicEntry)) continue;
+				other->disconnectFrom(nicEntry);
+				nicEntry->disconnectFrom(other);
+				other->neighborsOutdated = true;
+			}
+			c = gridUnion.next();
 		}
-		c = gridUnion.next();
 	}
 
 	// erase from grid
-	NicEntries& cellEntries = getCellEntries(cell);
+	GridLevel& own = gridLevels[nicEntry->gridLevel];
+	GridCoord cell = getCellForCoordinate(own, nicEntry->pos);
+	NicEntries& cellEntries = getCellEntries(own, cell);
 	cellEntries.erase(nicID);
 
 	// erase from list of known nics
@@ -410,6 +496,24 @@ void BaseConnectionManager::updateNicPos(int nicID, const Coord* newPos)
     Coord oldPos = ItNic->second->pos;
     ItNic->second->pos = *newPos;
 
+	// distances to this nic changed for the nic itself and everyone connected to it
+	ItNic->second->neighborsOutdated = true;
+	const NicEntry::GateList& gateList = ItNic->second->getGateList();
+	for (NicEntry::GateList::const_iterator it = gateList.begin(); it != gateList.end(); ++it)
+		it->first->neighborsOutdated = true;
+
+	// Connections reach connectionSlack beyond the interference distance, so they stay a superset of
+	// the nics in range while every nic is within a quarter of it from where its connections were
+	// computed (mobility modules extrapolating between updates may drift by another eighth)
+	if (connectionSlack > 0
+		&& newPos->sqrdist(ItNic->second->connectionPos) < (connectionSlack / 4) * (connectionSlack / 4)
+		&& getCellForCoordinate(gridLevels[ItNic->second->gridLevel], oldPos) == getCellForCoordinate(gridLevels[ItNic->second->gridLevel], *newPos)) {
+		statsConnectionUpdatesSkipped++;
+		return;
+	}
+	statsConnectionUpdates++;
+	ItNic->second->connectionPos = *newPos;
+
 	updateConnections(nicID, &oldPos, newPos);
 }
 
@@ -422,6 +526,40 @@ const NicEntry::GateList& BaseConnectionManager::getGateList(int nicID) const
     return ItNic->second->getGateList();
 }
 
+double BaseConnectionManager::getNicInterferenceDistance(int nicID) const
+{
+	NicEntries::const_iterator ItNic = nics.find(nicID);
+	if (ItNic == nics.end())
+		error("No nic with this ID (%d) is registered with this ConnectionManager.", nicID);
+
+	return ItNic->second->interferenceDistance;
+}
+
+const NicEntry::NeighborList& BaseConnectionManager::getNeighborsByDistance(int nicID)
+{
+	NicEntries::iterator ItNic = nics.find(nicID);
+	if (ItNic == nics.end())
+		error("No nic with this ID (%d) is registered with this ConnectionManager.", nicID);
+
+	NicEntry* nic = ItNic->second;
+	if (!nic->neighborsOutdated)
+		return nic->neighbors;
+
+	nic->neighbors.clear();
+	const NicEntry::GateList& gateList = nic->getGateList();
+	for (NicEntry::GateList::const_iterator it = gateList.begin(); it != gateList.end(); ++it) {
+		NicEntry::Neighbor neighbor;
+		neighbor.sqrDistance = useTorus ? sqrTorusDist(nic->pos, it->first->pos, *playgroundSize) : nic->pos.sqrdist(it->first->pos);
+		neighbor.nic = it->first;
+		neighbor.gate = it->second;
+		nic->neighbors.push_back(neighbor);
+	}
+	std::sort(nic->neighbors.begin(), nic->neighbors.end(), [](const NicEntry::Neighbor& a, const NicEntry::Neighbor& b) { return a.sqrDistance < b.sqrDistance; });
+	nic->neighborsOutdated = false;
+
+	return nic->neighbors;
+}
+
 const cGate* BaseConnectionManager::getOutGateTo(const NicEntry* nic,
 												 const NicEntry* targetNic) const
 {
@@ -438,4 +576,5 @@ BaseConnectionManager::~BaseConnectionManager()
 	for (NicEntries::iterator ne = nics.begin(); ne != nics.end(); ne++) {
 		delete ne->second;
 	}
+	delete analogueModelPool;
 }
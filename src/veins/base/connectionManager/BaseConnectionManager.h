@@ -6,6 +6,7 @@
 
 namespace Veins {
 class ChannelAccess;
+class ThreadPool;
 }
 
 /**
@@ -228,6 +229,36 @@ protected:
 	 * TkEnv.*/
 	bool drawMIR;
 
+	/**
+	 * @brief Extra distance up to which nics are connected beyond the
+	 * maximum interference distance (0: connections are exact).
+	 *
+	 * Connections of a nic are then only recomputed once it moved a quarter
+	 * of this distance or changed its grid cell, senders drop the surplus
+	 * receivers (see isInInterferenceRange).
+	 */
+	double connectionSlack;
+
+	/**
+	 * @brief Lower bound of the grid cell size.
+	 *
+	 * Bounds the number of cells of the grids of nics with a very small
+	 * interference distance; larger cells only mean more range checks.
+	 */
+	double minGridCellSize;
+
+	/** @brief Number of position updates that recomputed connections.*/
+	long statsConnectionUpdates;
+
+	/** @brief Number of position updates that did not need to recompute connections.*/
+	long statsConnectionUpdatesSkipped;
+
+	/**
+	 * @brief Worker threads evaluating analogue models for all receivers
+	 * of a frame when it is sent, or NULL to evaluate them on reception.
+	 */
+	Veins::ThreadPool* analogueModelPool;
+
 	/** @brief Type for 1-dimensional array of NicEntries.*/
 	typedef std::vector<NicEntries> RowVector;
 	/** @brief Type for 2-dimensional array of NicEntries.*/
@@ -236,47 +267,66 @@ protected:
     typedef std::vector<NicMatrix> NicCube;
 
 	/**
-	 * @brief Register of all nics
-     *
-     * This matrix keeps all nics according to their position.  It
-     * allows to restrict the position update to a subset of all nics.
-     */
-    NicCube nicGrid;
-
-    /**
-     * @brief Distance that helps to find a node under a certain
-     * position.
-     *
-     * Can be larger then @see maxInterferenceDistance to
-     * allow nodes to be placed into the same square if the playground
-     * is too small for the grid speedup to work.
+	 * @brief A grid for the nics of one interference distance.
+	 *
+	 * Nics with a smaller interference distance than the maximum (see
+	 * NicEntry::interferenceDistance) get a grid of their own with smaller
+	 * cells, so they only look at the cells around them there. Nics
+	 * searching a grid of smaller cells than their own look at as many
+	 * cells around them as their interference distance spans.
 	 */
-    Coord findDistance;
+	struct GridLevel {
+		/** @brief Interference distance of the nics in this grid.*/
+		double interferenceDistance;
+
+		/**
+		 * @brief Register of the nics of this level
+		 *
+		 * This matrix keeps the nics according to their position.  It
+		 * allows to restrict the position update to a subset of all nics.
+		 */
+		NicCube nicGrid;
+
+		/**
+		 * @brief Distance that helps to find a node under a certain
+		 * position.
+		 *
+		 * Can be larger then the interference distance to
+		 * allow nodes to be placed into the same square if the playground
+		 * is too small for the grid speedup to work.
+		 */
+		Coord findDistance;
+
+		/** @brief The size of the grid */
+		GridCoord gridDim;
+	};
+
+	/** @brief Grids by interference distance, the first one for maxInterferenceDistance2.*/
+	std::vector<GridLevel> gridLevels;
 
-    /** @brief The size of the grid */
-    GridCoord gridDim;
+	/** @brief Number of nic pairs checked by isInRange().*/
+	long statsRangeChecks;
 
 private:
 	/** @brief Manages the connections of a registered nic. */
     void updateNicConnections(NicEntries& nmap, NicEntries::mapped_type nic);
 
     /**
-     * @brief Check connections of a nic in the grid
+     * @brief Returns the index of the grid for the passed interference
+     * distance, creating it if necessary.
      */
-    void checkGrid(GridCoord& oldCell,
-                   GridCoord& newCell,
-                   int id);
+    size_t getGridLevel(double interferenceDistance);
 
     /**
      * @brief Calculates the corresponding cell of a coordinate.
      */
-    GridCoord getCellForCoordinate(const Coord& c);
+    GridCoord getCellForCoordinate(const GridLevel& level, const Coord& c);
 
     /**
      * @brief Returns the NicEntries of the cell with specified
      * coordinate.
      */
-    NicEntries& getCellEntries(GridCoord& cell);
+    NicEntries& getCellEntries(GridLevel& level, GridCoord& cell);
 
 	/**
 	 * If the value is outside of its bounds (zero and max) this function
@@ -286,9 +336,21 @@ private:
     int wrapIfTorus(int value, int max);
 
 	/**
-	 * @brief Adds every direct Neighbor of a GridCoord to a union of coords.
+	 * @brief Returns how many cells around its own a nic with the passed
+	 * interference distance has to look at in a grid, per axis.
 	 */
-    void fillUnionWithNeighbors(CoordSet& gridUnion, GridCoord cell);
+    GridCoord getNeighborRings(const GridLevel& level, double interferenceDistance);
+
+	/**
+	 * @brief Returns how many cells fillUnionWithNeighbors() adds at most.
+	 */
+    int countNeighbors(const GridLevel& level, const GridCoord& rings);
+
+	/**
+	 * @brief Adds every Neighbor of a GridCoord within the passed number of
+	 * cells to a union of coords.
+	 */
+    void fillUnionWithNeighbors(CoordSet& gridUnion, const GridLevel& level, GridCoord cell, const GridCoord& rings);
 protected:
 
 	/**
@@ -344,6 +406,8 @@ protected:
 
 public:
 
+	BaseConnectionManager() : analogueModelPool(0) {}
+
 	virtual ~BaseConnectionManager();
 
 	/** @brief Needs two initialization stages.*/
@@ -382,6 +446,47 @@ public:
 	/** @brief Returns the ingates of all nics in range.*/
 	const NicEntry::GateList& getGateList( int nicID) const;
 
+	/** @brief Returns the extra connection distance, see connectionSlack.*/
+	double getConnectionSlack() const { return connectionSlack; }
+
+	/** @brief Returns the worker threads for analogue models, see analogueModelPool.*/
+	Veins::ThreadPool* getAnalogueModelPool() const { return analogueModelPool; }
+
+	/** @brief Returns whether two positions are within the maximum interference distance.*/
+	bool isInInterferenceRange(const Coord& a, const Coord& b) const;
+
+	/** @brief Returns whether two positions are within the passed distance.*/
+	bool isInInterferenceRange(const Coord& a, const Coord& b, double distance) const;
+
+	/** @brief Returns the interference distance of a registered nic, see NicEntry::interferenceDistance.*/
+	double getNicInterferenceDistance(int nicID) const;
+
+	/**
+	 * @brief Returns the distance up to which a frame sent with the passed
+	 * power can interfere, at most maxInterferenceDistance2.
+	 *
+	 * Returns maxInterferenceDistance2 by default, so every connected nic
+	 * receives every frame.
+	 *
+	 * @param txPower transmission power [mW], or a negative value if unknown
+	 */
+	virtual double getInterferenceDistance(double txPower) const { return maxInterferenceDistance2; }
+
+	/**
+	 * @brief Returns whether getInterferenceDistance() depends on the power,
+	 * so senders only need to determine it if so. False by default.
+	 */
+	virtual bool cullsByTxPower() const { return false; }
+
+	/**
+	 * @brief Returns the connections of a nic ordered by distance.
+	 *
+	 * The order is only computed again after the nic, one of its
+	 * connections or its set of connections changed, so senders
+	 * transmitting several frames between such changes sort once.
+	 */
+	const NicEntry::NeighborList& getNeighborsByDistance(int nicID);
+
 	/** @brief Returns the ingate of the with id==targetID, or 0 if not in range.*/
 	const cGate* getOutGateTo(const NicEntry* nic, const NicEntry* targetNic) const;
 };
@@ -28,6 +28,7 @@
 
 #include "veins/base/connectionManager/ChannelAccess.h"
 
+#include <algorithm>
 #include <cassert>
 
 #include "veins/base/utils/FindModule.h"
@@ -66,6 +67,11 @@ void ChannelAccess::initialize( int stage )
         cc = getConnectionManager(nic);
         if( cc == NULL ) error("Could not find connectionmanager module");
         isRegistered = false;
+
+        broadcastBatchSize = hasPar("broadcastBatchSize") ? par("broadcastBatchSize").longValue() : 0;
+        statsBroadcastEvents = 0;
+        statsDeferredReceptions = 0;
+        statsMaxFesLength = 0;
     }
 
     usePropagationDelay = par("usePropagationDelay");
@@ -75,61 +81,172 @@ void ChannelAccess::initialize( int stage )
 
 void ChannelAccess::sendToChannel(cPacket *msg)
 {
-    const NicEntry::GateList& gateList = cc->getGateList( getParentModule()->getId());
-    NicEntry::GateList::const_iterator i = gateList.begin();
-
-    if(useSendDirect){
-        // use Andras stuff
-        if( i != gateList.end() ){
-        	simtime_t delay = SIMTIME_ZERO;
-            for(; i != --gateList.end(); ++i){
-            	//calculate delay (Propagation) to this receiving nic
-            	delay = calculatePropagationDelay(i->first);
-
-                int radioStart = i->second->getId();
-                int radioEnd = radioStart + i->second->size();
-                for (int g = radioStart; g != radioEnd; ++g)
-                    sendDirect(static_cast<cPacket*>(msg->dup()),
-                               delay, msg->getDuration(), i->second->getOwnerModule(), g);
-            }
-            //calculate delay (Propagation) to this receiving nic
-			delay = calculatePropagationDelay(i->first);
+    const NicEntry::GateList& connections = cc->getGateList( getParentModule()->getId());
+
+    // frames sent with less than maximum power may not reach all connected nics,
+    // finding the power scans the whole signal, so only do it if the connection manager uses it
+    double interferenceDistance = cc->getInterferenceDistance(cc->cullsByTxPower() ? getTransmissionPower(msg) : -1);
+    bool culled = interferenceDistance < BaseConnectionManager::maxInterferenceDistance2;
+
+    // with connection slack, connections include nics beyond the interference distance,
+    // which is the larger one of the two nics
+    NicEntry::GateList inRange;
+    if (culled) {
+        // neighbors are ordered by the positions nics last reported, the current ones
+        // of sender and receiver may be off by a quarter of the slack together
+        double candidateDistance = interferenceDistance + cc->getConnectionSlack() / 4;
+        const NicEntry::NeighborList& neighbors = cc->getNeighborsByDistance(getParentModule()->getId());
+        double ownDistance = cc->getNicInterferenceDistance(getParentModule()->getId());
+        Coord senderPos = getMobilityModule()->getCurrentPosition();
+        for (NicEntry::NeighborList::const_iterator it = neighbors.begin(); it != neighbors.end() && it->sqrDistance <= candidateDistance * candidateDistance; ++it) {
+            double distance = std::min(interferenceDistance, std::max(ownDistance, it->nic->interferenceDistance));
+            if (cc->getConnectionSlack() > 0 && !cc->isInInterferenceRange(senderPos, it->nic->chAccess->getMobilityModule()->getCurrentPosition(), distance)) continue;
+            inRange.insert(std::make_pair(it->nic, it->gate));
+        }
+    }
+    else if (cc->getConnectionSlack() > 0) {
+        double ownDistance = cc->getNicInterferenceDistance(getParentModule()->getId());
+        Coord senderPos = getMobilityModule()->getCurrentPosition();
+        for (NicEntry::GateList::const_iterator it = connections.begin(); it != connections.end(); ++it) {
+            double distance = std::max(ownDistance, it->first->interferenceDistance);
+            if (cc->isInInterferenceRange(senderPos, it->first->chAccess->getMobilityModule()->getCurrentPosition(), distance)) inRange.insert(*it);
+        }
+    }
+    const NicEntry::GateList& gateList = (culled || cc->getConnectionSlack() > 0) ? inRange : connections;
+
+    if (gateList.empty()) {
+        coreEV << "Nic is not connected to any gates!" << endl;
+        delete msg;
+        return;
+    }
 
+    // one copy of msg per receiving gate, the last one gets msg itself
+    Receptions receptions;
+    for (NicEntry::GateList::const_iterator i = gateList.begin(); i != gateList.end(); ++i) {
+        //calculate delay (Propagation) to this receiving nic
+        simtime_t delay = calculatePropagationDelay(i->first);
+
+        if (useSendDirect) {
+            // use Andras stuff
+            cModule* radioModule = i->second->getOwnerModule();
             int radioStart = i->second->getId();
             int radioEnd = radioStart + i->second->size();
-            for (int g = radioStart; g != --radioEnd; ++g)
-                sendDirect(static_cast<cPacket*>(msg->dup()),
-                           delay, msg->getDuration(), i->second->getOwnerModule(), g);
-
-            sendDirect(msg, delay, msg->getDuration(), i->second->getOwnerModule(), radioEnd);
+            for (int g = radioStart; g != radioEnd; ++g)
+                receptions.push_back(Reception(i->first, radioModule->gate(g), delay));
         }
-        else{
-            coreEV << "Nic is not connected to any gates!" << endl;
-            delete msg;
+        else {
+            // use our stuff
+            receptions.push_back(Reception(i->first, i->second, delay));
         }
     }
-    else{
-        // use our stuff
-        coreEV <<"sendToChannel: sending to gates\n";
-        if( i != gateList.end() ){
-        	simtime_t delay = SIMTIME_ZERO;
-            for(; i != --gateList.end(); ++i){
-            	//calculate delay (Propagation) to this receiving nic
-				delay = calculatePropagationDelay(i->first);
-
-                sendDelayed( static_cast<cPacket*>(msg->dup()),
-                             delay, i->second );
-            }
-            //calculate delay (Propagation) to this receiving nic
-			delay = calculatePropagationDelay(i->first);
-
-            sendDelayed( msg, delay, i->second );
+    for (Receptions::iterator r = receptions.begin(); r != --receptions.end(); ++r)
+        r->frame = static_cast<cPacket*>(msg->dup());
+    receptions.back().frame = msg;
+
+    prepareReceptions(receptions);
+
+    simtime_t duration = msg->getDuration();
+    coreEV <<"sendToChannel: sending to gates\n";
+    if (broadcastBatchSize > 0 && receptions.size() > (size_t)broadcastBatchSize) {
+        deferReceptions(receptions, duration, msg->getSchedulingPriority());
+    }
+    else {
+        for (Receptions::iterator r = receptions.begin(); r != receptions.end(); ++r) {
+            if (useSendDirect)
+                sendDirect(r->frame, r->delay, duration, r->gate);
+            else
+                sendDelayed(r->frame, r->delay, r->gate);
         }
-        else{
-            coreEV << "Nic is not connected to any gates!" << endl;
-            delete msg;
+    }
+
+    statsMaxFesLength = std::max(statsMaxFesLength, (long)getSimulation()->getFES()->getLength());
+}
+
+void ChannelAccess::deferReceptions(Receptions& receptions, simtime_t_cref duration, short priority)
+{
+    // stable, so copies arriving at the same time keep the order in which they would have been scheduled
+    std::stable_sort(receptions.begin(), receptions.end(), [](const Reception& a, const Reception& b) { return a.delay < b.delay; });
+
+    BroadcastEvent* event = new BroadcastEvent();
+    event->setSchedulingPriority(priority);
+    event->duration = duration;
+    event->receptions.resize(receptions.size());
+    for (size_t i = 0; i < receptions.size(); ++i) {
+        BroadcastEvent::PendingReception& pending = event->receptions[i];
+        pending.frame = receptions[i].frame;
+        pending.moduleId = receptions[i].gate->getOwnerModule()->getId();
+        pending.gateId = receptions[i].gate->getId();
+        pending.generation = receptions[i].nic->chAccess->generation;
+        pending.arrival = simTime() + receptions[i].delay;
+    }
+    broadcastEvents.insert(event);
+
+    statsDeferredReceptions += receptions.size() - broadcastBatchSize;
+    sendBroadcastBatch(event);
+}
+
+void ChannelAccess::sendBroadcastBatch(BroadcastEvent* event)
+{
+    size_t end = std::min(event->next + broadcastBatchSize, event->receptions.size());
+    for (; event->next < end; ++event->next) {
+        BroadcastEvent::PendingReception& pending = event->receptions[event->next];
+        cPacket* frame = pending.frame;
+        pending.frame = 0;
+
+        // the receiver may have been deleted, or parked in a module pool and maybe reused, since the frame was sent
+        cModule* module = getSimulation()->getModule(pending.moduleId);
+        cGate* gate = module ? module->gate(pending.gateId) : 0;
+        ChannelAccess* receiver = gate ? dynamic_cast<ChannelAccess*>(gate->getPathEndGate()->getOwnerModule()) : 0;
+        if (!gate || (receiver && receiver->generation != pending.generation)) {
+            delete frame;
+            continue;
         }
+
+        if (useSendDirect)
+            sendDirect(frame, pending.arrival - simTime(), event->duration, gate);
+        else
+            sendDelayed(frame, pending.arrival - simTime(), gate);
+    }
+
+    if (event->next == event->receptions.size()) {
+        broadcastEvents.erase(event);
+        delete event;
+        return;
     }
+
+    // the next batch is due when the last copy of this one arrives
+    statsBroadcastEvents++;
+    scheduleAt(event->receptions[end - 1].arrival, event);
+}
+
+bool ChannelAccess::handleBroadcastEvent(cMessage* msg)
+{
+    BroadcastEvent* event = dynamic_cast<BroadcastEvent*>(msg);
+    if (!event) return false;
+
+    assert(broadcastEvents.count(event));
+    sendBroadcastBatch(event);
+    return true;
+}
+
+void ChannelAccess::cancelBroadcastEvents()
+{
+    for (std::set<BroadcastEvent*>::iterator it = broadcastEvents.begin(); it != broadcastEvents.end(); ++it) {
+        cancelAndDelete(*it);
+    }
+    broadcastEvents.clear();
+}
+
+ChannelAccess::BroadcastEvent::~BroadcastEvent()
+{
+    for (PendingReceptions::iterator it = receptions.begin(); it != receptions.end(); ++it) {
+        delete it->frame;
+    }
+}
+
+ChannelAccess::~ChannelAccess()
+{
+    cancelBroadcastEvents();
 }
 
 simtime_t ChannelAccess::calculatePropagationDelay(const NicEntry* nic) {
@@ -25,6 +25,7 @@
 #define CHANNEL_ACCESS_H
 
 #include <omnetpp.h>
+#include <set>
 #include <vector>
 
 #include "veins/base/utils/MiXiMDefs.h"
@@ -76,10 +77,111 @@ protected:
 	/** @brief Is this module already registered with ConnectionManager? */
 	bool isRegistered;
 
+	/**
+	 * @brief Number of times this module has been parked in a module pool,
+	 * tells copies addressed to an earlier life from those for this one.
+	 */
+	unsigned long generation;
+
 	/** @brief Pointer to the World Utility, to obtain some global information*/
 	BaseWorldUtility* world;
 
+	/**
+	 * @brief How many copies of a frame are scheduled at a time, or 0 to
+	 * schedule the copies for all receivers when the frame is sent.
+	 *
+	 * See the parameter broadcastBatchSize of BasePhyLayer.
+	 */
+	int broadcastBatchSize;
+
+	/** @brief Number of broadcast events scheduled.*/
+	long statsBroadcastEvents;
+
+	/** @brief Number of copies not scheduled when their frame was sent.*/
+	long statsDeferredReceptions;
+
+	/** @brief Largest length of the future event set seen right after sending a frame.*/
+	long statsMaxFesLength;
+
 protected:
+	/** @brief The copy of a frame on its way to one receiving gate.*/
+	struct Reception {
+		cPacket* frame;
+		const NicEntry* nic;
+		cGate* gate;
+		simtime_t delay;
+
+		Reception(const NicEntry* nic, cGate* gate, simtime_t_cref delay) : frame(0), nic(nic), gate(gate), delay(delay) {}
+	};
+	typedef std::vector<Reception> Receptions;
+
+	/**
+	 * @brief Self message carrying the copies of a frame that are not
+	 * scheduled yet, ordered by arrival time.
+	 *
+	 * Receivers are kept as module and gate ids because they may be
+	 * deleted before their copy is due, and with their generation because
+	 * they may be parked and reused in the meantime.
+	 */
+	class BroadcastEvent : public cMessage {
+	public:
+		struct PendingReception {
+			cPacket* frame;
+			int moduleId;
+			int gateId;
+			unsigned long generation;
+			simtime_t arrival;
+		};
+		typedef std::vector<PendingReception> PendingReceptions;
+
+		PendingReceptions receptions;
+		/** @brief Index of the first reception not scheduled yet.*/
+		size_t next;
+		simtime_t duration;
+
+		BroadcastEvent() : cMessage("broadcast"), next(0) {}
+
+		/** @brief Deletes the copies not scheduled yet.*/
+		virtual ~BroadcastEvent();
+	};
+
+	/** @brief Broadcast events of this module not finished yet.*/
+	std::set<BroadcastEvent*> broadcastEvents;
+
+	/**
+	 * @brief Schedules the first broadcastBatchSize receptions, which must be
+	 * sorted by delay, and a BroadcastEvent for the others.
+	 */
+	void deferReceptions(Receptions& receptions, simtime_t_cref duration, short priority);
+
+	/** @brief Schedules the next batch of copies of a BroadcastEvent.*/
+	void sendBroadcastBatch(BroadcastEvent* event);
+
+	/**
+	 * @brief Handles msg if it is a BroadcastEvent of this module.
+	 *
+	 * @return whether msg was a BroadcastEvent
+	 */
+	bool handleBroadcastEvent(cMessage* msg);
+
+	/** @brief Cancels all broadcast events, dropping their pending copies.*/
+	void cancelBroadcastEvents();
+
+	/**
+	 * @brief Called by sendToChannel() with the copies of a frame right
+	 * before they are sent. Does nothing by default.
+	 */
+	virtual void prepareReceptions(Receptions& receptions) {}
+
+	/**
+	 * @brief Returns the power [mW] msg is sent with, or a negative value
+	 * if unknown, which is the default.
+	 *
+	 * Lets the ConnectionManager limit the receivers of msg to the nics
+	 * within its interference distance.
+	 */
+	virtual double getTransmissionPower(cPacket* msg) { return -1; }
+
 	/**
 	 * @brief Calculates the propagation delay to the passed receiving nic.
 	 */
@@ -93,10 +195,20 @@ protected:
 	 *
 	 * depending on which ConnectionManager module is used, the messages are
 	 * send via sendDirect() or to the respective gates.
+	 *
+	 * With broadcastBatchSize set and more receivers than that, only the
+	 * copies arriving first are scheduled right away. A BroadcastEvent
+	 * schedules the next batch when the last copy of the previous one
+	 * arrives, so the future event set holds a batch per frame instead of
+	 * a copy per receiver.
 	 **/
 	void sendToChannel(cPacket *msg);
 
 public:
+	ChannelAccess() : generation(0), broadcastBatchSize(0) {}
+
+	virtual ~ChannelAccess();
+
 	/**
 	 * @brief Returns a pointer to the ConnectionManager responsible for the
 	 * passed NIC module.
@@ -9,7 +9,7 @@ double ConnectionManager::calcInterfDist()
 	// the minimum carrier frequency for this cell
 	double carrierFrequency = par("carrierFrequency").doubleValue();
 	// maximum transmission power possible
-	double pMax = par("pMax").doubleValue();
+	pMax = par("pMax").doubleValue();
 	if (pMax <= 0)
 		error("Max transmission power is <=0!");
 	transmitPower_dBm = 10 * log10(pMax);
@@ -19,7 +19,9 @@ double ConnectionManager::calcInterfDist()
 	// minimum signal attenuation threshold (secondary use) [dBm]
 	double sat2 = par("sat2").doubleValue();
 	// minimum path loss coefficient
-	double alpha = par("alpha").doubleValue();
+	alpha = par("alpha").doubleValue();
+
+	cullByTxPower = par("cullByTxPower").boolValue();
 
 	double waveLength = (BaseWorldUtility::speedOfLight()/carrierFrequency);
 	// minimum power level to be able to physically receive a signal
@@ -34,3 +36,10 @@ double ConnectionManager::calcInterfDist()
 	return interfDistance;
 }
 
+double ConnectionManager::getInterferenceDistance(double txPower) const
+{
+	if (!cullByTxPower || txPower < 0 || txPower >= pMax)
+		return maxInterferenceDistance2;
+
+	return maxInterferenceDistance2 * pow(txPower / pMax, 1.0 / alpha);
+}
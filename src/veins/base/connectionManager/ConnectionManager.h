@@ -29,6 +29,30 @@ protected:
 	 * interference calculation
 	 */
 	virtual double calcInterfDist();
+
+	/** @brief Whether frames only reach the nics within the interference distance of their power.*/
+	bool cullByTxPower;
+
+	/** @brief Maximum transmission power [mW], see calcInterfDist().*/
+	double pMax;
+
+	/** @brief Minimum path loss coefficient, see calcInterfDist().*/
+	double alpha;
+
+public:
+	ConnectionManager() : cullByTxPower(false), pMax(0), alpha(0) {}
+
+	/**
+	 * @brief Returns the interference distance of the passed power if
+	 * cullByTxPower is set.
+	 *
+	 * The interference distance grows with the power to the 1/alpha, so a
+	 * frame sent at a quarter of pMax reaches half as far with alpha 2.
+	 */
+	virtual double getInterferenceDistance(double txPower) const;
+
+	/** @brief Returns cullByTxPower.*/
+	virtual bool cullsByTxPower() const { return cullByTxPower; }
 };
 
 #endif /*CONNECTIONMANAGER_H_*/
@@ -24,6 +24,7 @@
 
 #include <omnetpp.h>
 #include <map>
+#include <vector>
 
 #include "veins/base/utils/MiXiMDefs.h"
 #include "veins/base/utils/Coord.h"
@@ -67,9 +68,47 @@ protected:
     /** @brief Geographic location of the nic*/
     Coord pos;
 
+    /** @brief Location at which the connections of the nic were last computed*/
+    Coord connectionPos;
+
     /** @brief Points to this nics ChannelAccess module */
     ChannelAccess* chAccess;
 
+    /**
+     * @brief Distance up to which the nic interferes with others
+     *
+     * Two nics are connected if either is within the interference distance
+     * of the other. At most BaseConnectionManager::maxInterferenceDistance2.
+     **/
+    double interferenceDistance;
+
+    /** @brief Index of the grid of the connection manager holding the nic*/
+    size_t gridLevel;
+
+    /** @brief A connection of the nic together with the squared distance to the nic it goes to*/
+    struct Neighbor {
+        double sqrDistance;
+        const NicEntry* nic;
+        cGate* gate;
+    };
+    /** @brief Type for connections ordered by distance.*/
+    typedef std::vector<Neighbor> NeighborList;
+
+    /**
+     * @brief Connections of the nic ordered by distance
+     *
+     * Built on demand, see BaseConnectionManager::getNeighborsByDistance()
+     **/
+    NeighborList neighbors;
+
+    /**
+     * @brief Whether this nic, one of its connections or its set of connections
+     * changed since neighbors was built
+     *
+     * Mutable, because nics set it on the (const) entries they are connected to.
+     **/
+    mutable bool neighborsOutdated;
+
   protected:
     /** @brief Debug output switch*/
     bool coreDebug;
@@ -87,7 +126,7 @@ protected:
     /**
      * @brief Constructor, initializes all members
      */
-    NicEntry(bool debug) : nicId(0), nicPtr(0), hostId(0){
+    NicEntry(bool debug) : nicId(0), nicPtr(0), hostId(0), interferenceDistance(0), gridLevel(0), neighborsOutdated(true){
         coreDebug = debug;
     };
 
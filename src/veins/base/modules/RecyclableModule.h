@@ -0,0 +1,56 @@
+//
+// RecyclableModule - contract for simple modules that can be reused by a module pool
+// Copyright (C) 2018 Xu Le <xmutongxinXuLe@163.com>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#ifndef RECYCLABLEMODULE_H_
+#define RECYCLABLEMODULE_H_
+
+#include "veins/base/utils/MiXiMDefs.h"
+
+/**
+ * @brief Interface for simple modules which can be parked and reused instead of being deleted and re-created.
+ *
+ * OMNeT++ does not allow calling callInitialize() twice on a module, so a module pool
+ * (see TraCIScenarioManager parameter moduleRecyclingPoolSize) drives a parked module
+ * through this contract instead:
+ *
+ *   finish() -> recycle() -> ... parked ... -> reinitialize(0) ... reinitialize(numInitStages()-1)
+ *
+ * Before recycle() is called the pool has already unregistered the NIC from the connection
+ * manager, unsubscribed all signal listeners living inside the host, deleted WATCHes and
+ * removed pending events addressed to the host from the future event set (self-messages are
+ * only descheduled, so their owner may still delete or reuse them).
+ *
+ * A host is only pooled if every simple module in it implements this interface.
+ *
+ * @ingroup baseModules
+ *
+ * @author Xu Le
+ */
+class MIXIM_API RecyclableModule {
+public:
+	virtual ~RecyclableModule() {}
+
+	/** @brief Releases everything finish() leaves behind so that reinitialize() starts from a clean state. */
+	virtual void recycle() = 0;
+
+	/** @brief Brings the module into the state a fresh initialize(stage) would, reusing whatever is expensive to rebuild. */
+	virtual void reinitialize(int stage) = 0;
+};
+
+#endif /* RECYCLABLEMODULE_H_ */
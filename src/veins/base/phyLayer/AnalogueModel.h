@@ -39,6 +39,47 @@ public:
 	 * @param receiverPos	The position of frame receiver.
 	 */
 	virtual void filterSignal(AirFrame *frame, const Coord& sendersPos, const Coord& receiverPos) = 0;
+
+	/**
+	 * @brief Returns whether the expensive, position dependent part of
+	 * this model can be evaluated ahead of time by precompute().
+	 */
+	virtual bool isPrecomputable() const { return false; }
+
+	/**
+	 * @brief Returns whether the position dependent part of this model
+	 * only depends on the positions, so evaluate() may be cached per
+	 * link and reused by filterSignalPrecomputed() while neither end moves.
+	 *
+	 * Independent of isPrecomputable(): a model may be cacheable without
+	 * being safe to run on worker threads. Precomputable models are
+	 * always cacheable.
+	 */
+	virtual bool isLinkCacheable() const { return isPrecomputable(); }
+
+	/**
+	 * @brief Evaluates the position dependent part of the attenuation
+	 * for a frame between the passed positions.
+	 *
+	 * Called on worker threads, concurrently with other calls of precompute()
+	 * of this and other models, so it must not change any state, draw random
+	 * numbers or log. The result has to be bit-identical to what filterSignal()
+	 * computes for the same positions.
+	 */
+	virtual double precompute(const Coord& sendersPos, const Coord& receiverPos) const { return 0; }
+
+	/**
+	 * @brief Like precompute(), but called on the simulation thread,
+	 * so it may use caches, log or draw annotations. Models which are
+	 * link cacheable but not precomputable have to override this.
+	 */
+	virtual double evaluate(const Coord& sendersPos, const Coord& receiverPos) { return precompute(sendersPos, receiverPos); }
+
+	/**
+	 * @brief Like filterSignal(), but uses the result of precompute()
+	 * or evaluate() for the same positions instead of evaluating it again.
+	 */
+	virtual void filterSignalPrecomputed(AirFrame *frame, double precomputed) {}
 };
 
 #endif /*ANALOGUEMODEL_*/
@@ -243,6 +243,25 @@ Mapping* BaseDecider::calculateSnrMapping(AirFrame* frame)
 	return snrMap;
 }
 
+bool BaseDecider::isSnrAbove(AirFrame* frame, simtime_t_cref start, simtime_t_cref end, double threshold)
+{
+	/* calculate Noise-Strength-Mapping */
+	Signal& signal = frame->getSignal();
+
+	Mapping* noiseMap = calculateRSSIMapping(signal.getReceptionStart(), signal.getReceptionEnd(), frame);
+	assert(noiseMap);
+	ConstMapping* recvPowerMap = signal.getReceivingPower();
+	assert(recvPowerMap);
+
+	// divide lazily like calculateSnrMapping() does
+	bool isAbove = MappingUtils::isAbove(QuotientMapping(*recvPowerMap, *noiseMap, false, Argument::MappedZero()), start, end, threshold);
+
+	delete noiseMap;
+	noiseMap = 0;
+
+	return isAbove;
+}
+
 void BaseDecider::getChannelInfo(simtime_t_cref start, simtime_t_cref end,
                                  AirFrameVector& out)
 {
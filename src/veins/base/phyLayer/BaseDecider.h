@@ -306,6 +306,15 @@ protected:
 	 */
 	virtual Mapping* calculateSnrMapping(AirFrame* frame);
 
+	/**
+	 * @brief Checks if the SNR of a Signal is above the passed threshold
+	 * at start, at every key entry in between and at end.
+	 *
+	 * Decides like checking the mapping "calculateSnrMapping()" returns, but
+	 * without creating it and stopping at the first value not above threshold.
+	 */
+	virtual bool isSnrAbove(AirFrame* frame, simtime_t_cref start, simtime_t_cref end, double threshold);
+
 	/**
 	 * @brief Calculates a RSSI-Mapping (or Noise-Strength-Mapping) for a
 	 * Signal.
@@ -1,5 +1,7 @@
 #include "veins/base/phyLayer/BasePhyLayer.h"
 
+#include <algorithm>
+
 #include "veins/base/phyLayer/MacToPhyControlInfo.h"
 #include "veins/base/phyLayer/PhyToMacControlInfo.h"
 #include "veins/base/utils/FindModule.h"
@@ -7,14 +9,24 @@
 #include "veins/base/phyLayer/Decider.h"
 #include "veins/base/modules/BaseWorldUtility.h"
 #include "veins/base/connectionManager/BaseConnectionManager.h"
+#include "veins/base/utils/StartupProfiler.h"
+#include "veins/base/utils/ThreadPool.h"
 
 using Veins::AirFrame;
+using Veins::ThreadPool;
 
 //introduce BasePhyLayer as module to OMNet
 Define_Module(BasePhyLayer);
 
 Coord NoMobiltyPos = Coord::ZERO;
 
+namespace {
+	/** exact comparison, unlike Coord::operator== */
+	bool isSamePosition(const Coord& a, const Coord& b) {
+		return (a.x == b.x) && (a.y == b.y) && (a.z == b.z);
+	}
+}
+
 //--Initialization----------------------------------
 
 BasePhyLayer::BasePhyLayer():
@@ -22,6 +34,10 @@ BasePhyLayer::BasePhyLayer():
 	thermalNoise(0),
 	radio(0),
 	decider(0),
+	cacheLinkAttenuations(false),
+	maxLinkAttenuations(0),
+	statsLinkAttenuationHits(0),
+	statsLinkAttenuationMisses(0),
 	radioSwitchingOverTimer(0),
 	txOverTimer(0),
 	headerLength(-1),
@@ -45,6 +61,7 @@ template simtime_t BasePhyLayer::readPar<simtime_t>(const char* parName, const s
 template bool BasePhyLayer::readPar<bool>(const char* parName, const bool);
 
 void BasePhyLayer::initialize(int stage) {
+	Veins::StartupProfiler::Scope profilerScope(getClassName(), "initialize", stage);
 
 	ChannelAccess::initialize(stage);
 
@@ -72,6 +89,10 @@ void BasePhyLayer::initialize(int stage) {
 		sensitivity = FWMath::dBm2mW(sensitivity);
 
 		recordStats = par("recordStats").boolValue();
+		cacheLinkAttenuations = readPar("cacheLinkAttenuations", false);
+		maxLinkAttenuations = readPar("maxLinkAttenuations", 1024);
+		statsLinkAttenuationHits = 0;
+		statsLinkAttenuationMisses = 0;
 
 		//	- initialize radio
 		radio = initializeRadio();
@@ -177,12 +198,76 @@ void BasePhyLayer::getParametersFromXML(cXMLElement* xmlData, ParameterMap& outp
 void BasePhyLayer::finish(){
 	// give decider the chance to do something
 	decider->finish();
+
+	if (recordStats && cacheLinkAttenuations) {
+		recordScalar("linkAttenuationHits", statsLinkAttenuationHits);
+		recordScalar("linkAttenuationMisses", statsLinkAttenuationMisses);
+	}
+
+	if (recordStats && broadcastBatchSize > 0) {
+		recordScalar("broadcastEvents", statsBroadcastEvents);
+		recordScalar("deferredReceptions", statsDeferredReceptions);
+	}
+	if (recordStats) {
+		recordScalar("maxFesLength", statsMaxFesLength);
+	}
+}
+
+void BasePhyLayer::receiveSignal(cComponent *source, simsignal_t signalID, cObject *obj, cObject* details) {
+	ChannelAccess::receiveSignal(source, signalID, obj, details);
+
+	// every cached link ends here
+	if (signalID == mobilityStateChangedSignal) linkAttenuations.clear();
+}
+
+void BasePhyLayer::recycle() {
+	AirFrameVector channel;
+	channelInfo.getAirFrames(0, simTime(), channel);
+
+	for(AirFrameVector::iterator it = channel.begin();
+		it != channel.end(); ++it)
+	{
+		cancelAndDelete(*it);
+	}
+	channelInfo = ChannelInfo();
+
+	cancelEvent(txOverTimer);
+	cancelEvent(radioSwitchingOverTimer);
+
+	// copies of frames sent shortly before parking are lost, just like when the host is deleted
+	cancelBroadcastEvents();
+
+	linkAttenuations.clear();
+
+	// the pool has unregistered our NIC, registration happens again on the first mobility update
+	isRegistered = false;
+
+	// copies still deferred by senders were meant for this life
+	++generation;
+}
+
+void BasePhyLayer::reinitialize(int stage) {
+	ChannelAccess::initialize(stage);
+
+	if (stage == 0) {
+		// the RSAM belongs to the radio, so swap it in the analogue model list along with the radio
+		AnalogueModel* oldRsam = radio->getAnalogueModel();
+		delete radio;
+		radio = initializeRadio();
+		AnalogueModel* newRsam = radio->getAnalogueModel();
+		std::replace(analogueModels.begin(), analogueModels.end(), oldRsam, newRsam);
+
+		delete decider;
+		decider = 0;
+		initializeDecider(par("decider").xmlValue());
+	}
 }
 
 //-----Decider initialization----------------------
 
 
 void BasePhyLayer::initializeDecider(cXMLElement* xmlConfig) {
+	Veins::StartupProfiler::Scope profilerScope(getClassName(), "initializeDecider");
 
 	decider = 0;
 
@@ -229,6 +314,7 @@ Decider* BasePhyLayer::getDeciderFromName(std::string name, ParameterMap& params
 //-----AnalogueModels initialization----------------
 
 void BasePhyLayer::initializeAnalogueModels(cXMLElement* xmlConfig) {
+	Veins::StartupProfiler::Scope profilerScope(getClassName(), "initializeAnalogueModels");
 
 	/*
 	* first of all, attach the AnalogueModel that represents the RadioState
@@ -312,7 +398,8 @@ void BasePhyLayer::handleMessage(cMessage* msg) {
 
 	//self messages
 	if(msg->isSelfMessage()) {
-		handleSelfMessage(msg);
+		if(!handleBroadcastEvent(msg))
+			handleSelfMessage(msg);
 
 	//MacPkts <- MacToPhyControlInfo
 	} else if(msg->getArrivalGateId() == upperLayerIn) {
@@ -625,8 +712,104 @@ void BasePhyLayer::filterSignal(AirFrame *frame) {
 	const Coord sendersPos  = sendersMobility  ? sendersMobility->getCurrentPosition(/*sStart*/) : NoMobiltyPos;
 	const Coord receiverPos = receiverMobility ? receiverMobility->getCurrentPosition(/*sStart*/): NoMobiltyPos;
 
-	for(AnalogueModelList::const_iterator it = analogueModels.begin(); it != analogueModels.end(); it++)
-		(*it)->filterSignal(frame, sendersPos, receiverPos);
+	// results of the precomputable models evaluated when the frame was sent, else those of the link cacheable models cached for this link
+	const Signal::Precomputed* precomputed = &frame->getSignal().getPrecomputed();
+	bool fromLinkCache = false;
+	if (!isValidFor(*precomputed, sendersPos, receiverPos)) {
+		precomputed = 0;
+		if (cacheLinkAttenuations && hasLinkCacheableAnalogueModels()) {
+			fromLinkCache = true;
+			std::map<int, Signal::Precomputed>::iterator link = linkAttenuations.find(frame->getSenderModuleId());
+			if (link != linkAttenuations.end() && isValidFor(link->second, sendersPos, receiverPos)) {
+				statsLinkAttenuationHits++;
+				precomputed = &link->second;
+			}
+			else {
+				statsLinkAttenuationMisses++;
+				if (link == linkAttenuations.end()) {
+					// senders which stopped sending are never looked up again, flush them all at once
+					if (linkAttenuations.size() >= static_cast<size_t>(maxLinkAttenuations)) linkAttenuations.clear();
+					link = linkAttenuations.insert(std::make_pair(frame->getSenderModuleId(), Signal::Precomputed())).first;
+				}
+				// an entry of a sender which moved is overwritten in place
+				Signal::Precomputed& target = link->second;
+				target.sendersPos = sendersPos;
+				target.receiverPos = receiverPos;
+				target.factors.assign(analogueModels.size(), 0);
+				for(size_t i = 0; i < analogueModels.size(); ++i) {
+					if (analogueModels[i]->isLinkCacheable()) target.factors[i] = analogueModels[i]->evaluate(sendersPos, receiverPos);
+				}
+				precomputed = &target;
+			}
+		}
+	}
+
+	for(size_t i = 0; i < analogueModels.size(); ++i) {
+		bool usePrecomputed = precomputed && (fromLinkCache ? analogueModels[i]->isLinkCacheable() : analogueModels[i]->isPrecomputable());
+		if (usePrecomputed)
+			analogueModels[i]->filterSignalPrecomputed(frame, precomputed->factors[i]);
+		else
+			analogueModels[i]->filterSignal(frame, sendersPos, receiverPos);
+	}
+}
+
+bool BasePhyLayer::isValidFor(const Signal::Precomputed& precomputed, const Coord& sendersPos, const Coord& receiverPos) const {
+	return (precomputed.factors.size() == analogueModels.size())
+		   && isSamePosition(precomputed.sendersPos, sendersPos)
+		   && isSamePosition(precomputed.receiverPos, receiverPos);
+}
+
+bool BasePhyLayer::hasPrecomputableAnalogueModels() const {
+	for (AnalogueModelList::const_iterator it = analogueModels.begin(); it != analogueModels.end(); ++it) {
+		if ((*it)->isPrecomputable()) return true;
+	}
+	return false;
+}
+
+bool BasePhyLayer::hasLinkCacheableAnalogueModels() const {
+	for (AnalogueModelList::const_iterator it = analogueModels.begin(); it != analogueModels.end(); ++it) {
+		if ((*it)->isLinkCacheable()) return true;
+	}
+	return false;
+}
+
+void BasePhyLayer::prepareReceptions(Receptions& receptions) {
+	ThreadPool* pool = cc->getAnalogueModelPool();
+	if (!pool) return;
+
+	// look up everything the workers need, they must not touch any module
+	const Coord sendersPos = getMobilityModule()->getCurrentPosition();
+	std::vector<Signal::Precomputed*> results(receptions.size(), 0);
+	std::vector<const AnalogueModelList*> models(receptions.size(), 0);
+	for (size_t i = 0; i < receptions.size(); ++i) {
+		BasePhyLayer* receiver = dynamic_cast<BasePhyLayer*>(receptions[i].nic->chAccess);
+		AirFrame* frame = dynamic_cast<AirFrame*>(receptions[i].frame);
+		if (!receiver || !frame) continue;
+
+		if (!receiver->hasPrecomputableAnalogueModels()) continue;
+
+		Signal::Precomputed& precomputed = frame->getSignal().getPrecomputed();
+		precomputed.sendersPos = sendersPos;
+		precomputed.receiverPos = receiver->getMobilityModule()->getCurrentPosition();
+		precomputed.factors.assign(receiver->analogueModels.size(), 0);
+		results[i] = &precomputed;
+		models[i] = &receiver->analogueModels;
+	}
+
+	pool->parallelFor(receptions.size(), [&results, &models](size_t i) {
+		if (!results[i]) return;
+		for (size_t m = 0; m < models[i]->size(); ++m) {
+			const AnalogueModel* model = (*models[i])[m];
+			if (model->isPrecomputable()) results[i]->factors[m] = model->precompute(results[i]->sendersPos, results[i]->receiverPos);
+		}
+	});
+}
+
+double BasePhyLayer::getTransmissionPower(cPacket* msg) {
+	AirFrame* frame = dynamic_cast<AirFrame*>(msg);
+	if (!frame || !frame->getSignal().getTransmissionPower()) return -1;
+
+	return MappingUtils::findMax(*frame->getSignal().getTransmissionPower(), -1);
 }
 
 //--Destruction--------------------------------
@@ -7,6 +7,7 @@
 
 #include "veins/base/utils/MiXiMDefs.h"
 #include "veins/base/connectionManager/ChannelAccess.h"
+#include "veins/base/modules/RecyclableModule.h"
 #include "veins/base/phyLayer/DeciderToPhyInterface.h"
 #include "veins/base/phyLayer/MacToPhyInterface.h"
 
@@ -69,7 +70,8 @@ using Veins::Radio;
  */
 class MIXIM_API BasePhyLayer: public ChannelAccess,
                               public DeciderToPhyInterface,
-                              public MacToPhyInterface {
+                              public MacToPhyInterface,
+                              public RecyclableModule {
 
 protected:
 
@@ -121,6 +123,28 @@ protected:
 	/** @brief List of the analogue models to use.*/
 	AnalogueModelList analogueModels;
 
+	/** @brief Whether results of link cacheable analogue models are cached per link.*/
+	bool cacheLinkAttenuations;
+
+	/** @brief Number of links in linkAttenuations at which it is flushed.*/
+	int maxLinkAttenuations;
+
+	/**
+	 * @brief Results of the link cacheable analogue models per sending
+	 * module id, valid while both ends stay where they were evaluated.
+	 *
+	 * Cleared whenever this nic moves. An entry is overwritten when its sender
+	 * is found to have moved, and the whole map is flushed once it holds
+	 * maxLinkAttenuations links, so senders which left do not accumulate.
+	 */
+	std::map<int, Signal::Precomputed> linkAttenuations;
+
+	/** @brief Number of frames that used linkAttenuations.*/
+	long statsLinkAttenuationHits;
+
+	/** @brief Number of frames that had to evaluate the analogue models.*/
+	long statsLinkAttenuationMisses;
+
 	/**
 	 * @brief Used at initialisation to pass the parameters
 	 * to the AnalogueModel and Decider
@@ -359,6 +383,28 @@ protected:
 	 */
 	virtual void filterSignal(AirFrame *frame);
 
+	/**
+	 * @brief Evaluates the precomputable analogue models of every receiver
+	 * of a frame, in parallel if the ConnectionManager has worker threads
+	 * for it.
+	 *
+	 * Results are stored in the Signal of each receiver's copy and picked up
+	 * by filterSignal() if neither node moved in the meantime.
+	 */
+	virtual void prepareReceptions(Receptions& receptions);
+
+	/** @brief Returns the maximum of the transmission power of an AirFrame.*/
+	virtual double getTransmissionPower(cPacket* msg);
+
+	/** @brief Returns whether precomputed results match the analogue models and the passed positions.*/
+	bool isValidFor(const Signal::Precomputed& precomputed, const Coord& sendersPos, const Coord& receiverPos) const;
+
+	/** @brief Returns whether any analogue model is precomputable.*/
+	bool hasPrecomputableAnalogueModels() const;
+
+	/** @brief Returns whether any analogue model is link cacheable.*/
+	bool hasLinkCacheableAnalogueModels() const;
+
 	/**
 	 * @brief Called the moment the simulated switching process of the Radio is finished.
 	 *
@@ -400,9 +446,26 @@ public:
 	 */
 	virtual ~BasePhyLayer();
 
-	/** @brief Only calls the deciders finish method.*/
+	/** @brief Calls the deciders finish method and records link cache statistics.*/
 	virtual void finish();
 
+	/**
+	 * @brief Drops the cached link attenuations if this nic moved, see
+	 * ChannelAccess::receiveSignal().
+	 */
+	virtual void receiveSignal(cComponent *source, simsignal_t signalID, cObject *obj, cObject* details);
+
+	/**
+	 * @brief Drops all AirFrames on the channel and stops pending timers.
+	 */
+	virtual void recycle();
+
+	/**
+	 * @brief Re-creates radio and decider at stage 0 but keeps the
+	 * analogue models parsed from XML, which dominate the setup cost.
+	 */
+	virtual void reinitialize(int stage);
+
 	//---------MacToPhyInterface implementation-----------
 	/**
 	 * @name MacToPhyInterface implementation
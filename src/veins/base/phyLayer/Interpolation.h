@@ -3,6 +3,10 @@
 
 #include <limits>
 #include <map>
+#include <vector>
+#include <iterator>
+#include <functional>
+#include <cstddef>
 #include <algorithm>
 #include <assert.h>
 
@@ -97,6 +101,351 @@ public:
 	}
 };
 
+/**
+ * @brief A vector which stores up to N elements inside itself and only
+ * allocates memory on the heap if it grows beyond that.
+ *
+ * Provides the part of the std::vector interface SortedVectorMap and
+ * SortedVectorSet use. Meant for small numbers of cheap to copy elements:
+ * elements are default constructed up front and assigned to, and erased
+ * elements are not destroyed before the vector is.
+ *
+ * @ingroup mappingDetails
+ */
+template<class T, size_t N>
+class SmallVector {
+public:
+	typedef T                                     value_type;
+	typedef T&                                    reference;
+	typedef const T&                              const_reference;
+	typedef T*                                    iterator;
+	typedef const T*                              const_iterator;
+	typedef std::reverse_iterator<iterator>       reverse_iterator;
+	typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+	typedef size_t                                size_type;
+
+protected:
+	/** @brief Storage as long as there are at most N elements.*/
+	T         inlineData[N];
+	/** @brief Storage once there were more than N elements, NULL before.*/
+	T*        heapData;
+	size_type count;
+	size_type capacity;
+
+public:
+	SmallVector():
+		heapData(NULL), count(0), capacity(N)
+	{}
+
+	SmallVector(const SmallVector& o):
+		heapData(NULL), count(0), capacity(N)
+	{
+		assign(o.begin(), o.end());
+	}
+
+	~SmallVector() {
+		delete[] heapData;
+	}
+
+	SmallVector& operator=(const SmallVector& o) {
+		if(this != &o)
+			assign(o.begin(), o.end());
+		return *this;
+	}
+
+	iterator       begin()       { return heapData ? heapData : inlineData; }
+	const_iterator begin() const { return heapData ? heapData : inlineData; }
+	iterator       end()         { return begin() + count; }
+	const_iterator end()   const { return begin() + count; }
+
+	reverse_iterator       rbegin()       { return reverse_iterator(end()); }
+	const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+	reverse_iterator       rend()         { return reverse_iterator(begin()); }
+	const_reverse_iterator rend()   const { return const_reverse_iterator(begin()); }
+
+	reference       back()       { return *(end() - 1); }
+	const_reference back() const { return *(end() - 1); }
+
+	bool      empty() const { return count == 0; }
+	size_type size()  const { return count; }
+	void      clear()       { count = 0; }
+
+	void reserve(size_type n) {
+		if(n <= capacity)
+			return;
+
+		T* newData = new T[n];
+		std::copy(begin(), end(), newData);
+		delete[] heapData;
+		heapData = newData;
+		capacity = n;
+	}
+
+	void assign(const_iterator first, const_iterator last) {
+		size_type n = last - first;
+		reserve(n);
+		std::copy(first, last, begin());
+		count = n;
+	}
+
+	iterator insert(iterator pos, const T& value) {
+		size_type index = pos - begin();
+		T         copy  = value; // value may live inside this vector
+
+		if(count == capacity)
+			reserve(2 * capacity);
+
+		std::copy_backward(begin() + index, end(), end() + 1);
+		++count;
+		begin()[index] = copy;
+		return begin() + index;
+	}
+
+	void push_back(const T& value) {
+		insert(end(), value);
+	}
+
+	iterator erase(iterator pos) {
+		return erase(pos, pos + 1);
+	}
+
+	iterator erase(iterator first, iterator last) {
+		count = std::copy(last, end(), first) - begin();
+		return first;
+	}
+
+	bool operator==(const SmallVector& o) const {
+		return count == o.count && std::equal(begin(), end(), o.begin());
+	}
+
+	bool operator!=(const SmallVector& o) const {
+		return !(*this == o);
+	}
+};
+
+/**
+ * @brief A vector of keys kept sorted, which provides the part of the
+ * std::set interface DimensionSet uses.
+ *
+ * Like with SortedVectorMap every insertion invalidates all iterators.
+ *
+ * @ingroup mappingDetails
+ */
+template<class Key, class Vector = std::vector<Key> >
+class SortedVectorSet {
+public:
+	typedef Key                                          key_type;
+	typedef Key                                          value_type;
+	typedef std::less<Key>                               key_compare;
+	typedef Vector                                       vector_type;
+	typedef typename vector_type::const_iterator         iterator;
+	typedef typename vector_type::const_iterator         const_iterator;
+	typedef std::reverse_iterator<const_iterator>        reverse_iterator;
+	typedef std::reverse_iterator<const_iterator>        const_reverse_iterator;
+	typedef const Key&                                   reference;
+	typedef const Key&                                   const_reference;
+	typedef typename vector_type::size_type              size_type;
+
+protected:
+	vector_type                                          entries;
+
+public:
+	const_iterator begin() const { return entries.begin(); }
+	const_iterator end()   const { return entries.end(); }
+
+	const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+	const_reverse_iterator rend()   const { return const_reverse_iterator(begin()); }
+
+	bool      empty() const { return entries.empty(); }
+	size_type size()  const { return entries.size(); }
+	void      clear()       { entries.clear(); }
+
+	key_compare key_comp() const { return key_compare(); }
+
+	const_iterator lower_bound(const key_type& key) const { return std::lower_bound(begin(), end(), key); }
+	const_iterator upper_bound(const key_type& key) const { return std::upper_bound(begin(), end(), key); }
+
+	const_iterator find(const key_type& key) const {
+		const_iterator it = lower_bound(key);
+		return (it != end() && !(key < *it)) ? it : end();
+	}
+
+	size_type count(const key_type& key) const {
+		return find(key) != end() ? 1 : 0;
+	}
+
+	std::pair<const_iterator, bool> insert(const value_type& value) {
+		// sets are mostly built in order, so check for appending first
+		if(entries.empty() || entries.back() < value) {
+			entries.push_back(value);
+			return std::make_pair(end() - 1, true);
+		}
+		const_iterator it = lower_bound(value);
+		if(!(value < *it)) {
+			return std::make_pair(it, false);
+		}
+		size_type index = it - begin();
+		entries.insert(entries.begin() + index, value);
+		return std::make_pair(begin() + index, true);
+	}
+
+	const_iterator insert(const_iterator /*hint*/, const value_type& value) {
+		return insert(value).first;
+	}
+
+	template<class InputIterator>
+	void insert(InputIterator first, InputIterator last) {
+		for(; first != last; ++first)
+			insert(*first);
+	}
+
+	size_type erase(const key_type& key) {
+		const_iterator it = find(key);
+		if(it == end())
+			return 0;
+		entries.erase(entries.begin() + (it - begin()));
+		return 1;
+	}
+
+	bool operator==(const SortedVectorSet& other) const { return entries == other.entries; }
+	bool operator!=(const SortedVectorSet& other) const { return entries != other.entries; }
+};
+
+/**
+ * @brief A vector (std::vector or SmallVector) of key-value-pairs kept sorted
+ * by key, which provides the part of the std::map interface the interpolators,
+ * InterpolateableMap and Argument use.
+ *
+ * Lookups are binary searches over contiguous memory and appending in key
+ * order (the usual way signals are built) takes amortized constant time.
+ * Inserting anywhere else moves all later entries, and unlike with std::map
+ * every insertion invalidates all iterators.
+ *
+ * @ingroup mappingDetails
+ */
+template<class Key, class V, class Vector = std::vector<std::pair<Key, V> > >
+class SortedVectorMap {
+public:
+	typedef Key                                          key_type;
+	typedef V                                            mapped_type;
+	typedef std::pair<Key, V>                            value_type;
+	typedef std::less<Key>                               key_compare;
+	typedef Vector                                       vector_type;
+	typedef typename vector_type::iterator               iterator;
+	typedef typename vector_type::const_iterator         const_iterator;
+	typedef std::reverse_iterator<iterator>              reverse_iterator;
+	typedef std::reverse_iterator<const_iterator>        const_reverse_iterator;
+	typedef typename vector_type::size_type              size_type;
+
+protected:
+	vector_type                                          entries;
+	PairLess<value_type, key_type>                       comp;
+
+public:
+	iterator       begin()       { return entries.begin(); }
+	const_iterator begin() const { return entries.begin(); }
+	iterator       end()         { return entries.end(); }
+	const_iterator end()   const { return entries.end(); }
+
+	reverse_iterator       rbegin()       { return reverse_iterator(end()); }
+	const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+	reverse_iterator       rend()         { return reverse_iterator(begin()); }
+	const_reverse_iterator rend()   const { return const_reverse_iterator(begin()); }
+
+	bool      empty() const { return entries.empty(); }
+	size_type size()  const { return entries.size(); }
+	void      clear()       { entries.clear(); }
+	void      reserve(size_type n) { entries.reserve(n); }
+
+	key_compare key_comp() const { return key_compare(); }
+
+	iterator       lower_bound(const key_type& key)       { return std::lower_bound(entries.begin(), entries.end(), key, comp); }
+	const_iterator lower_bound(const key_type& key) const { return std::lower_bound(entries.begin(), entries.end(), key, comp); }
+	iterator       upper_bound(const key_type& key)       { return std::upper_bound(entries.begin(), entries.end(), key, comp); }
+	const_iterator upper_bound(const key_type& key) const { return std::upper_bound(entries.begin(), entries.end(), key, comp); }
+
+	iterator find(const key_type& key) {
+		iterator it = lower_bound(key);
+		return (it != end() && !(key < it->first)) ? it : end();
+	}
+	const_iterator find(const key_type& key) const {
+		const_iterator it = lower_bound(key);
+		return (it != end() && !(key < it->first)) ? it : end();
+	}
+
+	/**
+	 * @brief Inserts the passed pair unless its key exists, hint is where
+	 * it belongs if the caller knows (e.g. end() when appending).
+	 *
+	 * Returns an iterator to the entry with the key of the passed pair.
+	 */
+	iterator insert(iterator hint, const value_type& value) {
+		if((hint == end() || value.first < hint->first) && (hint == begin() || (hint - 1)->first < value.first)) {
+			return entries.insert(hint, value);
+		}
+		iterator it = lower_bound(value.first);
+		if(it != end() && !(value.first < it->first)) {
+			return it;
+		}
+		return entries.insert(it, value);
+	}
+
+	std::pair<iterator, bool> insert(const value_type& value) {
+		iterator it = lower_bound(value.first);
+		if(it != end() && !(value.first < it->first)) {
+			return std::make_pair(it, false);
+		}
+		return std::make_pair(entries.insert(it, value), true);
+	}
+
+	mapped_type& operator[](const key_type& key) {
+		if(entries.empty() || entries.back().first < key) {
+			entries.push_back(value_type(key, mapped_type()));
+			return entries.back().second;
+		}
+		iterator it = lower_bound(key);
+		if(key < it->first) {
+			it = entries.insert(it, value_type(key, mapped_type()));
+		}
+		return it->second;
+	}
+
+	iterator erase(iterator pos) { return entries.erase(pos); }
+	iterator erase(iterator first, iterator last) { return entries.erase(first, last); }
+
+	bool operator==(const SortedVectorMap& other) const { return entries == other.entries; }
+	bool operator!=(const SortedVectorMap& other) const { return entries != other.entries; }
+};
+
+/**
+ * @brief Selects std::map as the storage of TimeMapping and MultiDimMapping.
+ *
+ * Entries can be inserted anywhere without invalidating iterators.
+ *
+ * @ingroup mappingDetails
+ */
+struct MapStorage {
+	template<class Key, class V>
+	struct container {
+		typedef std::map<Key, V> type;
+	};
+};
+
+/**
+ * @brief Selects SortedVectorMap as the storage of TimeMapping and MultiDimMapping.
+ *
+ * Faster to look up and iterate, but only suited to mappings which are
+ * filled in key order and not changed while other iterators are in use.
+ *
+ * @ingroup mappingDetails
+ */
+struct SortedVectorStorage {
+	template<class Key, class V>
+	struct container {
+		typedef SortedVectorMap<Key, V> type;
+	};
+};
+
 template<class _ContainerType>
 class InterpolatorBase {
 public:
@@ -585,7 +934,8 @@ public:
 		if(pos == position)
 			return;
 
-		if(first != last)
+		// sequential accesses mostly stay between the same two entries
+		if(first != last && !isUpperBound(right, pos))
 			right = std::upper_bound(first, last, pos, interpolate.comp);
 
 		position = pos;
@@ -695,6 +1045,20 @@ public:
 	const interpolator_type&  getInterpolator() const {
 		return interpolate;
 	}
+
+protected:
+	/**
+	 * @brief Returns true if it points to the first entry whose key is
+	 * bigger than pos (as std::upper_bound would return).
+	 */
+	bool isUpperBound(used_iterator it, key_cref_type pos) const {
+		if(it != last && !(pos < it->first))
+			return false;
+		if(it == first)
+			return true;
+		--it;
+		return !(pos < it->first);
+	}
 };
 
 /**
@@ -745,19 +1109,21 @@ public:
 	 * current position of the iterator to the passed value
 	 */
 	void setValue(mapped_cref_type value) {
-		//container is empty or position is smaller first entry
-		if(this->right == this->first) {
-			//insert new entry before first entry and store new entry as new first
-			this->first = cont.insert(this->first, std::make_pair(this->position, value));
-		} else {
+		if(this->right != this->first) {
 			iterator left = this->right;
 			--left;
 			if(left->first == this->position) {
 				left->second = value;
-			} else {
-				cont.insert(this->right, std::make_pair(this->position, value));
+				return;
 			}
 		}
+
+		//insert new entry before the next bigger one (which may be the first entry);
+		//containers like SortedVectorMap invalidate all iterators on insertion, so refresh them
+		iterator inserted = cont.insert(this->right, std::make_pair(this->position, value));
+		this->first = cont.begin();
+		this->last = cont.end();
+		this->right = ++inserted;
 	}
 };
 
@@ -378,7 +378,7 @@ void SimpleConstMapping::initializeArguments(const Argument& min,
                                              const Argument& max,
                                              const Argument& interval) {
 	keyEntries.clear();
-	DimensionSet::const_iterator dimIt = --(dimensions.end());
+	DimensionSet::const_iterator dimIt = dimensions.end() - 1;
 	Argument                     pos   = min;
 
 	if(*dimIt == Dimension::time())
@@ -149,10 +149,13 @@ public:
  * @brief Represents a set of dimensions which is used to define over which
  * dimensions a mapping is defined (the domain of the mapping).
  *
- * This class actually public extends from std::set<Dimension>. So any method
- * provided by std::set can be also used.
+ * This class actually public extends from SortedVectorSet<Dimension>, which
+ * provides the commonly used methods of std::set.
  *
- * The dimensions are stored ordered by their ids.
+ * The dimensions are stored ordered by their ids. Up to three dimensions
+ * (enough for time and frequency plus one more) are stored inside the
+ * DimensionSet itself, so creating and copying these does not allocate
+ * memory.
  *
  * Note: Unlike Arguments and Mappings, a DimensionSet does not contain "time"
  * as dimension per default. You'll have to add it like any other dimension.
@@ -160,7 +163,7 @@ public:
  * @author Karl Wessel
  * @ingroup mapping
  */
-class MIXIM_API DimensionSet:public std::set<Dimension> {
+class MIXIM_API DimensionSet:public SortedVectorSet<Dimension, SmallVector<Dimension, 3> > {
 public:
 	/** @brief Shortcut to a DimensionSet which only contains time. */
 	static const DimensionSet& timeDomain() {
@@ -252,7 +255,7 @@ public:
 	/**
 	 * @brief Returns true if the dimensions of both sets are equal.
 	 */
-	bool operator==(const DimensionSet& o){
+	bool operator==(const DimensionSet& o) const {
 		if(size() != o.size())
 			return false;
 
@@ -269,6 +272,12 @@ public:
  * Note: Currently an Argument can be maximal defined over ten Dimensions
  * plus the time dimension!
  *
+ * The values of up to INLINE_DIMENSIONS dimensions besides time (enough
+ * for frequency plus one more) are stored inside the Argument itself, so
+ * creating, copying and comparing Arguments of the usual time and
+ * frequency domain does not allocate memory. Arguments with more
+ * dimensions store their values on the heap.
+ *
  * @author Karl Wessel
  * @ingroup mapping
  */
@@ -288,9 +297,12 @@ public:
 		static Argument::mapped_type o(1);
 		return o;
 	}
+	/** @brief Number of dimensions besides time which can be stored without allocating memory.*/
+	static const size_t INLINE_DIMENSIONS = 2;
 protected:
-	typedef std::map<key_type, mapped_type> container_type;
-	typedef container_type::value_type      value_type;
+	typedef std::pair<key_type, mapped_type>                              value_type;
+	typedef SortedVectorMap<key_type, mapped_type
+	                      , SmallVector<value_type, INLINE_DIMENSIONS> > container_type;
 	/** @brief Stores the time dimension in Omnet's time type */
 	simtime_t      time;
 
@@ -319,24 +331,6 @@ protected:
 	 */
 	inline iterator insertValue(iterator pos, const Argument::value_type& valPair, iterator& itEnd, bool ignoreUnknown = false);
 
-	template<typename IteratorType>
-	class key_iterator : public IteratorType
-	{
-	public:
-	    typedef typename IteratorType::value_type::first_type const& reference;
-	    typedef typename IteratorType::value_type::first_type const* pointer;
-
-	    key_iterator(const IteratorType& other) : IteratorType(other) {} ;
-
-	    reference operator *() const
-	    {
-	        return IteratorType::operator*().first;
-	    }
-	    pointer operator ->() const
-	    {
-	        return &IteratorType::operator->()->first;
-	    }
-	};
 public:
 	/**
 	 * @brief Initialize this argument with the passed value for
@@ -462,11 +456,11 @@ public:
 	 * dimensions inside this Argument.
 	 */
 	DimensionSet getDimensions() const {
-		typedef key_iterator<const_iterator> key_const_iterator;
-
 		DimensionSet res(Dimension::time());
 
-		res.insert(key_const_iterator(values.begin()), key_const_iterator(values.end()));
+		for (const_iterator it = values.begin(); it != values.end(); ++it) {
+			res.insert(it->first);
+		}
 
 		return res;
 	}
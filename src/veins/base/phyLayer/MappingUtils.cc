@@ -284,6 +284,22 @@ Mapping::argument_value_t MappingUtils::findMax(const ConstMapping& m, const Arg
 	return res;
 }
 
+bool MappingUtils::isAbove(const ConstMapping& m, simtime_t_cref from, simtime_t_cref to, Argument::mapped_type_cref threshold) {
+	ConstMappingIterator* it = m.createConstIterator(Argument(from));
+	bool                  res = !(it->getValue() <= threshold);
+
+	while(res && it->hasNext() && it->getNextPosition().getTime() < to) {
+		it->next();
+		res = !(it->getValue() <= threshold);
+	}
+	if(res) {
+		it->iterateTo(Argument(to));
+		res = !(it->getValue() <= threshold);
+	}
+	delete it;
+	return res;
+}
+
 Mapping::argument_value_t MappingUtils::findMin(const ConstMapping& m, Argument::mapped_type_cref cRetNotFound /*= cMinNotFound*/) {
 	ConstMappingIterator*     it       = m.createConstIterator();
 	bool                      bIsFirst = true;
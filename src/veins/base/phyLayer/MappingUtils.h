@@ -8,10 +8,13 @@
 #ifndef SIGNALINTERFACES_H_
 #define SIGNALINTERFACES_H_
 
+#include <cmath>
+
 #include "veins/base/utils/MiXiMDefs.h"
 #include "veins/base/phyLayer/MappingBase.h"
 
 class FilledUpMapping;
+template<class Operator> class ElementWiseMapping;
 
 /**
  * @brief This iterator takes another ConstMappingIterator and does
@@ -97,11 +100,11 @@ public:
  * @author Karl Wessel
  * @ingroup mapping
  */
-template<template <typename> class Interpolator>
+template<template <typename> class Interpolator, class Storage = MapStorage>
 class TimeMappingIterator:public MappingIterator {
 protected:
-	/** @brief The templated InterpolateableMap the underlying Mapping uses std::map as storage type.*/
-	typedef InterpolateableMap< Interpolator< std::map<simtime_t, argument_value_t> > >
+	/** @brief The templated InterpolateableMap the underlying Mapping uses, with Storage (std::map by default) as storage type.*/
+	typedef InterpolateableMap< Interpolator< typename Storage::template container<simtime_t, argument_value_t>::type > >
 	                                                             interpolator_map_type;
 	typedef typename interpolator_map_type::interpolator_type    interpolator_type;
 	typedef typename interpolator_map_type::mapped_type          mapped_type;
@@ -285,11 +288,11 @@ public:
  * @author Karl Wessel
  * @ingroup mapping
  */
-template<template <typename> class Interpolator>
+template<template <typename> class Interpolator, class Storage = MapStorage>
 class TimeMapping:public Mapping {
 protected:
-	/** @brief The templated InterpolateableMap the underlying Mapping uses std::map as storage type.*/
-	typedef InterpolateableMap< Interpolator< std::map<simtime_t, argument_value_t> > >
+	/** @brief The templated InterpolateableMap the underlying Mapping uses, with Storage (std::map by default) as storage type.*/
+	typedef InterpolateableMap< Interpolator< typename Storage::template container<simtime_t, argument_value_t>::type > >
 	                                                             interpolator_map_type;
 	typedef typename interpolator_map_type::interpolator_type    interpolator_type;
 	typedef typename interpolator_map_type::mapped_type          mapped_type;
@@ -316,7 +319,7 @@ public:
 	/**
 	 * @brief returns a deep copy of this mapping instance.
 	 */
-	virtual Mapping* clone() const { return new TimeMapping<Interpolator>(*this); }
+	virtual Mapping* clone() const { return new TimeMapping<Interpolator, Storage>(*this); }
 
 	/**
 	 * @brief Returns the value of this Function at the position specified
@@ -346,7 +349,7 @@ public:
 	 * pointer if it isn't used anymore.
 	 */
 	virtual MappingIterator* createIterator() {
-		return new TimeMappingIterator<Interpolator>(entries.beginIntpl());
+		return new TimeMappingIterator<Interpolator, Storage>(entries.beginIntpl());
 	}
 
 	/**
@@ -357,7 +360,7 @@ public:
 	 * pointer if it isn't used anymore.
 	 */
 	virtual MappingIterator* createIterator(const Argument& pos) {
-		return new TimeMappingIterator<Interpolator>(entries.findIntpl(pos.getTime()));
+		return new TimeMappingIterator<Interpolator, Storage>(entries.findIntpl(pos.getTime()));
 	}
 };
 
@@ -667,38 +670,38 @@ public:
 };
 
 /**
- * @brief Specialization of the Linear-template which provides LinearInterpolation
- * for pointer two Mappings. Used by MultiDimMapping.
+ * @brief Linear interpolation between pointers to Mappings, the base of the
+ * Linear specializations used by MultiDimMapping.
  *
  * @author Karl Wessel
  * @ingroup mappingDetails
  */
-template<>
-class Linear< std::map<Argument::mapped_type, Mapping*> > : public InterpolatorBase< std::map<Argument::mapped_type, Mapping*> >  {
+template<class _ContainerType>
+class LinearMappingInterpolator : public InterpolatorBase<_ContainerType>  {
 protected:
-	typedef InterpolatorBase< std::map<Argument::mapped_type, Mapping*> > base_class_type;
+	typedef InterpolatorBase<_ContainerType> base_class_type;
 
 public:
-	typedef base_class_type::storage_type     storage_type;
-	typedef base_class_type::container_type   container_type;
-	typedef base_class_type::key_type         key_type;
-	typedef base_class_type::key_cref_type    key_cref_type;
-	typedef base_class_type::mapped_type      mapped_type;
-	typedef base_class_type::mapped_cref_type mapped_cref_type;
-	typedef base_class_type::pair_type        pair_type;
-	typedef base_class_type::iterator         iterator;
-	typedef base_class_type::const_iterator   const_iterator;
-	typedef base_class_type::comparator_type  comparator_type;
-	typedef base_class_type::interpolated     interpolated;
+	typedef typename base_class_type::storage_type     storage_type;
+	typedef typename base_class_type::container_type   container_type;
+	typedef typename base_class_type::key_type         key_type;
+	typedef typename base_class_type::key_cref_type    key_cref_type;
+	typedef typename base_class_type::mapped_type      mapped_type;
+	typedef typename base_class_type::mapped_cref_type mapped_cref_type;
+	typedef typename base_class_type::pair_type        pair_type;
+	typedef typename base_class_type::iterator         iterator;
+	typedef typename base_class_type::const_iterator   const_iterator;
+	typedef typename base_class_type::comparator_type  comparator_type;
+	typedef typename base_class_type::interpolated     interpolated;
 
 public:
-	Linear():
+	LinearMappingInterpolator():
 		base_class_type() {}
 
-	Linear(mapped_cref_type oorv):
+	LinearMappingInterpolator(mapped_cref_type oorv):
 		base_class_type(oorv) {}
 
-	virtual ~Linear() {}
+	virtual ~LinearMappingInterpolator() {}
 
 	/**
 	 * @brief Functor operator of this class which linear interpolates the value
@@ -723,17 +726,17 @@ public:
 			return base_class_type::outOfRangeVal;
 		}
 		if(upperBound == first){
-			return asInterpolated(upperBound->second, true);
+			return this->asInterpolated(upperBound->second, true);
 		}
 
 		const_iterator right = upperBound;
 		const_iterator left  = --upperBound;
 
 		if(left->first == pos)
-			return asInterpolated(left->second, false, false);
+			return this->asInterpolated(left->second, false, false);
 
 		if(right == last){
-			return asInterpolated(left->second, true);
+			return this->asInterpolated(left->second, true);
 		}
 
 		return interpolated(LinearIntplMapping(left->second, right->second, linearInterpolationFactor(pos, left->first, right->first)));
@@ -753,6 +756,36 @@ protected:
 	}
 };
 
+/**
+ * @brief Specialization of the Linear-template which provides LinearInterpolation
+ * for pointer two Mappings stored in a std::map. Used by MultiDimMapping.
+ *
+ * @ingroup mappingDetails
+ */
+template<>
+class Linear< std::map<Argument::mapped_type, Mapping*> > : public LinearMappingInterpolator< std::map<Argument::mapped_type, Mapping*> > {
+public:
+	Linear() {}
+
+	Linear(mapped_cref_type oorv):
+		LinearMappingInterpolator< std::map<Argument::mapped_type, Mapping*> >(oorv) {}
+};
+
+/**
+ * @brief Specialization of the Linear-template which provides LinearInterpolation
+ * for pointer two Mappings stored in a SortedVectorMap. Used by MultiDimMapping.
+ *
+ * @ingroup mappingDetails
+ */
+template<>
+class Linear< SortedVectorMap<Argument::mapped_type, Mapping*> > : public LinearMappingInterpolator< SortedVectorMap<Argument::mapped_type, Mapping*> > {
+public:
+	Linear() {}
+
+	Linear(mapped_cref_type oorv):
+		LinearMappingInterpolator< SortedVectorMap<Argument::mapped_type, Mapping*> >(oorv) {}
+};
+
 /**
  * @brief Represents a constant mathematical mapping (f(x) = c)
  *
@@ -882,7 +915,7 @@ public:
 	}
 };
 
-template<template <typename> class Interpolator>
+template<template <typename> class Interpolator, class Storage = MapStorage>
 class MultiDimMapping;
 
 /**
@@ -904,11 +937,11 @@ class MultiDimMapping;
  * @author Karl Wessel
  * @ingroup mapping
  */
-template<template <typename> class Interpolator>
+template<template <typename> class Interpolator, class Storage = MapStorage>
 class MultiDimMappingIterator:public MappingIterator {
 protected:
-	/** @brief The templated InterpolateableMap the underlying Mapping uses std::map as storage type.*/
-	typedef InterpolateableMap< Interpolator< std::map<argument_value_t, Mapping*> > >
+	/** @brief The templated InterpolateableMap the underlying Mapping uses, with Storage (std::map by default) as storage type.*/
+	typedef InterpolateableMap< Interpolator< typename Storage::template container<argument_value_t, Mapping*>::type > >
 	                                                             interpolator_map_type;
 
 	typedef typename interpolator_map_type::interpolated         interpolated;
@@ -916,7 +949,7 @@ protected:
 	typedef typename interpolator_map_type::const_iterator_intpl const_iterator;
 
 	/** @brief The MultiDimmapping to iterate over.*/
-	const MultiDimMapping<Interpolator>& mapping;
+	const MultiDimMapping<Interpolator, Storage>& mapping;
 
 	/** @brief Iterator storing the current position inside the underlying Mappings
 	 * sub-mapping map.*/
@@ -1023,7 +1056,7 @@ public:
 	 * @brief Initializes the Iterator for the passed MultiDimMapping and sets
 	 * its position two the first entry of the passed MultiDimMapping.
 	 */
-	MultiDimMappingIterator(MultiDimMapping<Interpolator>& mapping):
+	MultiDimMappingIterator(MultiDimMapping<Interpolator, Storage>& mapping):
 		mapping(mapping),
 		valueIt(mapping.entries.beginIntpl()),
 		subMapping(0), subIterator(0),
@@ -1046,7 +1079,7 @@ public:
 	 * @brief Intializes the Iterator for the passed MultiDimMapping and sets
 	 * its position two the passed position.
 	 */
-	MultiDimMappingIterator(MultiDimMapping<Interpolator>& mapping, const Argument& pos):
+	MultiDimMappingIterator(MultiDimMapping<Interpolator, Storage>& mapping, const Argument& pos):
 		mapping(mapping),
 		valueIt(mapping.entries.findIntpl(pos.getArgValue(mapping.myDimension))),
 		subMapping(0), subIterator(0),
@@ -1253,11 +1286,11 @@ public:
  * @author Karl Wessel
  * @ingroup mapping
  */
-template<template <typename> class Interpolator>
+template<template <typename> class Interpolator, class Storage>
 class MultiDimMapping:public Mapping {
 protected:
-	/** @brief The templated InterpolateableMap the underlying Mapping uses std::map as storage type.*/
-	typedef InterpolateableMap< Interpolator< std::map<argument_value_t, Mapping*> > >
+	/** @brief The templated InterpolateableMap the underlying Mapping uses, with Storage (std::map by default) as storage type.*/
+	typedef InterpolateableMap< Interpolator< typename Storage::template container<argument_value_t, Mapping*>::type > >
 	                                                             interpolator_map_type;
 	typedef typename interpolator_map_type::interpolator_type    interpolator_type;
 	typedef typename interpolator_map_type::mapped_type          mapped_type;
@@ -1285,7 +1318,7 @@ protected:
 
 	bool isMaster;
 
-	friend class MultiDimMappingIterator<Interpolator>;
+	friend class MultiDimMappingIterator<Interpolator, Storage>;
 
 protected:
 	/**
@@ -1326,7 +1359,7 @@ protected:
 	 * @brief Intern copy-constructor which assures that the sub-mappings are deep
 	 * copied instead of only their pointers.
 	 */
-	MultiDimMapping(const MultiDimMapping<Interpolator>& o,
+	MultiDimMapping(const MultiDimMapping<Interpolator, Storage>& o,
 					ConstantSimpleConstMapping* oorm,
 					ConstMappingWrapper* wrappedoorm):
 		Mapping(o),
@@ -1346,35 +1379,35 @@ protected:
 	 * MultiDimMapping instance.
 	 */
 	mapped_type createSubSignal() const{
-		const Dimension& nextDim = *(--dimensions.find(myDimension));
+		const Dimension& nextDim = *(dimensions.find(myDimension) - 1);
 		if(wrappedOORMapping == 0) {
 			if(nextDim == Dimension::time())
-				return new TimeMapping<Interpolator>();
+				return new TimeMapping<Interpolator, Storage>();
 			else
-				return new MultiDimMapping<Interpolator>(dimensions, nextDim);
+				return new MultiDimMapping<Interpolator, Storage>(dimensions, nextDim);
 		} else {
 			if(nextDim == Dimension::time())
-				return new TimeMapping<Interpolator>(outOfRangeMapping->getValue());
+				return new TimeMapping<Interpolator, Storage>(outOfRangeMapping->getValue());
 			else
-				return new MultiDimMapping<Interpolator>(dimensions, nextDim, outOfRangeMapping, wrappedOORMapping);
+				return new MultiDimMapping<Interpolator, Storage>(dimensions, nextDim, outOfRangeMapping, wrappedOORMapping);
 		}
 	}
 
 	void copySubMappings(const MultiDimMapping& o){
 		const typename interpolator_map_type::iterator itEnd   = entries.end();
-		Dimension                                      nextDim = *(--dimensions.find(myDimension));
+		Dimension                                      nextDim = *(dimensions.find(myDimension) - 1);
 
 		if(nextDim == Dimension::time()) {
 			for(typename interpolator_map_type::iterator it = entries.begin(); it != itEnd; ++it) {
-				it->second = new TimeMapping<Interpolator>(*(static_cast<TimeMapping<Interpolator>*>(it->second)));
+				it->second = new TimeMapping<Interpolator, Storage>(*(static_cast<TimeMapping<Interpolator, Storage>*>(it->second)));
 			}
 		}
 		else {
 			for(typename interpolator_map_type::iterator it = entries.begin(); it != itEnd; ++it) {
 				if(outOfRangeMapping == 0) {
-					it->second = new MultiDimMapping<Interpolator>(*(static_cast<MultiDimMapping<Interpolator>*>(it->second)));
+					it->second = new MultiDimMapping<Interpolator, Storage>(*(static_cast<MultiDimMapping<Interpolator, Storage>*>(it->second)));
 				} else {
-					it->second = new MultiDimMapping<Interpolator>(*(static_cast<MultiDimMapping<Interpolator>*>(it->second)), outOfRangeMapping, wrappedOORMapping);
+					it->second = new MultiDimMapping<Interpolator, Storage>(*(static_cast<MultiDimMapping<Interpolator, Storage>*>(it->second)), outOfRangeMapping, wrappedOORMapping);
 				}
 			}
 		}
@@ -1415,7 +1448,7 @@ public:
 	 * @brief Copy-constructor which assures that the sub-mappings are deep
 	 * copied instead of only their the pointers.
 	 */
-	MultiDimMapping(const MultiDimMapping<Interpolator>& o):
+	MultiDimMapping(const MultiDimMapping<Interpolator, Storage>& o):
 		Mapping(o),
 		outOfRangeMapping(o.outOfRangeMapping),
 		wrappedOORMapping(o.wrappedOORMapping),
@@ -1435,7 +1468,7 @@ public:
 	 * @brief Copy operator which assures that the sub-mappings are deep
 	 * copied instead of only their the pointers.
 	 */
-	const MultiDimMapping& operator=(const MultiDimMapping<Interpolator>& o){
+	const MultiDimMapping& operator=(const MultiDimMapping<Interpolator, Storage>& o){
 		const typename interpolator_map_type::const_iterator itEnd = entries.end();
 		for(typename interpolator_map_type::const_iterator it = entries.begin(); it != itEnd; ++it) {
 			if(it->second)
@@ -1463,7 +1496,7 @@ public:
 	/**
 	 * @brief returns a deep copy of this mapping instance.
 	 */
-	virtual Mapping* clone() const { return new MultiDimMapping<Interpolator>(*this); }
+	virtual Mapping* clone() const { return new MultiDimMapping<Interpolator, Storage>(*this); }
 
 	/**
 	 * @brief Frees the memory for the sub mappings.
@@ -1526,7 +1559,7 @@ public:
 	 * anymore.
 	 */
 	virtual MappingIterator* createIterator() {
-		return new MultiDimMappingIterator<Interpolator>(*this);
+		return new MultiDimMappingIterator<Interpolator, Storage>(*this);
 	}
 
 	/**
@@ -1537,7 +1570,7 @@ public:
 	 * anymore.
 	 */
 	virtual MappingIterator* createIterator(const Argument& pos) {
-		return new MultiDimMappingIterator<Interpolator>(*this, pos);
+		return new MultiDimMappingIterator<Interpolator, Storage>(*this, pos);
 	}
 
 
@@ -1614,7 +1647,7 @@ protected:
 	}
 
 	Mapping* createSubSignal() const{
-		const Dimension& nextDim = *(--dimensions.find(myDimension));
+		const Dimension& nextDim = *(dimensions.find(myDimension) - 1);
 		if(nextDim == Dimension::time())
 			return MultiDimMapping<Linear>::createSubSignal();
 		else
@@ -1696,10 +1729,16 @@ public:
 	}
 
 private:
+	template<class Operator> friend class ElementWiseMapping;
+
 	static const ConstMapping *const createCompatibleMapping(const ConstMapping& src, const ConstMapping& dst);
 
 	static bool iterateToNext(ConstMappingIterator* it1, ConstMappingIterator* it2);
 
+	template<class Operator>
+	static Argument::mapped_type findExtremum(const ElementWiseMapping<Operator>& m, const Argument& min, const Argument& max,
+	                                          Argument::mapped_type_cref cRetNotFound, bool bFindMax);
+
 public:
 
 	/**
@@ -1866,6 +1905,52 @@ public:
 	 */
 	static Argument::mapped_type findMin(const ConstMapping& m, const Argument& min, const Argument& max, Argument::mapped_type_cref cRetNotFound = cMinNotFound());
 
+	/**
+	 * @brief Returns the value at the key entry with the highest value of the
+	 * element-wise combination of two mappings in the range defined by the
+	 * passed min and max parameter, without creating the combined mapping.
+	 *
+	 * The result is the same as of findMax() on the mapping
+	 * ElementWiseMapping::createMapping() would return.
+	 */
+	template<class Operator>
+	static Argument::mapped_type findMax(const ElementWiseMapping<Operator>& m, const Argument& min, const Argument& max, Argument::mapped_type_cref cRetNotFound = cMaxNotFound()) {
+		return findExtremum(m, min, max, cRetNotFound, true);
+	}
+
+	/**
+	 * @brief Returns the value at the key entry with the smallest value of the
+	 * element-wise combination of two mappings in the range defined by the
+	 * passed min and max parameter, without creating the combined mapping.
+	 *
+	 * The result is the same as of findMin() on the mapping
+	 * ElementWiseMapping::createMapping() would return.
+	 */
+	template<class Operator>
+	static Argument::mapped_type findMin(const ElementWiseMapping<Operator>& m, const Argument& min, const Argument& max, Argument::mapped_type_cref cRetNotFound = cMinNotFound()) {
+		return findExtremum(m, min, max, cRetNotFound, false);
+	}
+
+	/**
+	 * @brief Returns true if the passed mapping is above the threshold at time
+	 * from, at every key entry between from and to and at time to.
+	 *
+	 * Stops at the first value not above the threshold.
+	 */
+	static bool isAbove(const ConstMapping& m, simtime_t_cref from, simtime_t_cref to, Argument::mapped_type_cref threshold);
+
+	/**
+	 * @brief Returns true if the element-wise combination of two mappings in
+	 * the time domain is above the threshold at time from, at every key entry
+	 * between from and to and at time to, without creating the combined mapping.
+	 *
+	 * Stops at the first value not above the threshold. The result is the same
+	 * as of isAbove() on the mapping ElementWiseMapping::createMapping() would
+	 * return.
+	 */
+	template<class Operator>
+	static bool isAbove(const ElementWiseMapping<Operator>& m, simtime_t_cref from, simtime_t_cref to, Argument::mapped_type_cref threshold);
+
 
 	/*
 	static Mapping* multiply(ConstMapping& f1, ConstMapping& f2, const Argument& from, const Argument& to);
@@ -2063,6 +2148,436 @@ public:
 	}
 };
 
+/**
+ * @brief Iterates over the element-wise combination of two mappings by
+ * merging the key entries of both on the fly.
+ *
+ * Visits the same positions and returns the same values at them as
+ * iterating over the mapping MappingUtils::applyElementWiseOperator()
+ * would create. At positions between key entries (e.g. after jumpTo())
+ * the values of both mappings are combined.
+ *
+ * Note: Does take ownership of the passed iterator pointers!
+ *
+ * @author Xu Le
+ * @ingroup mappingDetails
+ */
+template<class Operator>
+class ElementWiseIterator : public ConstMappingIterator {
+protected:
+	ConstMappingIterator* itF1;
+	ConstMappingIterator* itF2;
+	Operator              op;
+
+	/**
+	 * @brief Moves the iterator of the mapping which starts later to the
+	 * start of the other one, like MappingUtils::applyElementWiseOperator() does.
+	 */
+	void alignToBegin() {
+		const bool bF1InRange = itF1->inRange();
+		const bool bF2InRange = itF2->inRange();
+
+		if(!bF1InRange && !bF2InRange)
+			return;
+
+		if(bF1InRange && (!bF2InRange || itF1->getPosition() < itF2->getPosition())){
+			itF2->jumpTo(itF1->getPosition());
+		} else {
+			itF1->jumpTo(itF2->getPosition());
+		}
+	}
+
+public:
+	/**
+	 * @brief Initializes the iterator with the iterators over both operands.
+	 *
+	 * If atBegin is true, the passed iterators have to point to the beginning
+	 * of their mappings, otherwise both have to point to the same position.
+	 */
+	ElementWiseIterator(ConstMappingIterator* itF1, ConstMappingIterator* itF2, bool atBegin, Operator op = Operator()):
+		itF1(itF1), itF2(itF2), op(op)
+	{
+		if(atBegin)
+			alignToBegin();
+	}
+
+	virtual ~ElementWiseIterator() {
+		delete itF1;
+		delete itF2;
+	}
+
+	virtual const Argument& getNextPosition() const {
+		if(itF1->hasNext() && (!itF2->hasNext() || itF1->getNextPosition() < itF2->getNextPosition()))
+			return itF1->getNextPosition();
+		return itF2->getNextPosition();
+	}
+
+	virtual void jumpTo(const Argument& pos) {
+		itF1->jumpTo(pos);
+		itF2->jumpTo(pos);
+	}
+
+	virtual void jumpToBegin() {
+		itF1->jumpToBegin();
+		itF2->jumpToBegin();
+		alignToBegin();
+	}
+
+	virtual void iterateTo(const Argument& pos) {
+		itF1->iterateTo(pos);
+		itF2->iterateTo(pos);
+	}
+
+	virtual void next() {
+		if(itF1->hasNext() && (!itF2->hasNext() || itF1->getNextPosition() < itF2->getNextPosition())){
+			itF1->next();
+			itF2->iterateTo(itF1->getPosition());
+		} else {
+			itF2->next();
+			itF1->iterateTo(itF2->getPosition());
+		}
+	}
+
+	virtual bool inRange() const { return itF1->inRange() || itF2->inRange(); }
+
+	virtual bool hasNext() const { return itF1->hasNext() || itF2->hasNext(); }
+
+	virtual const Argument& getPosition() const { return itF1->getPosition(); }
+
+	virtual argument_value_t getValue() const { return op(itF1->getValue(), itF2->getValue()); }
+};
+
+/**
+ * @brief Lazy element-wise combination (e.g. the quotient) of two mappings.
+ *
+ * Other than MappingUtils::applyElementWiseOperator() this does not create
+ * a new mapping: the key entries of both operands are merged on the fly
+ * while iterating (see ElementWiseIterator) and getValue() combines the
+ * values of both operands. MappingUtils::findMin() and
+ * MappingUtils::findMax() over a range consume it directly and return
+ * exactly what they would for the mapping createMapping() returns.
+ *
+ * The operands have to outlive this mapping. As with
+ * MappingUtils::applyElementWiseOperator(), the domain is the one of the
+ * first operand and the domain of the second one has to be a subset of it.
+ *
+ * @author Xu Le
+ * @ingroup mappingDetails
+ */
+template<class Operator>
+class ElementWiseMapping : public ConstMapping {
+protected:
+	const ConstMapping*   f1;
+	const ConstMapping*   f2;
+	/** @brief The operands filled up to the same domain, owned if they differ from f1 and f2.*/
+	const ConstMapping*   f1Comp;
+	const ConstMapping*   f2Comp;
+
+	bool                  continueOutOfRange;
+	Argument::mapped_type oorValue;
+
+	Operator op;
+
+	void createCompatibleMappings() {
+		f2Comp = MappingUtils::createCompatibleMapping(*f2, *f1);
+		f1Comp = MappingUtils::createCompatibleMapping(*f1, *f2);
+		dimensions = f1Comp->getDimensionSet();
+	}
+
+private:
+	/** @brief Not assignable.*/
+	ElementWiseMapping& operator=(const ElementWiseMapping&);
+
+public:
+	/**
+	 * @brief Initializes the combination of the passed mappings.
+	 *
+	 * The out of range parameters are the ones the mapping returned by
+	 * createMapping() is created with, e.g. MappingUtils::divide(f1, f2, oorValue)
+	 * corresponds to continueOutOfRange being false.
+	 */
+	ElementWiseMapping(const ConstMapping& f1, const ConstMapping& f2,
+	                   bool continueOutOfRange = true,
+	                   Argument::mapped_type_cref oorValue = Argument::mapped_type(0),
+	                   Operator op = Operator()):
+		ConstMapping(f1.getDimensionSet()),
+		f1(&f1), f2(&f2),
+		continueOutOfRange(continueOutOfRange),
+		oorValue(oorValue),
+		op(op)
+	{
+		createCompatibleMappings();
+	}
+
+	ElementWiseMapping(const ElementWiseMapping& o):
+		ConstMapping(o.dimensions),
+		f1(o.f1), f2(o.f2),
+		continueOutOfRange(o.continueOutOfRange),
+		oorValue(o.oorValue),
+		op(o.op)
+	{
+		createCompatibleMappings();
+	}
+
+	virtual ~ElementWiseMapping() {
+		if(f2Comp != f2)
+			delete f2Comp;
+		if(f1Comp != f1)
+			delete f1Comp;
+	}
+
+	virtual Argument::mapped_type getValue(const Argument& pos) const {
+		return op(f1Comp->getValue(pos), f2Comp->getValue(pos));
+	}
+
+	virtual ConstMappingIterator* createConstIterator() const {
+		return new ElementWiseIterator<Operator>(f1Comp->createConstIterator(), f2Comp->createConstIterator(), true, op);
+	}
+
+	virtual ConstMappingIterator* createConstIterator(const Argument& pos) const {
+		return new ElementWiseIterator<Operator>(f1Comp->createConstIterator(pos), f2Comp->createConstIterator(pos), false, op);
+	}
+
+	virtual ConstMapping* constClone() const {
+		return new ElementWiseMapping(*this);
+	}
+
+	/**
+	 * @brief Returns the combination as a new mapping, as
+	 * MappingUtils::applyElementWiseOperator() does.
+	 */
+	Mapping* createMapping() const {
+		return MappingUtils::applyElementWiseOperator(*f1, *f2, op, oorValue, continueOutOfRange);
+	}
+
+	/** @brief Returns true if the mapping createMapping() returns continues its border values out of range.*/
+	bool getContinueOutOfRange() const {
+		return continueOutOfRange;
+	}
+
+	/** @brief Returns the out of range value of the mapping createMapping() returns if it does not continue.*/
+	Argument::mapped_type getOutOfRangeValue() const {
+		return oorValue;
+	}
+};
+
+typedef ElementWiseMapping< std::multiplies<Argument::mapped_type> > ProductMapping;
+typedef ElementWiseMapping< std::divides<Argument::mapped_type> >    QuotientMapping;
+typedef ElementWiseMapping< std::plus<Argument::mapped_type> >       SumMapping;
+typedef ElementWiseMapping< std::minus<Argument::mapped_type> >      DifferenceMapping;
+
+/**
+ * @brief Tracks the key entries around a position in one row (the entries with
+ * the same non-time values) of a mapping, to interpolate the value there
+ * like a TimeMapping<Linear> would.
+ *
+ * @ingroup mappingDetails
+ */
+class MIXIM_API RowInterpolation : protected Linear< std::map<simtime_t, Argument::mapped_type> > {
+protected:
+	simtime_t             time;
+	bool                  bHasPrev;
+	bool                  bHasNext;
+	simtime_t             prevTime;
+	simtime_t             nextTime;
+	Argument::mapped_type prevValue;
+	Argument::mapped_type nextValue;
+
+public:
+	RowInterpolation(simtime_t_cref time):
+		time(time), bHasPrev(false), bHasNext(false), prevValue(0), nextValue(0) {}
+
+	/** @brief Passes the next key entry of the row, in order of time.*/
+	void addEntry(simtime_t_cref t, Argument::mapped_type_cref value) {
+		if(t <= time) {
+			bHasPrev  = true;
+			prevTime  = t;
+			prevValue = value;
+		} else if(!bHasNext) {
+			bHasNext  = true;
+			nextTime  = t;
+			nextValue = value;
+		}
+	}
+
+	/** @brief Returns true if the position lies between the first and the last entry of the row.*/
+	bool inRange() const {
+		return bHasPrev && (prevTime == time || bHasNext);
+	}
+
+	/** @brief Returns the interpolated value at the position, only valid if inRange().*/
+	Argument::mapped_type getValue() const {
+		if(prevTime == time)
+			return prevValue;
+		return linearInterpolation(time, prevTime, nextTime, prevValue, nextValue);
+	}
+
+	/**
+	 * @brief Returns the value at the position like a TimeMapping<Linear> with
+	 * the passed out of range handling would.
+	 */
+	Argument::mapped_type getValue(bool continueOutOfRange, Argument::mapped_type_cref oorValue) const {
+		if(inRange())
+			return getValue();
+		if(!continueOutOfRange)
+			return oorValue;
+		if(bHasPrev)
+			return prevValue;
+		if(bHasNext)
+			return nextValue;
+		return Argument::MappedZero();
+	}
+};
+
+template<class Operator>
+Argument::mapped_type MappingUtils::findExtremum(const ElementWiseMapping<Operator>& m, const Argument& pRangeFrom, const Argument& pRangeTo,
+                                                 Argument::mapped_type_cref cRetNotFound, bool bFindMax) {
+	const DimensionSet& rDimSet = m.getDimensionSet();
+
+	// The combined mapping would be linear interpolated, in time inside each
+	// row and between rows. Only the former is done here, if the range starts
+	// or ends between rows (or there are more) the combined mapping is needed.
+	if(rDimSet.size() > 2) {
+		Mapping* combined = m.createMapping();
+		Argument::mapped_type res = bFindMax ? findMax(*combined, pRangeFrom, pRangeTo, cRetNotFound) : findMin(*combined, pRangeFrom, pRangeTo, cRetNotFound);
+		delete combined;
+		return res;
+	}
+	const bool            bHasRows = rDimSet.size() == 2;
+	const Dimension&      rowDim   = *rDimSet.rbegin();
+	Argument::mapped_type fromRow  = bHasRows ? pRangeFrom.getArgValue(rowDim) : Argument::MappedZero();
+	Argument::mapped_type toRow    = bHasRows ? pRangeTo.getArgValue(rowDim) : Argument::MappedZero();
+	bool                  bFromRowFound = !bHasRows;
+	bool                  bToRowFound   = !bHasRows;
+	RowInterpolation      atFrom(pRangeFrom.getTime());
+	RowInterpolation      atTo(pRangeTo.getTime());
+
+	// findMin() and findMax() keep the first value if it is NaN and ignore NaN afterwards
+	bool                  bHasFirst = false;
+	Argument::mapped_type first     = 0;
+	bool                  bHasBest  = false;
+	Argument::mapped_type best      = 0;
+
+	ConstMappingIterator* it = m.createConstIterator();
+	while(it->inRange()) {
+		const Argument&       pos   = it->getPosition();
+		Argument::mapped_type val   = it->getValue();
+		Argument::mapped_type row   = bHasRows ? pos.getArgValue(rowDim) : Argument::MappedZero();
+		simtime_t_cref        t     = pos.getTime();
+
+		if(row == fromRow) {
+			bFromRowFound = true;
+			atFrom.addEntry(t, val);
+		}
+		if(row == toRow) {
+			bToRowFound = true;
+			atTo.addEntry(t, val);
+		}
+
+		const bool bAfterFrom = fromRow < row || (row == fromRow && pRangeFrom.getTime() < t);
+		const bool bAfterTo   = toRow < row || (row == toRow && pRangeTo.getTime() < t);
+
+		// key entries findMin() and findMax() iterate over after the start of the range
+		if(bAfterFrom && pos.compare(pRangeTo, &rDimSet) < 0) {
+			bool inRange = pRangeFrom.getTime() <= t && t <= pRangeTo.getTime();
+			if(inRange) {
+				const Argument::const_iterator itAEnd = pos.end();
+				for(Argument::const_iterator itA = pos.begin(); itA != itAEnd; ++itA) {
+					if(pRangeFrom.getArgValue(itA->first) > itA->second || itA->second > pRangeTo.getArgValue(itA->first)) {
+						inRange = false;
+						break;
+					}
+				}
+			}
+			if(inRange) {
+				if(!bHasFirst) {
+					first     = val;
+					bHasFirst = true;
+				}
+				if(!std::isnan(val) && (!bHasBest || (bFindMax ? val > best : val < best))) {
+					best     = val;
+					bHasBest = true;
+				}
+			}
+		}
+
+		// the entries around both ends of the range are known
+		if(bAfterFrom && bAfterTo)
+			break;
+		if(!it->hasNext())
+			break;
+		it->next();
+	}
+	delete it;
+
+	if(!bFromRowFound || !bToRowFound) {
+		Mapping* combined = m.createMapping();
+		Argument::mapped_type res = bFindMax ? findMax(*combined, pRangeFrom, pRangeTo, cRetNotFound) : findMin(*combined, pRangeFrom, pRangeTo, cRetNotFound);
+		delete combined;
+		return res;
+	}
+
+	// combine in the order findMin() and findMax() visit: start of range, entries, end of range
+	Argument::mapped_type res;
+	if(atFrom.inRange()) {
+		res = atFrom.getValue();
+	} else if(bHasFirst) {
+		res = first;
+	} else if(atTo.inRange()) {
+		return atTo.getValue();
+	} else {
+		return cRetNotFound;
+	}
+	if(std::isnan(res))
+		return res;
+	if(bHasBest && (bFindMax ? best > res : best < res))
+		res = best;
+	if(atTo.inRange()) {
+		Argument::mapped_type val = atTo.getValue();
+		if(bFindMax ? val > res : val < res)
+			res = val;
+	}
+	return res;
+}
+
+template<class Operator>
+bool MappingUtils::isAbove(const ElementWiseMapping<Operator>& m, simtime_t_cref from, simtime_t_cref to, Argument::mapped_type_cref threshold) {
+	if(!(m.getDimensionSet() == DimensionSet::timeDomain())) {
+		Mapping* combined = m.createMapping();
+		bool res = isAbove(*combined, from, to, threshold);
+		delete combined;
+		return res;
+	}
+
+	RowInterpolation atFrom(from);
+	RowInterpolation atTo(to);
+
+	ConstMappingIterator* it = m.createConstIterator();
+	while(it->inRange()) {
+		simtime_t_cref        t   = it->getPosition().getTime();
+		Argument::mapped_type val = it->getValue();
+
+		atFrom.addEntry(t, val);
+		atTo.addEntry(t, val);
+
+		if(from < t && t < to && val <= threshold) {
+			delete it;
+			return false;
+		}
+
+		// the entries around both ends are known
+		if(to < t)
+			break;
+		if(!it->hasNext())
+			break;
+		it->next();
+	}
+	delete it;
+
+	return !(atFrom.getValue(m.getContinueOutOfRange(), m.getOutOfRangeValue()) <= threshold)
+	       && !(atTo.getValue(m.getContinueOutOfRange(), m.getOutOfRangeValue()) <= threshold);
+}
+
 /**
  * @brief Common base for a Const- and NonConst-Iterator for a DelayedMapping.
  *
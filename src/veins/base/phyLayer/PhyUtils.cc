@@ -33,9 +33,7 @@ void RadioStateAnalogueModel::cleanUpUntil(simtime_t_cref t)
 	// ==> clear complete list except the last element, return
 	if ( t > radioStateAttenuation.back().getTime() )
 	{
-		ListEntry lastEntry = radioStateAttenuation.back();
-		radioStateAttenuation.clear();
-		radioStateAttenuation.push_back(lastEntry);
+		radioStateAttenuation.eraseBefore(radioStateAttenuation.end() - 1);
 		return;
 	}
 
@@ -46,24 +44,23 @@ void RadioStateAnalogueModel::cleanUpUntil(simtime_t_cref t)
 	 * 3. t <= last_timepoint
 	 */
 
-	// get an iterator and set it to the first timepoint >= t
-	std::list<ListEntry>::iterator it;
-	it = lower_bound(radioStateAttenuation.begin(), radioStateAttenuation.end(), t);
+	// get the position of the first timepoint >= t
+	ListEntryRing::position_type it = radioStateAttenuation.lowerBound(t);
 
 
 	// CASE: list contains an element with exactly the given key
-	if ( it->getTime() == t )
+	if ( radioStateAttenuation[it].getTime() == t )
 	{
-		radioStateAttenuation.erase(radioStateAttenuation.begin(), it);
+		radioStateAttenuation.eraseBefore(it);
 		return;
 	}
 
 	// CASE: t is "in between two elements"
-	// ==> set the iterators predecessors time to t, it becomes the first element
+	// ==> set the predecessors time to t, it becomes the first element
 	it--; // go back one element, possible since this one has not been the first one
 
-	it->setTime(t); // set this elements time to t
-	radioStateAttenuation.erase(radioStateAttenuation.begin(), it); // and erase all previous elements
+	radioStateAttenuation[it].setTime(t); // set this elements time to t
+	radioStateAttenuation.eraseBefore(it); // and erase all previous elements
 
 }
 
@@ -209,6 +206,7 @@ RSAMConstMappingIterator::RSAMConstMappingIterator
 							 simtime_t_cref signalStart,
 							 simtime_t_cref signalEnd) :
 	rsam(rsam),
+	it(rsam->radioStateAttenuation.begin()),
 	signalStart(signalStart),
 	signalEnd(signalEnd)
 {
@@ -232,7 +230,7 @@ void RSAMConstMappingIterator::jumpTo(const Argument& pos)
 		return;
 
 	// this automatically goes over all zero time switches
-	it = upper_bound(rsam->radioStateAttenuation.begin(), rsam->radioStateAttenuation.end(), t);
+	it = rsam->radioStateAttenuation.upperBound(t);
 
 	--it;
 	position.setTime(t);
@@ -248,16 +246,16 @@ void RSAMConstMappingIterator::setNextPosition()
 			nextPosition.setTime(signalStart);
 		} else
 		{
-			CurrList::const_iterator it2 = it;
-			it2++;
+			const RadioStateAnalogueModel::ListEntry& current = rsam->radioStateAttenuation[it];
+			const RadioStateAnalogueModel::ListEntry& following = rsam->radioStateAttenuation[it + 1];
 
-			assert(it->getTime() <= position.getTime() && position.getTime() < it2->getTime());
+			assert(current.getTime() <= position.getTime() && position.getTime() < following.getTime());
 
 			//point in time for the "pre step" of the next real key entry
-			simtime_t_cref preTime = MappingUtils::pre(it2->getTime());
+			simtime_t_cref preTime = MappingUtils::pre(following.getTime());
 
 			if(position.getTime() == preTime) {
-				nextPosition.setTime(it2->getTime());
+				nextPosition.setTime(following.getTime());
 			}
 			else {
 				nextPosition.setTime(preTime);
@@ -301,7 +299,7 @@ void RSAMConstMappingIterator::iterateTo(const Argument& pos)
 bool RSAMConstMappingIterator::inRange() const
 {
 	simtime_t_cref t             = position.getTime();
-	simtime_t_cref lastEntryTime = std::max(rsam->radioStateAttenuation.back().getTime(), signalStart);
+	simtime_t      lastEntryTime = std::max(rsam->radioStateAttenuation.back().getTime(), signalStart);
 
 	return 	signalStart <= t
 			&& t <= signalEnd
@@ -313,22 +311,24 @@ bool RSAMConstMappingIterator::hasNext() const
 {
 	assert( !(rsam->radioStateAttenuation.empty()) );
 
-	CurrList::const_iterator it2 = it;
+	CurrList::position_type it2 = it;
 	if (it2 != rsam->radioStateAttenuation.end())
 	{
 		it2++;
 	}
 
 	return 	position.getTime() < signalStart
-			|| (it2 != rsam->radioStateAttenuation.end() && it2->getTime() <= signalEnd);
+			|| (it2 != rsam->radioStateAttenuation.end() && rsam->radioStateAttenuation[it2].getTime() <= signalEnd);
 }
 
 void RSAMConstMappingIterator::iterateToOverZeroSwitches(simtime_t_cref t)
 {
-	if( it != rsam->radioStateAttenuation.end() && !(t < it->getTime()) )
+	const CurrList& entries = rsam->radioStateAttenuation;
+
+	if( it != entries.end() && !(t < entries[it].getTime()) )
 	{
 		// and go over (ignore) all zero-time-switches, to the next greater entry (time)
-		while( it != rsam->radioStateAttenuation.end() && !(t < it->getTime()) )
+		while( it != entries.end() && !(t < entries[it].getTime()) )
 			it++;
 
 		// go back one step, here the iterator 'it' is placed right
@@ -348,14 +348,13 @@ RSAMMapping::argument_value_t RSAMMapping::getValue(const Argument& pos) const
 
 	/* receiving list contains at least one entry */
 
-	// set an iterator to the first entry with timepoint > t
-	std::list<RadioStateAnalogueModel::ListEntry>::const_iterator it;
-	it = upper_bound(rsam->radioStateAttenuation.begin(), rsam->radioStateAttenuation.end(), t);
+	// get the position of the first entry with timepoint > t
+	RadioStateAnalogueModel::ListEntryRing::position_type it = rsam->radioStateAttenuation.upperBound(t);
 
 	// REGULAR CASE: it points to an element that has a predecessor
 	it--; // go back one entry, this one is significant!
 
-	return it->getValue();
+	return rsam->radioStateAttenuation[it].getValue();
 }
 
 ConstMappingIterator* RSAMMapping::createConstIterator(const Argument& pos) const
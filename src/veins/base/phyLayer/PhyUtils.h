@@ -1,8 +1,9 @@
 #ifndef PHYUTILS_H_
 #define PHYUTILS_H_
 
+#include <algorithm>
 #include <cassert>
-#include <list>
+#include <vector>
 #include <omnetpp.h>
 
 #include "veins/base/utils/MiXiMDefs.h"
@@ -110,13 +111,98 @@ protected:
 	};
 
 
+	/**
+	 * @brief Time ordered ring buffer of ListEntries.
+	 *
+	 * Entries are appended at the back and dropped from the front, so they are kept
+	 * contiguously in a power of two sized vector which only grows if more entries
+	 * are alive at once than ever before. Entries are addressed by a position that
+	 * counts all entries ever appended, therefore positions stay valid when entries
+	 * are appended or the buffer grows (like list iterators did) and are only
+	 * invalidated by dropping the entry itself.
+	 */
+	class ListEntryRing
+	{
+	public:
+		/** @brief Position of an entry, end() is one past the last entry.*/
+		typedef size_t position_type;
+
+	protected:
+		/** @brief The entries, entry at position p is stored at index p & (size - 1).*/
+		std::vector<ListEntry> entries;
+		/** @brief Position of the first entry.*/
+		position_type first;
+		/** @brief Position one past the last entry.*/
+		position_type last;
+
+	public:
+		ListEntryRing():
+			entries(8, ListEntry(SIMTIME_ZERO, 0)),
+			first(0),
+			last(0)
+		{}
+
+		position_type begin() const { return first; }
+		position_type end() const { return last; }
+		bool empty() const { return first == last; }
+		size_t size() const { return last - first; }
+
+		ListEntry& operator[](position_type pos) { return entries[pos & (entries.size() - 1)]; }
+		const ListEntry& operator[](position_type pos) const { return entries[pos & (entries.size() - 1)]; }
+
+		ListEntry& front() { return (*this)[first]; }
+		const ListEntry& front() const { return (*this)[first]; }
+		ListEntry& back() { return (*this)[last - 1]; }
+		const ListEntry& back() const { return (*this)[last - 1]; }
+
+		/** @brief Appends an entry, doubling the capacity if the buffer is full.*/
+		void push_back(const ListEntry& entry) {
+			if (size() == entries.size()) {
+				std::vector<ListEntry> grown(2 * entries.size(), entry);
+				for (position_type pos = first; pos != last; ++pos) {
+					grown[pos & (grown.size() - 1)] = (*this)[pos];
+				}
+				entries.swap(grown);
+			}
+			(*this)[last++] = entry;
+		}
+
+		/** @brief Drops all entries before pos.*/
+		void eraseBefore(position_type pos) {
+			assert(first <= pos && pos <= last);
+			first = pos;
+		}
+
+		/** @brief Returns the position of the first entry with a time not smaller than t.*/
+		position_type lowerBound(simtime_t_cref t) const {
+			position_type low = first, high = last;
+			while (low < high) {
+				position_type mid = low + (high - low) / 2;
+				if ((*this)[mid] < t) low = mid + 1;
+				else high = mid;
+			}
+			return low;
+		}
+
+		/** @brief Returns the position of the first entry with a time greater than t.*/
+		position_type upperBound(simtime_t_cref t) const {
+			position_type low = first, high = last;
+			while (low < high) {
+				position_type mid = low + (high - low) / 2;
+				if (t < (*this)[mid]) high = mid;
+				else low = mid + 1;
+			}
+			return low;
+		}
+	};
+
 	/**
 	 * @brief Indicator variable whether we are currently tracking changes
 	 */
 	bool currentlyTracking;
 
 	/**  @brief Data structure to track the Radios attenuation over time.*/
-	std::list<ListEntry> radioStateAttenuation;
+	ListEntryRing radioStateAttenuation;
 
 public:
 
@@ -435,9 +521,9 @@ protected:
 	const RadioStateAnalogueModel* rsam;
 
 	/** @brief Type for the list of attenuation entries.*/
-	typedef std::list<RadioStateAnalogueModel::ListEntry> CurrList;
-	/** @brief List iterator pointing to the current position.*/
-	CurrList::const_iterator it;
+	typedef RadioStateAnalogueModel::ListEntryRing CurrList;
+	/** @brief Position of the entry valid at the current position.*/
+	CurrList::position_type it;
 
 	/** @brief The current position of this iterator.*/
 	Argument position;
@@ -535,7 +621,7 @@ public:
 	 * position.
 	 */
 	virtual argument_value_t getValue() const {
-		return it->getValue();
+		return rsam->radioStateAttenuation[it].getValue();
 	}
 
 
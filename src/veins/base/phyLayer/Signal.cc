@@ -7,7 +7,7 @@ Signal::Signal(simtime_t_cref sendingStart, simtime_t_cref duration):
 	sendingStart(sendingStart), duration(duration),
 	propagationDelay(0),
 	power(0), bitrate(0),
-	txBitrate(0),
+	txBitrate(0), sharedBitrate(false),
 	rcvPower(0)
 {}
 
@@ -16,20 +16,15 @@ Signal::Signal(const Signal & o):
 	sendingStart(o.sendingStart), duration(o.duration),
 	propagationDelay(o.propagationDelay),
 	power(0), bitrate(0),
-	txBitrate(0),
-	rcvPower(0)
+	txBitrate(0), sharedBitrate(o.sharedBitrate),
+	rcvPower(0),
+	precomputed(o.precomputed)
 {
 	if (o.power) {
 		power = o.power->constClone();
 	}
 
-	if (o.bitrate) {
-		bitrate = o.bitrate->clone();
-	}
-
-	if (o.txBitrate) {
-		txBitrate = o.txBitrate->clone();
-	}
+	copyBitrate(o);
 
 	for(ConstMappingList::const_iterator it = o.attenuations.begin();
 		it != o.attenuations.end(); it++){
@@ -45,6 +40,7 @@ const Signal& Signal::operator=(const Signal& o) {
 	senderFromGateID = o.senderFromGateID;
 	receiverModuleID = o.receiverModuleID;
 	receiverToGateID = o.receiverToGateID;
+	precomputed      = o.precomputed;
 
 	markRcvPowerOutdated();
 
@@ -53,24 +49,13 @@ const Signal& Signal::operator=(const Signal& o) {
 		power = 0;
 	}
 
-	if(bitrate){
-		delete bitrate;
-		bitrate = 0;
-	}
-
-	if(txBitrate){
-		delete txBitrate;
-		txBitrate = 0;
-	}
+	deleteBitrate();
 
 	if(o.power)
 		power = o.power->constClone();
 
-	if(o.bitrate)
-		bitrate = o.bitrate->clone();
-
-	if(o.txBitrate)
-		txBitrate = o.txBitrate->clone();
+	sharedBitrate = o.sharedBitrate;
+	copyBitrate(o);
 
 	for(ConstMappingList::const_iterator it = attenuations.begin();
 		it != attenuations.end(); it++){
@@ -101,11 +86,7 @@ Signal::~Signal()
 	if(power)
 		delete power;
 
-	if(bitrate)
-		delete bitrate;
-
-	if(txBitrate)
-		delete txBitrate;
+	deleteBitrate();
 
 	for(ConstMappingList::iterator it = attenuations.begin();
 		it != attenuations.end(); it++) {
@@ -166,10 +147,52 @@ void Signal::setBitrate(Mapping *bitrate)
 {
 	assert(!txBitrate);
 
-	if(this->bitrate)
-		delete this->bitrate;
+	deleteBitrate();
 
 	this->bitrate = bitrate;
+	sharedBitrate = false;
+}
+
+void Signal::setSharedBitrate(Mapping *bitrate)
+{
+	assert(!txBitrate);
+
+	deleteBitrate();
+
+	this->bitrate = bitrate;
+	sharedBitrate = true;
+}
+
+void Signal::copyBitrate(const Signal& o)
+{
+	if(!sharedBitrate) {
+		if(o.bitrate)
+			bitrate = o.bitrate->clone();
+
+		if(o.txBitrate)
+			txBitrate = o.txBitrate->clone();
+	}
+	else if(o.txBitrate) {
+		// only the delay is copied, the bitrate itself stays shared
+		txBitrate = o.txBitrate;
+		bitrate = new DelayedMapping(txBitrate, propagationDelay);
+	}
+	else {
+		bitrate = o.bitrate;
+	}
+}
+
+void Signal::deleteBitrate()
+{
+	// a shared bitrate is only owned if wrapped for the propagation delay
+	if(bitrate && (!sharedBitrate || txBitrate))
+		delete bitrate;
+
+	if(txBitrate && !sharedBitrate)
+		delete txBitrate;
+
+	bitrate = 0;
+	txBitrate = 0;
 }
 
 cGate *Signal::getSendingGate() const
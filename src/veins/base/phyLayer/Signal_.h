@@ -2,9 +2,11 @@
 #define SIGNAL_H_
 
 #include <list>
+#include <vector>
 #include <omnetpp.h>
 
 #include "veins/base/utils/MiXiMDefs.h"
+#include "veins/base/utils/Coord.h"
 #include "veins/base/phyLayer/Mapping.h"
 
 /**
@@ -41,6 +43,20 @@ public:
 	/** @brief Shortcut type for a list of ConstMappings.*/
 	typedef std::list<ConstMapping*> ConstMappingList;
 
+	/**
+	 * @brief Results of AnalogueModel::precompute() of the receiver's
+	 * analogue models, evaluated when the signal was sent.
+	 *
+	 * Only valid if sender and receiver are still at the positions
+	 * they were evaluated for.
+	 */
+	struct Precomputed {
+		Coord sendersPos;
+		Coord receiverPos;
+		/** @brief One result per analogue model of the receiver, empty if nothing was precomputed.*/
+		std::vector<double> factors;
+	};
+
 protected:
 	/** @brief Sender module id, additional definition here because BasePhyLayer will do some selfMessages with AirFrame. */
 	int senderModuleID;
@@ -66,13 +82,25 @@ protected:
 	/** @brief If propagation delay is not zero this stores the undelayed bitrate*/
 	Mapping* txBitrate;
 
+	/** @brief True if the undelayed bitrate is shared between signals instead of owned.*/
+	bool sharedBitrate;
+
 	/** @brief Stores the functions describing the attenuations of the signal*/
 	ConstMappingList attenuations;
 
 	/** @brief Stores the mapping defining the receiving power of the signal.*/
 	MultipliedMapping* rcvPower;
 
+	/** @brief Analogue model results evaluated for this signal's receiver when it was sent.*/
+	Precomputed precomputed;
+
 protected:
+	/** @brief Copies the bitrate of the passed signal, which has to share it if this one does.*/
+	void copyBitrate(const Signal& o);
+
+	/** @brief Deletes the bitrate mappings owned by this signal.*/
+	void deleteBitrate();
+
 	/**
 	 * @brief Deletes the rcvPower mapping member because it became
 	 * out-dated.
@@ -169,6 +197,15 @@ public:
 	 */
 	void setBitrate(Mapping* bitrate);
 
+	/**
+	 * @brief Sets a function representing the bitrate of the signal
+	 * which is shared with other signals.
+	 *
+	 * The ownership of the passed pointer stays with the caller, it has to
+	 * outlive the signal and its copies, which share it instead of cloning it.
+	 */
+	void setSharedBitrate(Mapping* bitrate);
+
 	/**
 	 * @brief Adds a function representing an attenuation of the signal.
 	 *
@@ -222,6 +259,19 @@ public:
 		return attenuations;
 	}
 
+	/**
+	 * @brief Returns the analogue model results evaluated for the
+	 * receiver of this signal when it was sent.
+	 */
+	const Precomputed& getPrecomputed() const {
+		return precomputed;
+	}
+
+	/** @brief Returns the analogue model results for modification.*/
+	Precomputed& getPrecomputed() {
+		return precomputed;
+	}
+
 	/**
 	 * @brief Calculates and returns the receiving power of this Signal.
 	 * Ownership of the returned mapping belongs to this class.
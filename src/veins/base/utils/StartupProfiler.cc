@@ -0,0 +1,229 @@
+//
+// StartupProfiler - wall time and allocations of module initialization
+// Copyright (C) 2018 Xu Le <xmutongxinXuLe@163.com>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <algorithm>
+#include <atomic>
+#include <new>
+
+#include "veins/base/utils/StartupProfiler.h"
+
+Register_GlobalConfigOption(CFGID_VEINS_STARTUP_PROFILE, "veins-startup-profile", CFG_FILENAME, "", "Prefix of the startup profile files (<prefix>.txt summary table, <prefix>.json Chrome trace) recording wall time and allocations of module initialization. Empty disables profiling.");
+
+namespace {
+	std::atomic<uint64_t> allocCount(0);
+	std::atomic<uint64_t> allocBytes(0);
+
+	/** escapes a string for use in a JSON string literal */
+	std::string jsonEscape(const char* s) {
+		std::string out;
+		for (; *s; ++s) {
+			if (*s == '"' || *s == '\\') out += '\\';
+			if (static_cast<unsigned char>(*s) < 0x20) continue;
+			out += *s;
+		}
+		return out;
+	}
+
+	struct Summary {
+		Summary() : count(0), total(0), max(0), allocCount(0), allocBytes(0) {}
+		long count;
+		double total;
+		double max;
+		uint64_t allocCount;
+		uint64_t allocBytes;
+	};
+}
+
+#ifdef VEINS_STARTUP_PROFILE_ALLOCATIONS
+// replacing the global allocation functions counts every heap allocation of the process;
+// array, nothrow and sized variants all forward to these two
+void* operator new(std::size_t size) {
+	allocCount.fetch_add(1, std::memory_order_relaxed);
+	allocBytes.fetch_add(size, std::memory_order_relaxed);
+	if (void* p = std::malloc(size ? size : 1)) return p;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+#endif
+
+namespace Veins {
+
+StartupProfiler::Scope::Scope(const char* type, const char* section, int stage) :
+	type(type),
+	section(section),
+	stage(stage),
+	active(StartupProfiler::getInstance().isEnabled()),
+	allocCountAtStart(0),
+	allocBytesAtStart(0)
+{
+	if (!active) return;
+
+	StartupProfiler& profiler = StartupProfiler::getInstance();
+	allocCountAtStart = getAllocationCount();
+	allocBytesAtStart = getAllocatedBytes();
+	start = std::chrono::steady_clock::now();
+	if (!profiler.haveEpoch) {
+		profiler.epoch = start;
+		profiler.haveEpoch = true;
+	}
+}
+
+StartupProfiler::Scope::~Scope()
+{
+	if (!active) return;
+
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+	StartupProfiler& profiler = StartupProfiler::getInstance();
+
+	Record r;
+	r.allocCount = getAllocationCount() - allocCountAtStart;
+	r.allocBytes = getAllocatedBytes() - allocBytesAtStart;
+	r.type = type; // after taking the allocation counts, copying the type may allocate
+	r.section = section;
+	r.stage = stage;
+	r.start = std::chrono::duration<double>(start - profiler.epoch).count();
+	r.duration = std::chrono::duration<double>(end - start).count();
+	profiler.add(r);
+}
+
+StartupProfiler& StartupProfiler::getInstance()
+{
+	static StartupProfiler instance;
+	return instance;
+}
+
+StartupProfiler::StartupProfiler() :
+	configured(false),
+	haveEpoch(false)
+{
+}
+
+StartupProfiler::~StartupProfiler()
+{
+	// runs that never called writeReport (e.g. without a TraCIScenarioManager) are written at exit
+	if (!prefix.empty() && !records.empty()) {
+		writeSummary(prefix + ".txt");
+		writeTrace(prefix + ".json");
+	}
+}
+
+bool StartupProfiler::isEnabled()
+{
+	if (!configured) {
+		configured = true;
+		cConfiguration* config = getEnvir() ? getEnvir()->getConfig() : 0;
+		prefix = config ? config->getAsFilename(CFGID_VEINS_STARTUP_PROFILE) : "";
+	}
+	return !prefix.empty();
+}
+
+uint64_t StartupProfiler::getAllocationCount()
+{
+	return allocCount.load(std::memory_order_relaxed);
+}
+
+uint64_t StartupProfiler::getAllocatedBytes()
+{
+	return allocBytes.load(std::memory_order_relaxed);
+}
+
+void StartupProfiler::add(const Record& record)
+{
+	records.push_back(record);
+}
+
+void StartupProfiler::writeReport()
+{
+	if (isEnabled() && !records.empty()) {
+		if (!writeSummary(prefix + ".txt")) EV_WARN << "StartupProfiler could not write " << prefix << ".txt" << endl;
+		if (!writeTrace(prefix + ".json")) EV_WARN << "StartupProfiler could not write " << prefix << ".json" << endl;
+	}
+
+	records.clear();
+	haveEpoch = false;
+	configured = false;
+	prefix.clear();
+}
+
+bool StartupProfiler::writeSummary(const std::string& fileName) const
+{
+	typedef std::map<std::pair<std::pair<std::string, std::string>, int>, Summary> Summaries;
+	Summaries summaries;
+	for (std::vector<Record>::const_iterator i = records.begin(); i != records.end(); ++i) {
+		Summary& s = summaries[std::make_pair(std::make_pair(i->type, std::string(i->section)), i->stage)];
+		++s.count;
+		s.total += i->duration;
+		s.max = std::max(s.max, i->duration);
+		s.allocCount += i->allocCount;
+		s.allocBytes += i->allocBytes;
+	}
+
+	std::vector<Summaries::const_iterator> sorted;
+	for (Summaries::const_iterator i = summaries.begin(); i != summaries.end(); ++i) sorted.push_back(i);
+	std::sort(sorted.begin(), sorted.end(), [](Summaries::const_iterator a, Summaries::const_iterator b) { return a->second.total > b->second.total; });
+
+	std::ofstream out(fileName.c_str());
+	if (!out) return false;
+
+	out << "# times are inclusive of nested sections";
+#ifndef VEINS_STARTUP_PROFILE_ALLOCATIONS
+	out << "; allocation counting not compiled in (define VEINS_STARTUP_PROFILE_ALLOCATIONS)";
+#endif
+	out << "\n";
+	out << std::left << std::setw(28) << "module type" << std::setw(28) << "section" << std::right << std::setw(6) << "stage"
+		<< std::setw(9) << "calls" << std::setw(13) << "total [ms]" << std::setw(12) << "mean [ms]" << std::setw(12) << "max [ms]"
+		<< std::setw(12) << "allocs" << std::setw(14) << "alloc [kB]" << "\n";
+	out << std::fixed << std::setprecision(3);
+	for (std::vector<Summaries::const_iterator>::const_iterator i = sorted.begin(); i != sorted.end(); ++i) {
+		const Summary& s = (*i)->second;
+		out << std::left << std::setw(28) << (*i)->first.first.first << std::setw(28) << (*i)->first.first.second << std::right;
+		if ((*i)->first.second >= 0) out << std::setw(6) << (*i)->first.second;
+		else out << std::setw(6) << "-";
+		out << std::setw(9) << s.count << std::setw(13) << s.total * 1e3 << std::setw(12) << s.total * 1e3 / s.count << std::setw(12) << s.max * 1e3
+			<< std::setw(12) << s.allocCount << std::setw(14) << s.allocBytes / 1024.0 << "\n";
+	}
+	return static_cast<bool>(out);
+}
+
+bool StartupProfiler::writeTrace(const std::string& fileName) const
+{
+	std::ofstream out(fileName.c_str());
+	if (!out) return false;
+
+	out << "{\"traceEvents\":[\n";
+	out << std::fixed << std::setprecision(3);
+	for (std::vector<Record>::const_iterator i = records.begin(); i != records.end(); ++i) {
+		if (i != records.begin()) out << ",\n";
+		out << "{\"name\":\"" << jsonEscape(i->type.c_str()) << "::" << jsonEscape(i->section) << "\",\"cat\":\"" << jsonEscape(i->type.c_str())
+			<< "\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":" << i->start * 1e6 << ",\"dur\":" << i->duration * 1e6
+			<< ",\"args\":{\"stage\":" << i->stage << ",\"allocs\":" << i->allocCount << ",\"allocBytes\":" << i->allocBytes << "}}";
+	}
+	out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+	return static_cast<bool>(out);
+}
+
+}
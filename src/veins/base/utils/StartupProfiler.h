@@ -0,0 +1,114 @@
+//
+// StartupProfiler - wall time and allocations of module initialization
+// Copyright (C) 2018 Xu Le <xmutongxinXuLe@163.com>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#ifndef VEINS_BASE_UTILS_STARTUPPROFILER_H
+#define VEINS_BASE_UTILS_STARTUPPROFILER_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <stdint.h>
+
+#include "veins/base/utils/MiXiMDefs.h"
+
+namespace Veins {
+
+/**
+ * records wall time (and, if built with VEINS_STARTUP_PROFILE_ALLOCATIONS, heap allocations)
+ * spent in instrumented initialization code, grouped by module type, section and init stage.
+ *
+ * Profiling is switched on by the global configuration option
+ *
+ *   veins-startup-profile = ${resultdir}/${configname}-${runnumber}-startup
+ *
+ * which makes writeReport() produce "<prefix>.txt" (a summary table sorted by total time)
+ * and "<prefix>.json" (Chrome trace events, to be opened in chrome://tracing or Perfetto).
+ * Scopes may be nested, e.g. per-vehicle addModule contains the initialize stages of the new host.
+ */
+class StartupProfiler
+{
+	public:
+		/**
+		 * measures the lifetime of this object; a no-op unless profiling is enabled
+		 */
+		class Scope
+		{
+			public:
+				/**
+				 * @param type module type (usually getClassName()), @param section what is measured, @param stage init stage or -1;
+				 * type is copied into the record, section is kept by pointer, so pass a string literal
+				 */
+				Scope(const char* type, const char* section, int stage = -1);
+				~Scope();
+
+			private:
+				Scope(const Scope&);
+				Scope& operator=(const Scope&);
+
+				const char* type;
+				const char* section;
+				int stage;
+				bool active;
+				std::chrono::steady_clock::time_point start;
+				uint64_t allocCountAtStart;
+				uint64_t allocBytesAtStart;
+		};
+
+		static StartupProfiler& getInstance();
+
+		/** returns whether profiling is enabled for the current run */
+		bool isEnabled();
+
+		/** writes the summary table and the trace file, then forgets all records so the next run starts afresh */
+		void writeReport();
+
+		/** returns the number of heap allocations and bytes allocated so far (both 0 unless allocation counting is compiled in) */
+		static uint64_t getAllocationCount();
+		static uint64_t getAllocatedBytes();
+
+	protected:
+		struct Record {
+			std::string type;
+			const char* section;
+			int stage;
+			double start; /**< relative to the first record (in s) */
+			double duration; /**< in s */
+			uint64_t allocCount;
+			uint64_t allocBytes;
+		};
+
+		StartupProfiler();
+		~StartupProfiler();
+
+		void add(const Record& record);
+		bool writeSummary(const std::string& fileName) const;
+		bool writeTrace(const std::string& fileName) const;
+
+		bool configured; /**< whether the configuration of the current run has been read */
+		std::string prefix; /**< output file prefix, empty if profiling is disabled */
+		bool haveEpoch;
+		std::chrono::steady_clock::time_point epoch;
+		std::vector<Record> records;
+
+		friend class Scope;
+};
+
+}
+
+#endif
@@ -0,0 +1,99 @@
+//
+// ThreadPool - fixed set of worker threads for data-parallel loops
+// Copyright (C) 2018 Xu Le <xmutongxinXuLe@163.com>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "veins/base/utils/ThreadPool.h"
+
+namespace Veins {
+
+ThreadPool::ThreadPool(size_t threads) : job(0), jobSize(0), nextJob(0), busyWorkers(0), generation(0), stopping(false) {
+	for (size_t i = 1; i < threads; ++i) {
+		workers.push_back(std::thread(&ThreadPool::work, this));
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (std::vector<std::thread>::iterator i = workers.begin(); i != workers.end(); ++i) i->join();
+}
+
+void ThreadPool::parallelFor(size_t n, const std::function<void(size_t)>& job) {
+	if (n == 0) return;
+
+	// not worth waking anyone
+	if (workers.empty() || (n == 1)) {
+		for (size_t i = 0; i < n; ++i) job(i);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		this->job = &job;
+		jobSize = n;
+		nextJob = 0;
+		busyWorkers = workers.size();
+		error = std::exception_ptr();
+		generation++;
+	}
+	wake.notify_all();
+
+	runJobs();
+
+	std::unique_lock<std::mutex> lock(mutex);
+	done.wait(lock, [this]{ return busyWorkers == 0; });
+	this->job = 0;
+	if (error) {
+		std::exception_ptr e = error;
+		error = std::exception_ptr();
+		std::rethrow_exception(e);
+	}
+}
+
+void ThreadPool::work() {
+	uint64_t seenGeneration = 0;
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		wake.wait(lock, [this, &seenGeneration]{ return stopping || (generation != seenGeneration); });
+		if (stopping) return;
+		seenGeneration = generation;
+
+		lock.unlock();
+		runJobs();
+		lock.lock();
+
+		if (--busyWorkers == 0) done.notify_one();
+	}
+}
+
+void ThreadPool::runJobs() {
+	for (size_t i = nextJob++; i < jobSize; i = nextJob++) {
+		try {
+			(*job)(i);
+		}
+		catch (...) {
+			std::lock_guard<std::mutex> lock(mutex);
+			if (!error) error = std::current_exception();
+		}
+	}
+}
+
+}
@@ -0,0 +1,83 @@
+//
+// ThreadPool - fixed set of worker threads for data-parallel loops
+// Copyright (C) 2018 Xu Le <xmutongxinXuLe@163.com>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#ifndef VEINS_BASE_UTILS_THREADPOOL_H
+#define VEINS_BASE_UTILS_THREADPOOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <atomic>
+#include <stdint.h>
+
+#include "veins/base/utils/MiXiMDefs.h"
+
+namespace Veins {
+
+/**
+ * runs the iterations of a loop on a fixed set of worker threads and the calling thread.
+ *
+ * Meant for work that is independent across iterations and does not touch the simulation
+ * (no logging, no random numbers, no messages), e.g. evaluating analogue models for all
+ * receivers of a frame. Iterations are handed out in no particular order, so results must not
+ * depend on it.
+ */
+class MIXIM_API ThreadPool
+{
+	public:
+		/** starts threads-1 workers (the calling thread is the last one) */
+		ThreadPool(size_t threads);
+		~ThreadPool();
+
+		/** returns the number of threads sharing the work of parallelFor, including the calling thread */
+		size_t size() const { return workers.size() + 1; }
+
+		/**
+		 * calls job(i) for every i in [0, n) and returns once all calls finished;
+		 * rethrows the first exception thrown by any of them
+		 */
+		void parallelFor(size_t n, const std::function<void(size_t)>& job);
+
+	private:
+		ThreadPool(const ThreadPool&);
+		ThreadPool& operator=(const ThreadPool&);
+
+		void work();
+		void runJobs();
+
+		std::vector<std::thread> workers;
+		std::mutex mutex;
+		std::condition_variable wake; /**< signalled when a new loop starts or the pool shuts down */
+		std::condition_variable done; /**< signalled when the last worker finished its share of a loop */
+
+		const std::function<void(size_t)>* job; /**< loop body of the current loop */
+		size_t jobSize; /**< number of iterations of the current loop */
+		std::atomic<size_t> nextJob; /**< next iteration to hand out */
+		size_t busyWorkers; /**< workers not yet done with the current loop */
+		uint64_t generation; /**< number of loops started, so workers can tell a new one */
+		bool stopping;
+		std::exception_ptr error; /**< first exception thrown in the current loop */
+};
+
+}
+
+#endif
@@ -17,10 +17,26 @@ SimpleObstacleShadowing::SimpleObstacleShadowing(ObstacleControl& obstacleContro
 
 void SimpleObstacleShadowing::filterSignal(AirFrame *frame, const Coord& sendersPos, const Coord& receiverPos)
 {
-	Signal& s = frame->getSignal();
+	addAttenuation(frame->getSignal(), obstacleControl.calculateAttenuation(sendersPos, receiverPos));
+}
+
+double SimpleObstacleShadowing::precompute(const Coord& sendersPos, const Coord& receiverPos) const
+{
+	return obstacleControl.calculateAttenuationConcurrently(sendersPos, receiverPos);
+}
+
+double SimpleObstacleShadowing::evaluate(const Coord& sendersPos, const Coord& receiverPos)
+{
+	return obstacleControl.calculateAttenuation(sendersPos, receiverPos);
+}
 
-	double factor = obstacleControl.calculateAttenuation(sendersPos, receiverPos);
+void SimpleObstacleShadowing::filterSignalPrecomputed(AirFrame *frame, double precomputed)
+{
+	addAttenuation(frame->getSignal(), precomputed);
+}
 
+void SimpleObstacleShadowing::addAttenuation(Signal& s, double factor)
+{
 	debugEV << "value is: " << factor << endl;
 
 	bool hasFrequency = s.getTransmissionPower()->getDimensionSet().hasDimension(Dimension::frequency());
@@ -44,7 +44,22 @@ public:
 	 */
 	virtual void filterSignal(AirFrame *frame, const Coord& sendersPos, const Coord& receiverPos);
 
+	/** @brief The ray tests against obstacles can be evaluated ahead of time.*/
+	virtual bool isPrecomputable() const { return true; }
+
+	/** @brief Returns the attenuation by obstacles between the passed positions.*/
+	virtual double precompute(const Coord& sendersPos, const Coord& receiverPos) const;
+
+	/** @brief Like precompute(), but uses the cache of ObstacleControl and draws its annotations.*/
+	virtual double evaluate(const Coord& sendersPos, const Coord& receiverPos);
+
+	/** @brief Adds the attenuation returned by precompute() to the Signal.*/
+	virtual void filterSignalPrecomputed(AirFrame *frame, double precomputed);
+
 protected:
+	/** @brief Adds a constant attenuation by factor to the Signal.*/
+	void addAttenuation(Signal& s, double factor);
+
 	/** @brief reference to global ObstacleControl instance */
 	ObstacleControl& obstacleControl;
 
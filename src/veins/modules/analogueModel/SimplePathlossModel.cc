@@ -33,8 +33,11 @@ double SimplePathlossConstMapping::getValue(const Argument& pos) const
 
 void SimplePathlossModel::filterSignal(AirFrame *frame, const Coord& sendersPos, const Coord& receiverPos)
 {
-	Signal& signal = frame->getSignal();
+	filterSignalPrecomputed(frame, evaluate(sendersPos, receiverPos));
+}
 
+double SimplePathlossModel::evaluate(const Coord& sendersPos, const Coord& receiverPos)
+{
 	/** Calculate the distance factor */
 	double sqrDistance = useTorus ? receiverPos.sqrTorusDist(sendersPos, playgroundSize)
 								  : receiverPos.sqrdist(sendersPos);
@@ -43,7 +46,7 @@ void SimplePathlossModel::filterSignal(AirFrame *frame, const Coord& sendersPos,
 
 	if(sqrDistance <= 1.0) {
 		//attenuation is negligible
-		return;
+		return -1;
 	}
 
 	// wavelength in meters (this is only used for debug purposes here
@@ -56,6 +59,15 @@ void SimplePathlossModel::filterSignal(AirFrame *frame, const Coord& sendersPos,
 	double distFactor = pow(sqrDistance, -pathLossAlphaHalf) / (16.0 * M_PI * M_PI);
 	splmEV << "distance factor is: " << distFactor << endl;
 
+	return distFactor;
+}
+
+void SimplePathlossModel::filterSignalPrecomputed(AirFrame *frame, double precomputed)
+{
+	if (precomputed < 0) return;
+
+	Signal& signal = frame->getSignal();
+
 	//is our signal to attenuate defined over frequency?
 	bool hasFrequency = signal.getTransmissionPower()->getDimensionSet().hasDimension(Dimension::frequency());
 	splmEV << "Signal contains frequency dimension: " << (hasFrequency ? "yes" : "no") << endl;
@@ -68,7 +80,7 @@ void SimplePathlossModel::filterSignal(AirFrame *frame, const Coord& sendersPos,
 	SimplePathlossConstMapping* attMapping = new SimplePathlossConstMapping(
 													domain,
 													this,
-													distFactor);
+													precomputed);
 
 	/* at last add the created attenuation mapping to the signal */
 	signal.addAttenuation(attMapping);
@@ -114,6 +114,15 @@ public:
 	 */
 	virtual void filterSignal(AirFrame *, const Coord&, const Coord&);
 
+	/** @brief The distance factor only depends on the positions, but is cheap enough to stay off worker threads.*/
+	virtual bool isLinkCacheable() const { return true; }
+
+	/** @brief Returns the distance factor between the passed positions, or -1 if the attenuation is negligible.*/
+	virtual double evaluate(const Coord& sendersPos, const Coord& receiverPos);
+
+	/** @brief Adds the attenuation for the distance factor returned by evaluate() to the Signal.*/
+	virtual void filterSignalPrecomputed(AirFrame *frame, double precomputed);
+
 	/**
 	 * @brief Method to calculate the attenuation value for pathloss.
 	 *
@@ -34,9 +34,29 @@ void BaseServer::initialize(int stage)
 			rsuIn[i] = findGate("rsuIn", i);
 			rsuOut[i] = findGate("rsuOut", i);
 		}
+		// gate IDs of a gate vector are contiguous, but do not rely on it when building the dispatch table
+		if (rsuNum > 0)
+		{
+			rsuIdxOfGate.assign(rsuIn[rsuNum-1] - rsuIn[0] + 1, -1);
+			for (int i = 0; i < rsuNum; ++i)
+				rsuIdxOfGate[rsuIn[i] - rsuIn[0]] = i;
+		}
 		cellularIn = findGate("cellularIn");
 		cellularOut = findGate("cellularOut");
 		headerLength = par("headerLength").longValue();
+		flowModel = par("flowMode").boolValue() ? new BackboneFlowModel(this, SelfMsgKinds::FLOW_END_EVT, headerLength) : nullptr;
+
+		contentPushInterval = par("contentPushInterval").doubleValue();
+		contentSize = par("contentSize").longValue();
+		contentPushEvt = new cMessage("content push evt", SelfMsgKinds::CONTENT_PUSH_EVT);
+		if (contentPushInterval > SIMTIME_ZERO && rsuNum > 0)
+			scheduleAt(simTime() + contentPushInterval, contentPushEvt);
+		pushedBytes = 0;
+
+		rsuMsgCount = 0;
+		lteMsgCount = 0;
+		rsuBits = 0;
+		lteBits = 0;
 	}
 	else
 	{
@@ -48,38 +68,55 @@ void BaseServer::finish()
 {
 	EV << "BaseServer::finish() called.\n";
 
+	recordScalar("rsuMsgCount", rsuMsgCount);
+	recordScalar("lteMsgCount", lteMsgCount);
+	recordScalar("rsuBits", rsuBits);
+	recordScalar("lteBits", lteBits);
+	if (simTime() > SIMTIME_ZERO)
+		recordScalar("backboneThroughput", (rsuBits + lteBits) / simTime().dbl(), "bps");
+	if (contentPushInterval > SIMTIME_ZERO)
+		recordScalar("pushedBytes", pushedBytes);
+	if (flowModel != nullptr)
+	{
+		recordScalar("flowsStarted", flowModel->flowsStarted);
+		recordScalar("flowsCompleted", flowModel->flowsCompleted);
+		recordScalar("flowBytesCompleted", flowModel->bytesCompleted);
+		delete flowModel;
+		flowModel = nullptr;
+	}
+
+	cancelAndDelete(contentPushEvt);
 	delete []rsuIn;
 	delete []rsuOut;
+	rsuIdxOfGate.clear();
 
 	cComponent::finish();
 }
 
 void BaseServer::handleMessage(cMessage *msg)
 {
+	const int gateId = msg->getArrivalGateId();
 	if (msg->isSelfMessage())
 		handleSelfMsg(msg);
-	else if (msg->getArrivalGateId() >= rsuIn[0] && msg->getArrivalGateId() <= rsuIn[rsuNum-1])
+	else if (rsuNum > 0 && gateId >= rsuIn[0] && gateId <= rsuIn[rsuNum-1] && rsuIdxOfGate[gateId - rsuIn[0]] >= 0)
 	{
 		WiredMessage *rsuMsg = dynamic_cast<WiredMessage*>(msg);
-		for (int rsuIdx = 0; rsuIdx < rsuNum; ++rsuIdx)
-		{
-			if (msg->getArrivalGateId() == rsuIn[rsuIdx])
-			{
-				handleRSUIncomingMsg(rsuMsg, rsuIdx);
-				delete rsuMsg;
-				rsuMsg = nullptr;
-				break;
-			}
-		}
+		++rsuMsgCount;
+		rsuBits += rsuMsg->getBitLength() + 8*BackboneFlowModel::countReceived(rsuMsg);
+		handleRSUIncomingMsg(rsuMsg, rsuIdxOfGate[gateId - rsuIn[0]]);
+		delete rsuMsg;
+		rsuMsg = nullptr;
 	}
-	else if (msg->getArrivalGateId() == cellularIn)
+	else if (gateId == cellularIn)
 	{
 		WiredMessage *lteMsg = dynamic_cast<WiredMessage*>(msg);
+		++lteMsgCount;
+		lteBits += lteMsg->getBitLength() + 8*BackboneFlowModel::countReceived(lteMsg);
 		handleLTEIncomingMsg(lteMsg);
 		delete lteMsg;
 		lteMsg = nullptr;
 	}
-	else if (msg->getArrivalGateId() == -1)
+	else if (gateId == -1)
 		error("No self message and no gateID! Check configuration.");
 	else
 		error("Unknown gateID! Check configuration or override handleMessage().");
@@ -89,6 +126,18 @@ void BaseServer::handleSelfMsg(cMessage *msg)
 {
 	switch (msg->getKind())
 	{
+	case SelfMsgKinds::FLOW_END_EVT:
+	{
+		ASSERT(flowModel != nullptr);
+		flowModel->handleEndEvt(msg);
+		break;
+	}
+	case SelfMsgKinds::CONTENT_PUSH_EVT:
+	{
+		pushContent();
+		scheduleAt(simTime() + contentPushInterval, contentPushEvt);
+		break;
+	}
 	case SelfMsgKinds::LAST_SERVER_MESSAGE_KIND:
 	{
 		break;
@@ -107,3 +156,22 @@ void BaseServer::handleLTEIncomingMsg(WiredMessage *lteMsg)
 {
 	EV << "receiving a message from cellular base station.\n";
 }
+
+void BaseServer::pushContent()
+{
+	EV << "pushing a content of " << contentSize << " bytes to " << rsuNum << " RSUs.\n";
+
+	for (int i = 0; i < rsuNum; ++i)
+	{
+		sendBulk(rsuOut[i], new WiredMessage("content"), contentSize);
+		pushedBytes += contentSize;
+	}
+}
+
+void BaseServer::sendBulk(int gateId, WiredMessage *wiredMsg, int64_t bytes)
+{
+	if (flowModel != nullptr)
+		flowModel->startFlow(gateId, wiredMsg, bytes);
+	else
+		BackboneFlowModel::sendPacket(this, gateId, wiredMsg, bytes, headerLength);
+}
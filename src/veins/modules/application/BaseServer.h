@@ -19,9 +19,11 @@
 #ifndef __BASESERVER_H__
 #define __BASESERVER_H__
 
+#include <vector>
 #include <omnetpp/csimplemodule.h>
 #include "veins/base/utils/SimpleAddress.h"
 #include "veins/modules/messages/WiredMessage_m.h"
+#include "veins/modules/utility/BackboneFlowModel.h"
 
 /**
  * @brief Base class for Server design.
@@ -46,6 +48,8 @@ public:
 private:
 	/** @brief The self message kinds. */
 	enum SelfMsgKinds {
+		FLOW_END_EVT,
+		CONTENT_PUSH_EVT,
 		LAST_SERVER_MESSAGE_KIND
 	};
 
@@ -58,6 +62,12 @@ private:
 	void handleLTEIncomingMsg(WiredMessage *lteMsg);
 	/** @brief Handle wired incoming messages from road side unit. */
 	void handleRSUIncomingMsg(WiredMessage *rsuMsg, int rsuIdx);
+	/** @brief Push a content of contentSize bytes to every RSU. */
+	void pushContent();
+
+protected:
+	/** @brief Send a bulk transfer of 'bytes' bytes through output gate 'gateId', as a backbone flow in flow mode and as one data packet otherwise. */
+	void sendBulk(int gateId, WiredMessage *wiredMsg, int64_t bytes);
 
 private:
 	int rsuNum; ///< number of RSUs in current scenario.
@@ -69,6 +79,24 @@ private:
 	int cellularOut; ///< send packets to cellular base station.
 	///@}
 	int headerLength; ///< header length of the wired UDP/IP packet in bits.
+
+	BackboneFlowModel *flowModel; ///< fluid model of bulk transfers towards RSUs and base station, only exists in flow mode.
+
+	simtime_t contentPushInterval; ///< interval of pushing a content to every RSU, 0 disables pushing.
+	int64_t contentSize; ///< size of a pushed content in bytes.
+	cMessage *contentPushEvt; ///< self message event used to periodically push a content to every RSU.
+	int64_t pushedBytes; ///< number of content bytes handed to the wired gates towards RSUs.
+
+	/** @brief map (arrival gate ID - rsuIn[0]) to RSU index, -1 for holes, so that dispatching costs O(1). */
+	std::vector<int> rsuIdxOfGate;
+
+	/** @name backbone throughput statistics. */
+	///@{
+	long rsuMsgCount;  ///< number of messages received from road side units.
+	long lteMsgCount;  ///< number of messages received from cellular base station.
+	int64_t rsuBits;   ///< number of bits received from road side units, including the bytes of completed backbone flows.
+	int64_t lteBits;   ///< number of bits received from cellular base station, including the bytes of completed backbone flows.
+	///@}
 };
 
 #endif /* __BASESERVER_H__ */
@@ -35,8 +35,16 @@ void BaseStation::initialize(int stage)
 		wirelessHeaderLength = par("wirelessHeaderLength").longValue();
 		wirelessDataLength = par("wirelessDataLength").longValue();
 		wirelessBitsRate = par("wirelessBitsRate").longValue();
+		flowModel = par("flowMode").boolValue() ? new BackboneFlowModel(this, SelfMsgKinds::FLOW_END_EVT, wiredHeaderLength) : nullptr;
 
 		rootModule = cSimulation::getActiveSimulation()->getSystemModule();
+		rootModule->subscribe(PRE_MODEL_CHANGE, this);
+
+		wirelessMsgCount = 0;
+		wiredBits = 0;
+		routeCacheHits = 0;
+		routeCacheMisses = 0;
+		routeInvalidations = 0;
 	}
 	else
 	{
@@ -48,6 +56,22 @@ void BaseStation::finish()
 {
 	EV << "BaseStation::finish() called.\n";
 
+	recordScalar("wirelessMsgCount", wirelessMsgCount);
+	recordScalar("wiredBits", wiredBits);
+	recordScalar("routeCacheHits", routeCacheHits);
+	recordScalar("routeCacheMisses", routeCacheMisses);
+	recordScalar("routeInvalidations", routeInvalidations);
+	if (flowModel != nullptr)
+	{
+		recordScalar("flowsStarted", flowModel->flowsStarted);
+		recordScalar("flowsCompleted", flowModel->flowsCompleted);
+		recordScalar("flowBytesCompleted", flowModel->bytesCompleted);
+		delete flowModel;
+		flowModel = nullptr;
+	}
+
+	rootModule->unsubscribe(PRE_MODEL_CHANGE, this);
+
 	for (itV = vehicles.begin(); itV != vehicles.end(); ++itV)
 		delete itV->second;
 	vehicles.clear();
@@ -55,6 +79,29 @@ void BaseStation::finish()
 	cComponent::finish();
 }
 
+void BaseStation::receiveSignal(cComponent *source, simsignal_t signalID, cObject *obj, cObject *details)
+{
+	if (signalID != PRE_MODEL_CHANGE)
+		return;
+
+	cPreModuleDeleteNotification *notification = dynamic_cast<cPreModuleDeleteNotification*>(obj);
+	if (notification == nullptr)
+		return;
+
+	cModule *mod = notification->module;
+	if (mod->getParentModule() != rootModule || !mod->isVector() || strcmp(mod->getName(), "node") != 0)
+		return;
+
+	itV = vehicles.find(mod->getIndex());
+	if (itV != vehicles.end())
+	{
+		EV << "vehicle " << itV->first << " is deleted, invalidate its routing entry.\n";
+		delete itV->second;
+		vehicles.erase(itV);
+		++routeInvalidations;
+	}
+}
+
 void BaseStation::handleMessage(cMessage *msg)
 {
 	if (msg->isSelfMessage())
@@ -69,6 +116,7 @@ void BaseStation::handleMessage(cMessage *msg)
 	else if (msg->getArrivalGateId() == wiredIn)
 	{
 		WiredMessage *wiredMsg = dynamic_cast<WiredMessage*>(msg);
+		wiredBits += wiredMsg->getBitLength() + 8*BackboneFlowModel::countReceived(wiredMsg);
 		handleWiredIncomingMsg(wiredMsg);
 		delete wiredMsg;
 		wiredMsg = nullptr;
@@ -83,6 +131,12 @@ void BaseStation::handleSelfMsg(cMessage *msg)
 {
 	switch (msg->getKind())
 	{
+	case SelfMsgKinds::FLOW_END_EVT:
+	{
+		ASSERT(flowModel != nullptr);
+		flowModel->handleEndEvt(msg);
+		break;
+	}
 	case SelfMsgKinds::LAST_BASE_STATION_MESSAGE_KIND:
 	{
 		break;
@@ -97,9 +151,8 @@ void BaseStation::handleWirelessIncomingMsg(CellularMessage *cellularMsg)
 	LAddress::L3Type vehicle = cellularMsg->getVehicle(); // alias
 	EV << "receiving a message from vehicle " << vehicle << ".\n";
 
-	VehicleInfo *info = new VehicleInfo;
-	info->correspondingGate = rootModule->getSubmodule("node", vehicle)->gate("veinscellularIn");
-	vehicles.insert(std::pair<LAddress::L3Type, VehicleInfo*>(vehicle, info));
+	++wirelessMsgCount;
+	lookupVehicle(vehicle);
 }
 
 void BaseStation::handleWiredIncomingMsg(WiredMessage *wiredMsg)
@@ -107,6 +160,34 @@ void BaseStation::handleWiredIncomingMsg(WiredMessage *wiredMsg)
 	EV << "receiving a message from base server.\n";
 }
 
+void BaseStation::sendBulk(int gateId, WiredMessage *wiredMsg, int64_t bytes)
+{
+	if (flowModel != nullptr)
+		flowModel->startFlow(gateId, wiredMsg, bytes);
+	else
+		BackboneFlowModel::sendPacket(this, gateId, wiredMsg, bytes, wiredHeaderLength);
+}
+
+BaseStation::VehicleInfo* BaseStation::lookupVehicle(LAddress::L3Type vehicle)
+{
+	itV = vehicles.find(vehicle);
+	if (itV != vehicles.end())
+	{
+		++routeCacheHits;
+		return itV->second;
+	}
+
+	++routeCacheMisses;
+	cModule *vehicleModule = rootModule->getSubmodule("node", vehicle);
+	if (vehicleModule == nullptr)
+		error("vehicle %ld does not exist.", vehicle);
+
+	VehicleInfo *info = new VehicleInfo;
+	info->correspondingGate = vehicleModule->gate("veinscellularIn");
+	vehicles.insert(std::pair<LAddress::L3Type, VehicleInfo*>(vehicle, info));
+	return info;
+}
+
 /////////////////////////    internal class implementations    /////////////////////////
 BaseStation::VehicleInfo::VehicleInfo() : correspondingGate(nullptr)
 {
@@ -22,13 +22,14 @@
 #include "veins/base/utils/SimpleAddress.h"
 #include "veins/modules/messages/CellularMessage_m.h"
 #include "veins/modules/messages/WiredMessage_m.h"
+#include "veins/modules/utility/BackboneFlowModel.h"
 
 /**
  * @brief LTE Base Station.
  *
  * @author Xu Le
  */
-class BaseStation : public ::omnetpp::cSimpleModule
+class BaseStation : public ::omnetpp::cSimpleModule, public ::omnetpp::cListener
 {
 public:
 	/** @name constructor, destructor. */
@@ -41,9 +42,13 @@ public:
 	void initialize(int stage) override;
 	void finish() override;
 
+	/** @brief Invalidate the cached routing entry of a vehicle module which is about to be deleted. */
+	void receiveSignal(cComponent *source, simsignal_t signalID, cObject *obj, cObject *details) override;
+
 private:
 	/** @brief The self message kinds. */
 	enum SelfMsgKinds {
+		FLOW_END_EVT,
 		LAST_BASE_STATION_MESSAGE_KIND
 	};
 
@@ -57,6 +62,10 @@ private:
 	/** @brief Handle wired incoming messages. */
 	void handleWiredIncomingMsg(WiredMessage *wiredMsg);
 
+protected:
+	/** @brief Send a bulk transfer of 'bytes' bytes through output gate 'gateId', as a backbone flow in flow mode and as one data packet otherwise. */
+	void sendBulk(int gateId, WiredMessage *wiredMsg, int64_t bytes);
+
 public:
 	/** @brief The class to store downloader's information. */
 	class VehicleInfo
@@ -64,9 +73,14 @@ public:
 	public:
 		VehicleInfo();
 
-		cGate *correspondingGate;
+		cGate *correspondingGate; ///< the veinscellularIn gate of the vehicle, valid until the vehicle is deleted.
 	};
 
+private:
+	/** @brief Return the cached routing entry of a vehicle, resolving its gate on first use. */
+	VehicleInfo* lookupVehicle(LAddress::L3Type vehicle);
+
+public:
 	/** @name gate IDs. */
 	///@{
 	int wirelessIn; ///< receive packets from vehicles.
@@ -79,10 +93,21 @@ public:
 	int wirelessDataLength; ///< length of the cellular packet data measured in bits.
 	int wirelessBitsRate; ///< data transmission rate measured in bps of wireless radio.
 
+	BackboneFlowModel *flowModel; ///< fluid model of bulk transfers towards the server, only exists in flow mode.
+
 	cModule *rootModule; ///< store the pointer to system module to find the sender vehicle's compound module.
 
 	std::map<LAddress::L3Type, VehicleInfo*> vehicles; ///< a map from a vehicle's identifier to all its related info.
 	std::map<LAddress::L3Type, VehicleInfo*>::iterator itV; ///< a iterator used to traverse container vehicles.
+
+	/** @name routing table statistics. */
+	///@{
+	long wirelessMsgCount; ///< number of messages received from vehicles.
+	int64_t wiredBits;     ///< number of bits received from base server, including the bytes of completed backbone flows.
+	long routeCacheHits;   ///< number of messages whose vehicle gate was already cached.
+	long routeCacheMisses; ///< number of messages whose vehicle gate had to be resolved.
+	long routeInvalidations; ///< number of cached entries dropped because the vehicle was deleted.
+	///@}
 };
 
 #endif /* __BASESTATION_H__ */
@@ -18,6 +18,10 @@
 // Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 //
 
+#include <map>
+#include <memory>
+#include <vector>
+
 #include "veins/modules/mac/ieee80211p/Mac1609_4.h"
 #include "veins/modules/messages/PhyControlMessage_m.h"
 
@@ -29,6 +33,16 @@
 
 Define_Module(Mac1609_4);
 
+namespace {
+
+/** frame durations by number of OFDM symbols, shared by all MACs and runs as simtime-resolution is a global, process-wide option */
+std::vector<simtime_t> frameDurations;
+
+/** bitrate mappings by PHY header length and bitrate, shared by the signals of all frames */
+std::map<std::pair<int, uint64_t>, std::unique_ptr<Mapping> > bitrateMappings;
+
+}
+
 void Mac1609_4::initialize(int stage)
 {
 	BaseMacLayer::initialize(stage);
@@ -203,6 +217,21 @@ void Mac1609_4::finish()
 	recordScalar("totalBusyTime", statsTotalBusyTime.dbl());
 }
 
+void Mac1609_4::recycle()
+{
+	delete lastMac;
+	lastMac = nullptr;
+	lastWSM = nullptr;
+	frequency.clear();
+	delete passedMsg;
+	passedMsg = nullptr;
+}
+
+void Mac1609_4::reinitialize(int stage)
+{
+	initialize(stage);
+}
+
 /* Will change the Service Channel on which the mac layer is listening and sending */
 void Mac1609_4::changeServiceChannel(int cN)
 {
@@ -627,15 +656,20 @@ Signal* Mac1609_4::createSignal(simtime_t start, simtime_t length, double power,
 	ConstMapping *txPowerMapping = createSingleFrequencyMapping(start, end, frequency, 5.0e6, power);
 	s->setTransmissionPower(txPowerMapping);
 
-	Mapping *bitrateMapping = MappingUtils::createMapping(DimensionSet::timeDomain(), Mapping::STEPS);
+	// the bitrate mapping does not depend on the frame, so all signals share one per bitrate
+	std::unique_ptr<Mapping>& bitrateMapping = bitrateMappings[std::make_pair(phyHeaderLength, bitrate)];
+	if (!bitrateMapping)
+	{
+		bitrateMapping.reset(MappingUtils::createMapping(DimensionSet::timeDomain(), Mapping::STEPS));
 
-	Argument pos(start);
-	bitrateMapping->setValue(pos, bitrate);
+		Argument pos(SIMTIME_ZERO);
+		bitrateMapping->setValue(pos, bitrate);
 
-	pos.setTime(phyHeaderLength / bitrate);
-	bitrateMapping->setValue(pos, bitrate);
+		pos.setTime(phyHeaderLength / bitrate);
+		bitrateMapping->setValue(pos, bitrate);
+	}
 
-	s->setBitrate(bitrateMapping);
+	s->setSharedBitrate(bitrateMapping.get());
 
 	return s;
 }
@@ -799,19 +833,25 @@ void Mac1609_4::setParametersForBitrate(uint64_t bitrate)
 
 simtime_t Mac1609_4::getFrameDuration(int payloadLengthBits, enum PHY_MCS mcs) const
 {
-	simtime_t duration;
+	// calculate frame duration according to Equation (17-29) of the IEEE 802.11-2007 standard
+	size_t symbols;
 	if (mcs == MCS_DEFAULT)
 	{
-		// calculate frame duration according to Equation (17-29) of the IEEE 802.11-2007 standard
-		duration = PHY_HDR_PREAMBLE_DURATION + PHY_HDR_PLCPSIGNAL_DURATION + T_SYM_80211P * ceil( (16 + payloadLengthBits + 6)/(n_dbps) );
+		symbols = ceil( (16 + payloadLengthBits + 6)/(n_dbps) );
 	}
 	else
 	{
 		uint32_t ndbps = getNDBPS(mcs);
-		duration = PHY_HDR_PREAMBLE_DURATION + PHY_HDR_PLCPSIGNAL_DURATION + T_SYM_80211P * ceil( (16 + payloadLengthBits + 6)/(ndbps) );
+		symbols = ceil( (16 + payloadLengthBits + 6)/(ndbps) );
+	}
+
+	// look the duration up instead of converting it to simtime_t for every frame
+	while (frameDurations.size() <= symbols)
+	{
+		frameDurations.push_back(PHY_HDR_PREAMBLE_DURATION + PHY_HDR_PLCPSIGNAL_DURATION + T_SYM_80211P * frameDurations.size());
 	}
 
-	return duration;
+	return frameDurations[symbols];
 }
 
 //////////////////////////////    Unicast    //////////////////////////////
@@ -27,6 +27,7 @@
 #include "veins/base/utils/FindModule.h"
 #include "veins/base/modules/BaseLayer.h"
 #include "veins/base/modules/BaseMacLayer.h"
+#include "veins/base/modules/RecyclableModule.h"
 #include "veins/base/phyLayer/MacToPhyControlInfo.h"
 #include "veins/modules/phy/PhyLayer80211p.h"
 #include "veins/modules/mac/ieee80211p/WaveAppToMac1609_4Interface.h"
@@ -54,7 +55,7 @@
  * @see PhyLayer80211p
  * @see Decider80211p
  */
-class Mac1609_4 : public BaseMacLayer, public WaveAppToMac1609_4Interface
+class Mac1609_4 : public BaseMacLayer, public WaveAppToMac1609_4Interface, public RecyclableModule
 {
 public:
 	// Access categories in increasing order of priority (see IEEE Std 802.11-2012, Table 9-1)
@@ -180,6 +181,11 @@ public:
 	 */
 	void setCCAThreshold(double ccaThreshold_dBm);
 
+	/** @brief Releases the last transmitted frame kept for retransmission, finish() releases the rest. */
+	virtual void recycle();
+	/** @brief Re-runs initialize(), the MAC address and interface registration of the first life are kept. */
+	virtual void reinitialize(int stage);
+
 private:
 	/** @brief Initialization of the module and some variables. */
 	virtual void initialize(int);
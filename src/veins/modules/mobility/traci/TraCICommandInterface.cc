@@ -12,10 +12,83 @@
 
 namespace Veins {
 
-TraCICommandInterface::TraCICommandInterface(TraCIConnection& c) : connection(c)
+TraCICommandInterface::TraCICommandInterface(TraCIConnection& c) : connection(c), deferSetCommands(false), cacheNetwork(true)
 {
 }
 
+void TraCICommandInterface::invalidateNetworkCache() {
+	laneShapes.clear();
+	laneLengths.clear();
+	junctionPositions.clear();
+	routeRoadIds.clear();
+	laneIds = CachedIdList();
+	junctionIds = CachedIdList();
+	polygonIds = CachedIdList();
+}
+
+/**
+ * pre-populates lane and junction data from a SUMO network; example below.
+ *
+ * <net>
+ *   <edge id="1to2">
+ *     <lane id="1to2_0" speed="13.89" length="95.20" shape="0.00,-1.65 95.20,-1.65"/>
+ *   </edge>
+ *   <junction id="1" x="0.00" y="0.00"/>
+ * </net>
+ */
+void TraCICommandInterface::preloadNetwork(cXMLElement* net) {
+	cXMLElementList edges = net->getChildrenByTagName("edge");
+	for (cXMLElementList::const_iterator i = edges.begin(); i != edges.end(); ++i) {
+		cXMLElementList lanes = (*i)->getChildrenByTagName("lane");
+		for (cXMLElementList::const_iterator j = lanes.begin(); j != lanes.end(); ++j) {
+			const char* id = (*j)->getAttribute("id");
+			if (!id) continue;
+
+			if (const char* length = (*j)->getAttribute("length")) laneLengths[id] = atof(length);
+			if (const char* shape = (*j)->getAttribute("shape")) {
+				std::list<Coord>& coords = laneShapes[id];
+				coords.clear();
+				std::vector<std::string> points = cStringTokenizer(shape, " ").asVector();
+				for (std::vector<std::string>::const_iterator k = points.begin(); k != points.end(); ++k) {
+					std::vector<double> pa = cStringTokenizer(k->c_str(), ",").asDoubleVector();
+					if (pa.size() < 2) throw cRuntimeError("invalid shape of lane %s in road network", id);
+					coords.push_back(connection.traci2omnet(TraCICoord(pa[0], pa[1])));
+				}
+			}
+		}
+	}
+
+	cXMLElementList junctions = net->getChildrenByTagName("junction");
+	for (cXMLElementList::const_iterator i = junctions.begin(); i != junctions.end(); ++i) {
+		const char* id = (*i)->getAttribute("id");
+		const char* x = (*i)->getAttribute("x");
+		const char* y = (*i)->getAttribute("y");
+		if (!id || !x || !y) continue;
+		junctionPositions[id] = connection.traci2omnet(TraCICoord(atof(x), atof(y)));
+	}
+}
+
+const std::list<std::string>& TraCICommandInterface::getCachedIdList(CachedIdList& cached, uint8_t commandId, uint8_t responseId) {
+	if (!cached.valid || !cacheNetwork) {
+		cached.ids = genericGetStringList(commandId, "", ID_LIST, responseId);
+		cached.valid = true;
+	}
+	return cached.ids;
+}
+
+void TraCICommandInterface::flush() {
+	connection.flush();
+}
+
+void TraCICommandInterface::querySet(uint8_t commandId, const TraCIBuffer& buf) {
+	if (deferSetCommands) {
+		connection.queryDeferred(commandId, buf);
+		return;
+	}
+	TraCIBuffer obuf = connection.query(commandId, buf);
+	ASSERT(obuf.eof());
+}
+
 std::pair<uint32_t, std::string> TraCICommandInterface::getVersion() {
 	bool success = false;
 	TraCIBuffer buf = connection.queryOptional(CMD_GETVERSION, TraCIBuffer(), success);
@@ -38,15 +111,13 @@ std::pair<uint32_t, std::string> TraCICommandInterface::getVersion() {
 void TraCICommandInterface::Vehicle::setSpeedMode(int32_t bitset) {
 	uint8_t variableId = VAR_SPEEDSETMODE;
 	uint8_t variableType = TYPE_INTEGER;
-	TraCIBuffer buf = traci->connection.query(CMD_SET_VEHICLE_VARIABLE, TraCIBuffer() << variableId << nodeId << variableType << bitset);
-	ASSERT(buf.eof());
+	traci->querySet(CMD_SET_VEHICLE_VARIABLE, TraCIBuffer() << variableId << nodeId << variableType << bitset);
 }
 
 void TraCICommandInterface::Vehicle::setSpeed(double speed) {
 	uint8_t variableId = VAR_SPEED;
 	uint8_t variableType = TYPE_DOUBLE;
-	TraCIBuffer buf = traci->connection.query(CMD_SET_VEHICLE_VARIABLE, TraCIBuffer() << variableId << nodeId << variableType << speed);
-	ASSERT(buf.eof());
+	traci->querySet(CMD_SET_VEHICLE_VARIABLE, TraCIBuffer() << variableId << nodeId << variableType << speed);
 }
 
 void TraCICommandInterface::Vehicle::setColor(const TraCIColor& color) {
@@ -54,8 +125,7 @@ void TraCICommandInterface::Vehicle::setColor(const TraCIColor& color) {
 	p << static_cast<uint8_t>(VAR_COLOR);
 	p << nodeId;
 	p << static_cast<uint8_t>(TYPE_COLOR) << color.red << color.green << color.blue << color.alpha;
-	TraCIBuffer buf = connection->query(CMD_SET_VEHICLE_VARIABLE, p);
-	ASSERT(buf.eof());
+	traci->querySet(CMD_SET_VEHICLE_VARIABLE, p);
 }
 
 void TraCICommandInterface::Vehicle::slowDown(double speed, int32_t time) {
@@ -64,23 +134,20 @@ void TraCICommandInterface::Vehicle::slowDown(double speed, int32_t time) {
 	int32_t count = 2;
 	uint8_t speedType = TYPE_DOUBLE;
 	uint8_t durationType = TYPE_INTEGER;
-	TraCIBuffer buf = connection->query(CMD_SET_VEHICLE_VARIABLE, TraCIBuffer() << variableId << nodeId << variableType << count << speedType << speed << durationType << time);
-	ASSERT(buf.eof());
+	traci->querySet(CMD_SET_VEHICLE_VARIABLE, TraCIBuffer() << variableId << nodeId << variableType << count << speedType << speed << durationType << time);
 }
 
 void TraCICommandInterface::Vehicle::newRoute(std::string roadId) {
 	uint8_t variableId = LANE_EDGE_ID;
 	uint8_t variableType = TYPE_STRING;
-	TraCIBuffer buf = connection->query(CMD_SET_VEHICLE_VARIABLE, TraCIBuffer() << variableId << nodeId << variableType << roadId);
-	ASSERT(buf.eof());
+	traci->querySet(CMD_SET_VEHICLE_VARIABLE, TraCIBuffer() << variableId << nodeId << variableType << roadId);
 }
 
 void TraCICommandInterface::Vehicle::setParking() {
 	uint8_t variableId = REMOVE;
 	uint8_t variableType = TYPE_BYTE;
 	uint8_t value = REMOVE_PARKING;
-	TraCIBuffer buf = connection->query(CMD_SET_VEHICLE_VARIABLE, TraCIBuffer() << variableId << nodeId << variableType << value);
-	ASSERT(buf.eof());
+	traci->querySet(CMD_SET_VEHICLE_VARIABLE, TraCIBuffer() << variableId << nodeId << variableType << value);
 }
 
 std::list<std::string> TraCICommandInterface::getVehicleTypeIds() {
@@ -99,6 +166,14 @@ double TraCICommandInterface::Road::getMeanSpeed() {
 	return traci->genericGetDouble(CMD_GET_EDGE_VARIABLE, roadId, LAST_STEP_MEAN_SPEED, RESPONSE_GET_EDGE_VARIABLE);
 }
 
+TraCICommandInterface::Future<double> TraCICommandInterface::Road::getCurrentTravelTimeAsync(Callback<double>::type callback) {
+	return traci->genericGetAsync<double>(CMD_GET_EDGE_VARIABLE, roadId, VAR_CURRENT_TRAVELTIME, RESPONSE_GET_EDGE_VARIABLE, TYPE_DOUBLE, callback);
+}
+
+TraCICommandInterface::Future<double> TraCICommandInterface::Road::getMeanSpeedAsync(Callback<double>::type callback) {
+	return traci->genericGetAsync<double>(CMD_GET_EDGE_VARIABLE, roadId, LAST_STEP_MEAN_SPEED, RESPONSE_GET_EDGE_VARIABLE, TYPE_DOUBLE, callback);
+}
+
 std::string TraCICommandInterface::Vehicle::getRoadId() {
 	return traci->genericGetString(CMD_GET_VEHICLE_VARIABLE, nodeId, VAR_ROAD_ID, RESPONSE_GET_VEHICLE_VARIABLE);
 }
@@ -115,6 +190,22 @@ int32_t TraCICommandInterface::Vehicle::getLaneIndex() {
 	return traci->genericGetInt(CMD_GET_VEHICLE_VARIABLE, nodeId, VAR_LANE_INDEX, RESPONSE_GET_VEHICLE_VARIABLE);
 }
 
+TraCICommandInterface::Future<std::string> TraCICommandInterface::Vehicle::getRoadIdAsync(Callback<std::string>::type callback) {
+	return traci->genericGetAsync<std::string>(CMD_GET_VEHICLE_VARIABLE, nodeId, VAR_ROAD_ID, RESPONSE_GET_VEHICLE_VARIABLE, TYPE_STRING, callback);
+}
+
+TraCICommandInterface::Future<std::string> TraCICommandInterface::Vehicle::getLaneIdAsync(Callback<std::string>::type callback) {
+	return traci->genericGetAsync<std::string>(CMD_GET_VEHICLE_VARIABLE, nodeId, VAR_LANE_ID, RESPONSE_GET_VEHICLE_VARIABLE, TYPE_STRING, callback);
+}
+
+TraCICommandInterface::Future<double> TraCICommandInterface::Vehicle::getLanePositionAsync(Callback<double>::type callback) {
+	return traci->genericGetAsync<double>(CMD_GET_VEHICLE_VARIABLE, nodeId, VAR_LANEPOSITION, RESPONSE_GET_VEHICLE_VARIABLE, TYPE_DOUBLE, callback);
+}
+
+TraCICommandInterface::Future<int32_t> TraCICommandInterface::Vehicle::getLaneIndexAsync(Callback<int32_t>::type callback) {
+	return traci->genericGetAsync<int32_t>(CMD_GET_VEHICLE_VARIABLE, nodeId, VAR_LANE_INDEX, RESPONSE_GET_VEHICLE_VARIABLE, TYPE_INTEGER, callback);
+}
+
 std::string TraCICommandInterface::Vehicle::getTypeId() {
 	return traci->genericGetString(CMD_GET_VEHICLE_VARIABLE, nodeId, VAR_TYPE, RESPONSE_GET_VEHICLE_VARIABLE);
 }
@@ -131,8 +222,13 @@ std::string TraCICommandInterface::Vehicle::getRouteId() {
 	return traci->genericGetString(CMD_GET_VEHICLE_VARIABLE, nodeId, VAR_ROUTE_ID, RESPONSE_GET_VEHICLE_VARIABLE);
 }
 
-std::list<std::string> TraCICommandInterface::Route::getRoadIds() {
-	return traci->genericGetStringList(CMD_GET_ROUTE_VARIABLE, routeId, VAR_EDGES, RESPONSE_GET_ROUTE_VARIABLE);
+const std::list<std::string>& TraCICommandInterface::Route::getRoadIds() {
+	std::map<std::string, std::list<std::string> >::iterator i = traci->routeRoadIds.find(routeId);
+	if (i != traci->routeRoadIds.end() && traci->cacheNetwork) return i->second;
+
+	std::list<std::string>& roadIds = traci->routeRoadIds[routeId];
+	roadIds = traci->genericGetStringList(CMD_GET_ROUTE_VARIABLE, routeId, VAR_EDGES, RESPONSE_GET_ROUTE_VARIABLE);
+	return roadIds;
 }
 
 void TraCICommandInterface::Vehicle::changeRoute(std::string roadId, double travelTime) {
@@ -185,6 +281,29 @@ double TraCICommandInterface::getDistance(const Coord& p1, const Coord& p2, bool
 	return distance;
 }
 
+TraCICommandInterface::Future<double> TraCICommandInterface::getDistanceAsync(const Coord& p1, const Coord& p2, bool returnDrivingDistance, Callback<double>::type callback) {
+	uint8_t variable = DISTANCE_REQUEST;
+	std::string simId = "sim0";
+	uint8_t variableType = TYPE_COMPOUND;
+	int32_t count = 3;
+	uint8_t dType = static_cast<uint8_t>(returnDrivingDistance ? REQUEST_DRIVINGDIST : REQUEST_AIRDIST);
+
+	Future<double> result(this);
+	std::shared_ptr<Future<double>::State> state = result.state;
+	connection.queryAsync(CMD_GET_SIM_VARIABLE, TraCIBuffer() << variable << simId << variableType << count << connection.omnet2traci(p1) << connection.omnet2traci(p2) << dType, [state, variable, simId, callback](TraCIBuffer& buf) {
+		uint8_t cmdLength_resp; buf >> cmdLength_resp;
+		uint8_t commandId_resp; buf >> commandId_resp; ASSERT(commandId_resp == RESPONSE_GET_SIM_VARIABLE);
+		uint8_t variableId_resp; buf >> variableId_resp; ASSERT(variableId_resp == variable);
+		std::string simId_resp; buf >> simId_resp; ASSERT(simId_resp == simId);
+		uint8_t typeId_resp; buf >> typeId_resp; ASSERT(typeId_resp == TYPE_DOUBLE);
+		buf >> state->value;
+		state->ready = true;
+		if (callback) callback(state->value);
+	});
+
+	return result;
+}
+
 void TraCICommandInterface::Vehicle::stopAt(std::string roadId, double pos, uint8_t laneid, double radius, double waittime) {
 	uint8_t variableId = CMD_STOP;
 	uint8_t variableType = TYPE_COMPOUND;
@@ -203,17 +322,15 @@ void TraCICommandInterface::Vehicle::stopAt(std::string roadId, double pos, uint
 }
 
 void TraCICommandInterface::Trafficlight::setProgram(std::string program) {
-	TraCIBuffer buf = connection->query(CMD_SET_TL_VARIABLE, TraCIBuffer() << static_cast<uint8_t>(TL_PROGRAM) << trafficLightId << static_cast<uint8_t>(TYPE_STRING) << program);
-	ASSERT(buf.eof());
+	traci->querySet(CMD_SET_TL_VARIABLE, TraCIBuffer() << static_cast<uint8_t>(TL_PROGRAM) << trafficLightId << static_cast<uint8_t>(TYPE_STRING) << program);
 }
 
 void TraCICommandInterface::Trafficlight::setPhaseIndex(int32_t index) {
-	TraCIBuffer buf = connection->query(CMD_SET_TL_VARIABLE, TraCIBuffer() << static_cast<uint8_t>(TL_PHASE_INDEX) << trafficLightId << static_cast<uint8_t>(TYPE_INTEGER) << index);
-	ASSERT(buf.eof());
+	traci->querySet(CMD_SET_TL_VARIABLE, TraCIBuffer() << static_cast<uint8_t>(TL_PHASE_INDEX) << trafficLightId << static_cast<uint8_t>(TYPE_INTEGER) << index);
 }
 
-std::list<std::string> TraCICommandInterface::getPolygonIds() {
-	return genericGetStringList(CMD_GET_POLYGON_VARIABLE, "", ID_LIST, RESPONSE_GET_POLYGON_VARIABLE);
+const std::list<std::string>& TraCICommandInterface::getPolygonIds() {
+	return getCachedIdList(polygonIds, CMD_GET_POLYGON_VARIABLE, RESPONSE_GET_POLYGON_VARIABLE);
 }
 
 std::string TraCICommandInterface::Polygon::getTypeId() {
@@ -232,8 +349,7 @@ void TraCICommandInterface::Polygon::setShape(const std::list<Coord>& points) {
 		const TraCICoord& pos = connection->omnet2traci(*i);
 		buf << static_cast<double>(pos.x) << static_cast<double>(pos.y);
 	}
-	TraCIBuffer obuf = connection->query(CMD_SET_POLYGON_VARIABLE, buf);
-	ASSERT(obuf.eof());
+	traci->querySet(CMD_SET_POLYGON_VARIABLE, buf);
 }
 
 void TraCICommandInterface::addPolygon(std::string polyId, std::string polyType, const TraCIColor& color, bool filled, int32_t layer, const std::list<Coord>& points) {
@@ -251,8 +367,8 @@ void TraCICommandInterface::addPolygon(std::string polyId, std::string polyType,
 		p << static_cast<double>(pos.x) << static_cast<double>(pos.y);
 	}
 
-	TraCIBuffer buf = connection.query(CMD_SET_POLYGON_VARIABLE, p);
-	ASSERT(buf.eof());
+	querySet(CMD_SET_POLYGON_VARIABLE, p);
+	polygonIds = CachedIdList();
 }
 
 void TraCICommandInterface::Polygon::remove(int32_t layer) {
@@ -261,8 +377,8 @@ void TraCICommandInterface::Polygon::remove(int32_t layer) {
 	p << static_cast<uint8_t>(REMOVE) << polyId;
 	p << static_cast<uint8_t>(TYPE_INTEGER) << layer;
 
-	TraCIBuffer buf = connection->query(CMD_SET_POLYGON_VARIABLE, p);
-	ASSERT(buf.eof());
+	traci->querySet(CMD_SET_POLYGON_VARIABLE, p);
+	traci->polygonIds = CachedIdList();
 }
 
 void TraCICommandInterface::addPoi(std::string poiId, std::string poiType, const TraCIColor& color, int32_t layer, const Coord& pos_) {
@@ -276,8 +392,7 @@ void TraCICommandInterface::addPoi(std::string poiId, std::string poiType, const
 	p << static_cast<uint8_t>(TYPE_INTEGER) << layer;
 	p << pos;
 
-	TraCIBuffer buf = connection.query(CMD_SET_POI_VARIABLE, p);
-	ASSERT(buf.eof());
+	querySet(CMD_SET_POI_VARIABLE, p);
 }
 
 void TraCICommandInterface::Poi::remove(int32_t layer) {
@@ -286,16 +401,20 @@ void TraCICommandInterface::Poi::remove(int32_t layer) {
 	p << static_cast<uint8_t>(REMOVE) << poiId;
 	p << static_cast<uint8_t>(TYPE_INTEGER) << layer;
 
-	TraCIBuffer buf = connection->query(CMD_SET_POI_VARIABLE, p);
-	ASSERT(buf.eof());
+	traci->querySet(CMD_SET_POI_VARIABLE, p);
 }
 
-std::list<std::string> TraCICommandInterface::getLaneIds() {
-	return genericGetStringList(CMD_GET_LANE_VARIABLE, "", ID_LIST, RESPONSE_GET_LANE_VARIABLE);
+const std::list<std::string>& TraCICommandInterface::getLaneIds() {
+	return getCachedIdList(laneIds, CMD_GET_LANE_VARIABLE, RESPONSE_GET_LANE_VARIABLE);
 }
 
 std::list<Coord> TraCICommandInterface::Lane::getShape() {
-	return traci->genericGetCoordList(CMD_GET_LANE_VARIABLE, laneId, VAR_SHAPE, RESPONSE_GET_LANE_VARIABLE);
+	if (!traci->cacheNetwork) return traci->genericGetCoordList(CMD_GET_LANE_VARIABLE, laneId, VAR_SHAPE, RESPONSE_GET_LANE_VARIABLE);
+
+	std::map<std::string, std::list<Coord> >::iterator i = traci->laneShapes.find(laneId);
+	if (i != traci->laneShapes.end()) return i->second;
+
+	return traci->laneShapes[laneId] = traci->genericGetCoordList(CMD_GET_LANE_VARIABLE, laneId, VAR_SHAPE, RESPONSE_GET_LANE_VARIABLE);
 }
 
 std::string TraCICommandInterface::Lane::getRoadId() {
@@ -303,10 +422,14 @@ std::string TraCICommandInterface::Lane::getRoadId() {
 }
 
 double TraCICommandInterface::Lane::getLength() {
-	return traci->genericGetDouble(CMD_GET_LANE_VARIABLE, laneId, VAR_LENGTH, RESPONSE_GET_LANE_VARIABLE);
+	std::map<std::string, double>::const_iterator i = traci->laneLengths.find(laneId);
+	if (i != traci->laneLengths.end() && traci->cacheNetwork) return i->second;
+
+	return traci->laneLengths[laneId] = traci->genericGetDouble(CMD_GET_LANE_VARIABLE, laneId, VAR_LENGTH, RESPONSE_GET_LANE_VARIABLE);
 }
 
 double TraCICommandInterface::Lane::getMaxSpeed() {
+	// not cached: speed limits can be changed at run time (e.g. by variable speed signs)
 	return traci->genericGetDouble(CMD_GET_LANE_VARIABLE, laneId, VAR_MAXSPEED, RESPONSE_GET_LANE_VARIABLE);
 }
 
@@ -314,12 +437,19 @@ double TraCICommandInterface::Lane::getMeanSpeed() {
 	return traci->genericGetDouble(CMD_GET_LANE_VARIABLE, laneId, LAST_STEP_MEAN_SPEED, RESPONSE_GET_LANE_VARIABLE);
 }
 
-std::list<std::string> TraCICommandInterface::getJunctionIds() {
-	return genericGetStringList(CMD_GET_JUNCTION_VARIABLE, "", ID_LIST, RESPONSE_GET_JUNCTION_VARIABLE);
+TraCICommandInterface::Future<double> TraCICommandInterface::Lane::getMeanSpeedAsync(Callback<double>::type callback) {
+	return traci->genericGetAsync<double>(CMD_GET_LANE_VARIABLE, laneId, LAST_STEP_MEAN_SPEED, RESPONSE_GET_LANE_VARIABLE, TYPE_DOUBLE, callback);
+}
+
+const std::list<std::string>& TraCICommandInterface::getJunctionIds() {
+	return getCachedIdList(junctionIds, CMD_GET_JUNCTION_VARIABLE, RESPONSE_GET_JUNCTION_VARIABLE);
 }
 
 Coord TraCICommandInterface::Junction::getPosition() {
-	return traci->genericGetCoord(CMD_GET_JUNCTION_VARIABLE, junctionId, VAR_POSITION, RESPONSE_GET_JUNCTION_VARIABLE);
+	std::map<std::string, Coord>::const_iterator i = traci->junctionPositions.find(junctionId);
+	if (i != traci->junctionPositions.end() && traci->cacheNetwork) return i->second;
+
+	return traci->junctionPositions[junctionId] = traci->genericGetCoord(CMD_GET_JUNCTION_VARIABLE, junctionId, VAR_POSITION, RESPONSE_GET_JUNCTION_VARIABLE);
 }
 
 bool TraCICommandInterface::addVehicle(std::string vehicleId, std::string vehicleTypeId, std::string routeId, simtime_t emitTime_st, double emitPosition, double emitSpeed, int8_t emitLane) {
@@ -418,6 +548,33 @@ void TraCICommandInterface::GuiView::takeScreenshot(std::string filename) {
 	ASSERT(buf.eof());
 }
 
+template<typename T> TraCICommandInterface::Future<T> TraCICommandInterface::genericGetAsync(uint8_t commandId, std::string objectId, uint8_t variableId, uint8_t responseId, uint8_t resultTypeId, typename Callback<T>::type callback) {
+	Future<T> result(this);
+	std::shared_ptr<typename Future<T>::State> state = result.state;
+
+	// same parsing as the synchronous genericGet* variants, but reading from the shared reply of a batch
+	connection.queryAsync(commandId, TraCIBuffer() << variableId << objectId, [state, objectId, variableId, responseId, resultTypeId, callback](TraCIBuffer& buf) {
+		uint8_t cmdLength; buf >> cmdLength;
+		if (cmdLength == 0) {
+			uint32_t cmdLengthX;
+			buf >> cmdLengthX;
+		}
+		uint8_t commandId_r; buf >> commandId_r;
+		ASSERT(commandId_r == responseId);
+		uint8_t varId; buf >> varId;
+		ASSERT(varId == variableId);
+		std::string objectId_r; buf >> objectId_r;
+		ASSERT(objectId_r == objectId);
+		uint8_t resType_r; buf >> resType_r;
+		ASSERT(resType_r == resultTypeId);
+		buf >> state->value;
+		state->ready = true;
+		if (callback) callback(state->value);
+	});
+
+	return result;
+}
+
 std::string TraCICommandInterface::genericGetString(uint8_t commandId, std::string objectId, uint8_t variableId, uint8_t responseId) {
 	uint8_t resultTypeId = TYPE_STRING;
 	std::string res;
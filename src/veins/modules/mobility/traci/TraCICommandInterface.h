@@ -2,10 +2,14 @@
 #define VEINS_MOBILITY_TRACI_TRACICOMMANDINTERFACE_H_
 
 #include <list>
+#include <map>
 #include <string>
+#include <memory>
+#include <functional>
 #include <stdint.h>
 
 #include "veins/modules/mobility/traci/TraCIColor.h"
+#include "veins/modules/mobility/traci/TraCIBuffer.h"
 #include "veins/base/utils/Coord.h"
 
 namespace Veins {
@@ -24,10 +28,67 @@ public:
 		DEPART_SPEED_MAX = 3
 	};
 
+	/**
+	 * whether set commands without a return value (e.g. addPolygon, Polygon::remove) are queued
+	 * and sent along with the next query instead of one round trip each; see TraCIConnection::queryDeferred
+	 */
+	void setDeferSetCommands(bool defer) { deferSetCommands = defer; }
+	bool getDeferSetCommands() const { return deferSetCommands; }
+	/** sends all queued commands (deferred set commands and pending asynchronous queries) in a single message */
+	void flush();
+
+	/**
+	 * result of an asynchronous query (e.g. Vehicle::getRoadIdAsync).
+	 *
+	 * Asynchronous queries are queued and sent together with the next synchronous query or flush(),
+	 * so that any number of them costs a single round trip. get() flushes the queue if the result is still pending.
+	 */
+	template<typename T> class Future
+	{
+	public:
+		Future() : traci(0) {}
+		Future(TraCICommandInterface* traci) : traci(traci), state(std::make_shared<State>()) {}
+
+		bool isReady() const { return state && state->ready; }
+		const T& get() {
+			ASSERT(state);
+			if (!state->ready) traci->flush();
+			ASSERT(state->ready);
+			return state->value;
+		}
+
+	protected:
+		friend class TraCICommandInterface;
+		struct State {
+			State() : ready(false), value() {}
+			bool ready;
+			T value;
+		};
+
+		TraCICommandInterface* traci;
+		std::shared_ptr<State> state;
+	};
+
+	/** called with the result of an asynchronous query as soon as it has been received */
+	template<typename T> struct Callback { typedef std::function<void(const T&)> type; };
+
+	/**
+	 * whether static road network data (lane shapes and lengths, junction positions, route edges
+	 * and the lane, junction and polygon id lists) is fetched once and then served from a client-side cache; on by default.
+	 * References returned for cached data stay valid until the next invalidation.
+	 */
+	void setNetworkCacheEnabled(bool enabled) { cacheNetwork = enabled; }
+	bool getNetworkCacheEnabled() const { return cacheNetwork; }
+	/** forgets all cached network data, e.g. after lanes were changed by another TraCI client */
+	void invalidateNetworkCache();
+	/** fills the network cache in bulk from a SUMO network (.net.xml); requires the network boundaries to be known */
+	void preloadNetwork(cXMLElement* net);
+
 	// General methods that do not deal with a particular object in the simulation
 	std::pair<uint32_t, std::string> getVersion();
 	std::pair<double, double> getLonLat(const Coord&);
 	double getDistance(const Coord& position1, const Coord& position2, bool returnDrivingDistance);
+	Future<double> getDistanceAsync(const Coord& position1, const Coord& position2, bool returnDrivingDistance, Callback<double>::type callback = Callback<double>::type());
 
 	// Vehicle methods
 	bool addVehicle(std::string vehicleId, std::string vehicleTypeId, std::string routeId, simtime_t emitTime_st = -DEPART_NOW, double emitPosition = -DEPART_POS_BASE, double emitSpeed = -DEPART_SPEED_MAX, int8_t emitLane = -DEPART_LANE_BEST_FREE);
@@ -54,6 +115,11 @@ public:
 		std::string getTypeId();
 		bool changeVehicleRoute(const std::list<std::string>& roads);
 
+		Future<std::string> getRoadIdAsync(Callback<std::string>::type callback = Callback<std::string>::type());
+		Future<std::string> getLaneIdAsync(Callback<std::string>::type callback = Callback<std::string>::type());
+		Future<double> getLanePositionAsync(Callback<double>::type callback = Callback<double>::type());
+		Future<int32_t> getLaneIndexAsync(Callback<int32_t>::type callback = Callback<int32_t>::type());
+
 	protected:
 		TraCICommandInterface* traci;
 		TraCIConnection* connection;
@@ -69,6 +135,8 @@ public:
 
 		double getCurrentTravelTime();
 		double getMeanSpeed();
+		Future<double> getCurrentTravelTimeAsync(Callback<double>::type callback = Callback<double>::type());
+		Future<double> getMeanSpeedAsync(Callback<double>::type callback = Callback<double>::type());
 
 	protected:
 		TraCICommandInterface* traci;
@@ -78,7 +146,7 @@ public:
 	Road road(std::string roadId) { return Road(this, roadId); }
 
 	// Lane methods
-	std::list<std::string> getLaneIds();
+	const std::list<std::string>& getLaneIds();
 	class Lane
 	{
 	public:
@@ -89,6 +157,7 @@ public:
 		double getLength();
 		double getMaxSpeed();
 		double getMeanSpeed();
+		Future<double> getMeanSpeedAsync(Callback<double>::type callback = Callback<double>::type());
 		void setLaneId(std::string _laneId) { laneId = _laneId; }
 
 	protected:
@@ -115,7 +184,7 @@ public:
 	Trafficlight trafficlight(std::string trafficLightId) { return Trafficlight(this, trafficLightId); }
 
 	// Polygon methods
-	std::list<std::string> getPolygonIds();
+	const std::list<std::string>& getPolygonIds();
 	void addPolygon(std::string polyId, std::string polyType, const TraCIColor& color, bool filled, int32_t layer, const std::list<Coord>& points);
 	class Polygon
 	{
@@ -151,7 +220,7 @@ public:
 	Poi poi(std::string poiId) { return Poi(this, poiId); }
 
 	// Junction methods
-	std::list<std::string> getJunctionIds();
+	const std::list<std::string>& getJunctionIds();
 	class Junction
 	{
 	public:
@@ -173,7 +242,7 @@ public:
 	public:
 		Route(TraCICommandInterface* traci, std::string routeId) : traci(traci), routeId(routeId) { connection = &traci->connection; }
 
-		std::list<std::string> getRoadIds();
+		const std::list<std::string>& getRoadIds();
 
 	protected:
 		TraCICommandInterface* traci;
@@ -204,7 +273,30 @@ public:
 	GuiView guiView(std::string viewId) { return GuiView(this, viewId); }
 
 private:
+	/** an id list and whether it has been fetched */
+	struct CachedIdList {
+		CachedIdList() : valid(false) {}
+		bool valid;
+		std::list<std::string> ids;
+	};
+
 	TraCIConnection& connection;
+	bool deferSetCommands;
+
+	bool cacheNetwork;
+	std::map<std::string, std::list<Coord> > laneShapes;
+	std::map<std::string, double> laneLengths;
+	std::map<std::string, Coord> junctionPositions;
+	std::map<std::string, std::list<std::string> > routeRoadIds;
+	CachedIdList laneIds;
+	CachedIdList junctionIds;
+	CachedIdList polygonIds; /**< invalidated by addPolygon and Polygon::remove */
+
+	/** returns the cached id list, fetching it first if necessary */
+	const std::list<std::string>& getCachedIdList(CachedIdList& cached, uint8_t commandId, uint8_t responseId);
+
+	/** sends a set command that has no response other than its status, queueing it if deferSetCommands is set */
+	void querySet(uint8_t commandId, const TraCIBuffer& buf);
 
 	std::string genericGetString(uint8_t commandId, std::string objectId, uint8_t variableId, uint8_t responseId);
 	Coord genericGetCoord(uint8_t commandId, std::string objectId, uint8_t variableId, uint8_t responseId);
@@ -212,6 +304,9 @@ private:
 	int32_t genericGetInt(uint8_t commandId, std::string objectId, uint8_t variableId, uint8_t responseId);
 	std::list<std::string> genericGetStringList(uint8_t commandId, std::string objectId, uint8_t variableId, uint8_t responseId);
 	std::list<Coord> genericGetCoordList(uint8_t commandId, std::string objectId, uint8_t variableId, uint8_t responseId);
+
+	/** queues a get command for a scalar variable of type T (TYPE_STRING, TYPE_DOUBLE or TYPE_INTEGER), see Future */
+	template<typename T> Future<T> genericGetAsync(uint8_t commandId, std::string objectId, uint8_t variableId, uint8_t responseId, uint8_t resultTypeId, typename Callback<T>::type callback);
 };
 
 }
@@ -1,18 +1,13 @@
-#define WANT_WINSOCK2
-#include <platdep/sockets.h>
-#if defined(_WIN32) || defined(__WIN32__) || defined(WIN32) || defined(__CYGWIN__) || defined(_WIN64)
-#include <ws2tcpip.h>
-#else
-#include <netinet/tcp.h>
-#include <netdb.h>
-#include <arpa/inet.h>
-#endif
-
 #include <algorithm>
 #include <functional>
+#include <chrono>
+#include <cstdio>
+#include <sstream>
 
 #include "veins/modules/mobility/traci/TraCIConnection.h"
 #include "veins/modules/mobility/traci/TraCIConstants.h"
+#include "veins/modules/mobility/traci/TraCITrace.h"
+#include "veins/modules/mobility/traci/TraCITransport.h"
 
 #define MYDEBUG EV
 
@@ -28,170 +23,285 @@ struct traci2omnet_functor : public std::unary_function<TraCICoord, Coord> {
 	const TraCIConnection& owner;
 };
 
-SOCKET socket(void* ptr)
-{
-	ASSERT(ptr);
-	return *static_cast<SOCKET*>(ptr);
+namespace {
+	/** returns the length of the TraCI command (or response) starting at pos */
+	size_t commandLength(const std::string& buf, size_t pos) {
+		if (pos >= buf.size()) throw cRuntimeError("Malformed TraCI message");
+		if (buf[pos] != 0) return static_cast<uint8_t>(buf[pos]);
+		if (pos + 1 + sizeof(uint32_t) > buf.size()) throw cRuntimeError("Malformed TraCI message");
+		uint32_t len; TraCIBuffer(buf.substr(pos + 1, sizeof(uint32_t))) >> len;
+		return len;
+	}
+
+	/** returns the command identifier of a TraCI command (the byte after its length field) */
+	uint8_t commandIdOf(const std::string& command) {
+		return static_cast<uint8_t>(command[0] != 0 ? command[1] : command[5]);
+	}
+
+	/** returns the commands a message consists of */
+	std::vector<std::string> splitCommands(const std::string& message) {
+		std::vector<std::string> commands;
+		for (size_t pos = 0; pos < message.size(); ) {
+			size_t len = commandLength(message, pos);
+			if (len == 0 || pos + len > message.size()) throw cRuntimeError("Malformed TraCI message");
+			commands.push_back(message.substr(pos, len));
+			pos += len;
+		}
+		return commands;
+	}
+
+	/** returns the variable and object a get or set command's content refers to, for error messages */
+	std::string describeTarget(const std::string& content) {
+		if (content.size() < 1 + sizeof(uint32_t)) return "";
+		uint32_t len; TraCIBuffer(content.substr(1, sizeof(uint32_t))) >> len;
+		if (1 + sizeof(uint32_t) + len > content.size()) return "";
+		std::ostringstream ss;
+		ss << "variable 0x" << std::hex << static_cast<int>(static_cast<uint8_t>(content[0])) << " of \"" << content.substr(1 + sizeof(uint32_t), len) << "\"";
+		return ss.str();
+	}
+
+	/** returns whether a command only reads state of the TraCI server (get commands and subscriptions) */
+	bool isQueryCommand(uint8_t commandId) {
+		return (commandId == CMD_GETVERSION) || (commandId >= 0x80 && commandId <= 0x8f) || (commandId >= 0xa0 && commandId <= 0xaf) || (commandId >= 0xd0 && commandId <= 0xdf);
+	}
+}
+
+TraCIConnection::TraCIConnection(TraCITransport* transport) : transport(transport), roundTrips(0), recorder(0), replayer(0), replayIgnored(0) {
+	ASSERT(transport);
 }
 
-TraCIConnection::TraCIConnection(void* ptr) : socketPtr(ptr) {
-	ASSERT(socketPtr);
+TraCIConnection::TraCIConnection(TraCITraceReader* replayer) : transport(0), roundTrips(0), recorder(0), replayer(replayer), replayIgnored(0) {
+	ASSERT(replayer);
 }
 
 TraCIConnection::~TraCIConnection() {
-	if (socketPtr) {
-		closesocket(socket(socketPtr));
-		delete static_cast<SOCKET*>(socketPtr);
-	}
+	delete transport;
+	delete recorder;
+	delete replayer;
 }
 
 TraCIConnection* TraCIConnection::connect(const char* host, int port) {
 	MYDEBUG << "TraCIScenarioManager connecting to TraCI server" << endl;
 
-	if (initsocketlibonce() != 0) throw cRuntimeError("Could not init socketlib");
+	return new TraCIConnection(TraCITransport::connect(host, port));
+}
 
-	in_addr addr;
-	struct hostent* host_ent;
-	struct in_addr saddr;
+TraCIConnection* TraCIConnection::replay(const char* traceFile) {
+	MYDEBUG << "TraCIScenarioManager replaying TraCI trace " << traceFile << endl;
 
-	saddr.s_addr = inet_addr(host);
-	if (saddr.s_addr != static_cast<unsigned int>(-1)) {
-		addr = saddr;
-	} else if ((host_ent = gethostbyname(host))) {
-		addr = *((struct in_addr*) host_ent->h_addr_list[0]);
-	} else {
-		throw cRuntimeError("Invalid TraCI server address: %s", host);
-		return 0;
-	}
+	TraCIConnection* connection = new TraCIConnection(new TraCITraceReader(traceFile));
+	connection->loadReplayStep();
+	return connection;
+}
 
-	sockaddr_in address;
-	memset((char*) &address, 0, sizeof(address));
-	address.sin_family = AF_INET;
-	address.sin_port = htons(port);
-	address.sin_addr.s_addr = addr.s_addr;
+void TraCIConnection::startRecording(const std::string& fileName) {
+	if (replayer) throw cRuntimeError("Cannot record a TraCI trace while replaying one");
+	delete recorder;
+	recorder = new TraCITraceWriter(fileName);
+}
 
-	SOCKET* socketPtr = new SOCKET();
-	*socketPtr = ::socket(AF_INET, SOCK_STREAM, 0);
-	if (*socketPtr < 0) throw cRuntimeError("Could not create socket to connect to TraCI server");
+TraCIBuffer TraCIConnection::query(uint8_t commandId, const TraCIBuffer& buf) {
+	TraCIBuffer obuf = exchange(makeTraCICommand(commandId, buf));
+	std::string description;
+	uint8_t result = readStatus(obuf, commandId, description);
+	if (result == RTYPE_NOTIMPLEMENTED) throw cRuntimeError("TraCI server reported command 0x%2x not implemented (\"%s\"). Might need newer version.", commandId, description.c_str());
+	if (result == RTYPE_ERR) throw cRuntimeError("TraCI server reported error executing command 0x%2x (\"%s\").", commandId, description.c_str());
+	ASSERT(result == RTYPE_OK);
+	return obuf;
+}
 
-	if (::connect(*socketPtr, (sockaddr const*) &address, sizeof(address)) < 0) {
-		throw cRuntimeError("Could not connect to TraCI server. Make sure it is running and not behind a firewall. Error message: %d: %s", sock_errno(), strerror(sock_errno()));
+TraCIBuffer TraCIConnection::queryOptional(uint8_t commandId, const TraCIBuffer& buf, bool& success, std::string* errorMsg) {
+	TraCIBuffer obuf = exchange(makeTraCICommand(commandId, buf));
+	std::string description;
+	uint8_t result = readStatus(obuf, commandId, description);
+	success = (result == RTYPE_OK);
+	if (errorMsg) *errorMsg = description;
+	return obuf;
+}
+
+void TraCIConnection::queryDeferred(uint8_t commandId, const TraCIBuffer& buf) {
+	deferredCommands += makeTraCICommand(commandId, buf);
+	DeferredCommand d;
+	d.commandId = commandId;
+	d.target = describeTarget(buf.str());
+	deferred.push_back(d);
+}
+
+void TraCIConnection::queryAsync(uint8_t commandId, const TraCIBuffer& buf, ResponseHandler handler) {
+	deferredCommands += makeTraCICommand(commandId, buf);
+	DeferredCommand d;
+	d.commandId = commandId;
+	d.target = describeTarget(buf.str());
+	d.handler = handler;
+	deferred.push_back(d);
+}
+
+void TraCIConnection::flush() {
+	if (deferred.empty()) return;
+	TraCIBuffer obuf = exchange(std::string());
+	ASSERT(obuf.eof());
+}
+
+TraCIBuffer TraCIConnection::exchange(const std::string& command) {
+	// command identifier of the trailing command, if any (the byte after its length field)
+	int commandId = -1;
+	if (!command.empty()) commandId = static_cast<uint8_t>(command[0] != 0 ? command[1] : command[5]);
+
+	if (!deferred.empty()) MYDEBUG << "Sending " << deferred.size() << " deferred TraCI commands" << endl;
+
+	// the queue is emptied before reading the reply, so an error does not leave stale commands behind
+	std::string message = deferredCommands + command;
+	std::vector<DeferredCommand> commands;
+	commands.swap(deferred);
+	deferredCommands.clear();
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::string reply;
+	if (replayer) {
+		std::vector<std::string> parts = splitCommands(message);
+		for (std::vector<std::string>::const_iterator i = parts.begin(); i != parts.end(); ++i) reply += replayReply(*i);
+	}
+	else {
+		sendMessage(message);
+		reply = receiveMessage();
+	}
+	double latency = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	++roundTrips;
+	size_t commandCount = commands.size() + (commandId >= 0 ? 1 : 0);
+	for (std::vector<DeferredCommand>::const_iterator i = commands.begin(); i != commands.end(); ++i) {
+		CommandStats& stats = commandStats[i->commandId];
+		++stats.count;
+		if (commandCount > 1) ++stats.batched;
+		stats.totalLatency += latency;
+	}
+	if (commandId >= 0) {
+		CommandStats& stats = commandStats[commandId];
+		++stats.count;
+		if (commandCount > 1) ++stats.batched;
+		stats.totalLatency += latency;
 	}
 
-	{
-		int x = 1;
-		::setsockopt(*socketPtr, IPPROTO_TCP, TCP_NODELAY, (const char*) &x, sizeof(x));
+	if (recorder) {
+		// a queued command's reply is its status plus, if it has a handler, one response; the trailing command gets the rest
+		std::vector<std::string> parts = splitCommands(message);
+		size_t pos = 0;
+		for (size_t i = 0; i < parts.size(); ++i) {
+			size_t end = reply.size();
+			if (i < commands.size()) {
+				end = pos + commandLength(reply, pos);
+				if (commands[i].handler) end += commandLength(reply, end);
+			}
+			recorder->add(parts[i], reply.substr(pos, end - pos));
+			pos = end;
+		}
 	}
 
-	return new TraCIConnection(socketPtr);
+	TraCIBuffer obuf(reply);
+	for (std::vector<DeferredCommand>::const_iterator i = commands.begin(); i != commands.end(); ++i) {
+		std::string description;
+		uint8_t result = readStatus(obuf, i->commandId, description);
+		if (result != RTYPE_OK) {
+			// deferred commands fail long after they were queued, so name both the command and the exchange that sent it
+			char sentWith[32] = "flush";
+			if (commandId >= 0) snprintf(sentWith, sizeof(sentWith), "command 0x%02x", commandId);
+			if (result == RTYPE_NOTIMPLEMENTED) throw cRuntimeError("TraCI server reported deferred command 0x%02x (%s) not implemented (\"%s\"), sent with %s. Might need newer version.", i->commandId, i->target.c_str(), description.c_str(), sentWith);
+			if (result == RTYPE_ERR) throw cRuntimeError("TraCI server reported error executing deferred command 0x%02x (%s) (\"%s\"), sent with %s.", i->commandId, i->target.c_str(), description.c_str(), sentWith);
+		}
+		ASSERT(result == RTYPE_OK);
+		if (i->handler) i->handler(obuf);
+	}
+	return obuf;
 }
 
-TraCIBuffer TraCIConnection::query(uint8_t commandId, const TraCIBuffer& buf) {
-	sendMessage(makeTraCICommand(commandId, buf));
+std::string TraCIConnection::replayReply(const std::string& command) {
+	uint8_t commandId = commandIdOf(command);
 
-	TraCIBuffer obuf(receiveMessage());
-	uint8_t cmdLength; obuf >> cmdLength;
-	uint8_t commandResp; obuf >> commandResp;
-	ASSERT(commandResp == commandId);
-	uint8_t result; obuf >> result;
-	std::string description; obuf >> description;
-	if (result == RTYPE_NOTIMPLEMENTED) throw cRuntimeError("TraCI server reported command 0x%2x not implemented (\"%s\"). Might need newer version.", commandId, description.c_str());
-	if (result == RTYPE_ERR) throw cRuntimeError("TraCI server reported error executing command 0x%2x (\"%s\").", commandId, description.c_str());
-	ASSERT(result == RTYPE_OK);
-	return obuf;
+	if (commandId == CMD_SIMSTEP2) {
+		if (replayStepCommand.empty()) throw cRuntimeError("End of TraCI trace reached");
+		if (command != replayStepCommand) throw cRuntimeError("TraCI trace was recorded with different time steps");
+		std::string reply = replayStepReply;
+		loadReplayStep();
+		return reply;
+	}
+
+	if (isQueryCommand(commandId)) {
+		std::map<std::string, std::deque<std::string> >::iterator i = replayReplies.find(command);
+		if (i == replayReplies.end()) throw cRuntimeError("TraCI command 0x%02x was not sent in this time step when the trace was recorded, so it cannot be replayed", commandId);
+		// identical queries of one time step are answered in recorded order, the last reply is repeated
+		std::string reply = i->second.front();
+		if (i->second.size() > 1) i->second.pop_front();
+		return reply;
+	}
+
+	// anything else would change the traffic, which the trace cannot follow
+	if (commandId != CMD_CLOSE) {
+		++replayIgnored;
+		EV_WARN << "Ignoring TraCI command 0x" << std::hex << static_cast<int>(commandId) << std::dec << " while replaying a trace" << endl;
+	}
+	TraCIBuffer status;
+	status << static_cast<uint8_t>(sizeof(uint8_t) + sizeof(uint8_t) + sizeof(uint8_t) + sizeof(uint32_t)) << commandId << static_cast<uint8_t>(RTYPE_OK) << std::string();
+	return status.str();
 }
 
-TraCIBuffer TraCIConnection::queryOptional(uint8_t commandId, const TraCIBuffer& buf, bool& success, std::string* errorMsg) {
-	sendMessage(makeTraCICommand(commandId, buf));
+void TraCIConnection::loadReplayStep() {
+	replayReplies.clear();
+	replayStepCommand.clear();
+	replayStepReply.clear();
+
+	std::string command;
+	std::string reply;
+	while (replayer->next(command, reply)) {
+		if (commandIdOf(command) == CMD_SIMSTEP2) {
+			replayStepCommand = command;
+			replayStepReply = reply;
+			return;
+		}
+		replayReplies[command].push_back(reply);
+	}
+}
 
-	TraCIBuffer obuf(receiveMessage());
+uint8_t TraCIConnection::readStatus(TraCIBuffer& obuf, uint8_t commandId, std::string& description) {
 	uint8_t cmdLength; obuf >> cmdLength;
+	if (cmdLength == 0) {
+		uint32_t cmdLengthX;
+		obuf >> cmdLengthX;
+	}
 	uint8_t commandResp; obuf >> commandResp;
 	ASSERT(commandResp == commandId);
 	uint8_t result; obuf >> result;
-	std::string description; obuf >> description;
-	success = (result == RTYPE_OK);
-	if (errorMsg) *errorMsg = description;
-	return obuf;
+	obuf >> description;
+	return result;
 }
 
 std::string TraCIConnection::receiveMessage() {
-	if (!socketPtr) throw cRuntimeError("Not connected to TraCI server");
+	if (!transport) throw cRuntimeError("Not connected to TraCI server");
 
 	uint32_t msgLength;
 	{
 		char buf2[sizeof(uint32_t)];
-		uint32_t bytesRead = 0;
-		while (bytesRead < sizeof(uint32_t)) {
-			int receivedBytes = ::recv(socket(socketPtr), reinterpret_cast<char*>(&buf2) + bytesRead, sizeof(uint32_t) - bytesRead, 0);
-			if (receivedBytes > 0) {
-				bytesRead += receivedBytes;
-			} else if (receivedBytes == 0) {
-				throw cRuntimeError("Connection to TraCI server closed unexpectedly. Check your server's log");
-			} else {
-				if (sock_errno() == EINTR) continue;
-				if (sock_errno() == EAGAIN) continue;
-				throw cRuntimeError("Connection to TraCI server lost. Check your server's log. Error message: %d: %s", sock_errno(), strerror(sock_errno()));
-			}
-		}
+		transport->receive(buf2, sizeof(uint32_t));
 		TraCIBuffer(std::string(buf2, sizeof(uint32_t))) >> msgLength;
 	}
 
 	uint32_t bufLength = msgLength - sizeof(msgLength);
-	char buf[bufLength];
-	{
-		MYDEBUG << "Reading TraCI message of " << bufLength << " bytes" << endl;
-		uint32_t bytesRead = 0;
-		while (bytesRead < bufLength) {
-			int receivedBytes = ::recv(socket(socketPtr), reinterpret_cast<char*>(&buf) + bytesRead, bufLength - bytesRead, 0);
-			if (receivedBytes > 0) {
-				bytesRead += receivedBytes;
-			} else if (receivedBytes == 0) {
-				throw cRuntimeError("Connection to TraCI server closed unexpectedly. Check your server's log");
-			} else {
-				if (sock_errno() == EINTR) continue;
-				if (sock_errno() == EAGAIN) continue;
-				throw cRuntimeError("Connection to TraCI server lost. Check your server's log. Error message: %d: %s", sock_errno(), strerror(sock_errno()));
-			}
-		}
-	}
-	return std::string(buf, bufLength);
+	std::string buf(bufLength, '\0');
+	MYDEBUG << "Reading TraCI message of " << bufLength << " bytes" << endl;
+	if (bufLength > 0) transport->receive(&buf[0], bufLength);
+	return buf;
 }
 
 void TraCIConnection::sendMessage(std::string buf) {
-	if (!socketPtr) throw cRuntimeError("Not connected to TraCI server");
+	if (!transport) throw cRuntimeError("Not connected to TraCI server");
 
-	{
-		uint32_t msgLength = sizeof(uint32_t) + buf.length();
-		TraCIBuffer buf2 = TraCIBuffer();
-		buf2 << msgLength;
-		uint32_t bytesWritten = 0;
-		while (bytesWritten < sizeof(uint32_t)) {
-			size_t sentBytes = ::send(socket(socketPtr), buf2.str().c_str() + bytesWritten, sizeof(uint32_t) - bytesWritten, 0);
-			if (sentBytes > 0) {
-				bytesWritten += sentBytes;
-			} else {
-				if (sock_errno() == EINTR) continue;
-				if (sock_errno() == EAGAIN) continue;
-				throw cRuntimeError("Connection to TraCI server lost. Check your server's log. Error message: %d: %s", sock_errno(), strerror(sock_errno()));
-			}
-		}
-	}
+	// header and payload go out together, so that each message is a single write on the transport
+	uint32_t msgLength = sizeof(uint32_t) + buf.length();
+	TraCIBuffer buf2 = TraCIBuffer();
+	buf2 << msgLength;
+	std::string message = buf2.str() + buf;
 
-	{
-		MYDEBUG << "Writing TraCI message of " << buf.length() << " bytes" << endl;
-		uint32_t bytesWritten = 0;
-		while (bytesWritten < buf.length()) {
-			size_t sentBytes = ::send(socket(socketPtr), buf.c_str() + bytesWritten, buf.length() - bytesWritten, 0);
-			if (sentBytes > 0) {
-				bytesWritten += sentBytes;
-			} else {
-				if (sock_errno() == EINTR) continue;
-				if (sock_errno() == EAGAIN) continue;
-				throw cRuntimeError("Connection to TraCI server lost. Check your server's log. Error message: %d: %s", sock_errno(), strerror(sock_errno()));
-			}
-		}
-	}
+	MYDEBUG << "Writing TraCI message of " << buf.length() << " bytes" << endl;
+	transport->send(message.data(), message.size());
 }
 
 std::string makeTraCICommand(uint8_t commandId, const TraCIBuffer& buf) {
@@ -2,16 +2,65 @@
 #define VEINS_MOBILITY_TRACI_TRACICONNECTION_H_
 
 #include <stdint.h>
+#include <vector>
+#include <map>
+#include <deque>
+#include <functional>
 #include "veins/modules/mobility/traci/TraCIBuffer.h"
 #include "veins/modules/mobility/traci/TraCICoord.h"
 #include "veins/base/utils/Coord.h"
 
 namespace Veins {
 
+class TraCITraceWriter;
+class TraCITraceReader;
+class TraCITransport;
+
 class TraCIConnection
 {
 	public:
+		/**
+		 * parses the response of a queued command from the reply buffer (positioned just after its status response)
+		 */
+		typedef std::function<void(TraCIBuffer&)> ResponseHandler;
+
+		/**
+		 * round trip statistics of one command type
+		 */
+		struct CommandStats {
+			CommandStats() : count(0), batched(0), totalLatency(0) {}
+			uint64_t count; /**< number of commands sent */
+			uint64_t batched; /**< number of commands that shared their message with other commands */
+			double totalLatency; /**< summed wall clock time of the round trips that carried the commands (in s) */
+		};
+
+		/**
+		 * connects to a TraCI server, see TraCITransport::connect for the transports host can select
+		 */
 		static TraCIConnection* connect(const char* host, int port);
+
+		/**
+		 * returns a connection that answers from a trace written by startRecording instead of a TraCI server.
+		 * Queries are answered with the replies recorded in the same time step, commands that would change
+		 * the traffic are logged and acknowledged without effect
+		 */
+		static TraCIConnection* replay(const char* traceFile);
+
+		/**
+		 * writes all subsequent commands and their replies to the given trace file
+		 */
+		void startRecording(const std::string& fileName);
+
+		/**
+		 * returns whether the connection replays a trace
+		 */
+		bool isReplaying() const { return replayer != 0; }
+
+		/**
+		 * returns the number of commands dropped because they would have changed the traffic of a replayed trace
+		 */
+		uint64_t getReplayIgnoredCount() const { return replayIgnored; }
+
 		void setNetbounds(TraCICoord netbounds1, TraCICoord netbounds2, int margin);
 		~TraCIConnection();
 
@@ -25,6 +74,38 @@ class TraCIConnection
 		 */
 		TraCIBuffer queryOptional(uint8_t commandId, const TraCIBuffer& buf, bool& success, std::string* errorMsg = 0);
 
+		/**
+		 * queues a single command that has no response other than its status.
+		 * Queued commands are sent in the same message as the next query, or by flush()
+		 */
+		void queryDeferred(uint8_t commandId, const TraCIBuffer& buf = TraCIBuffer());
+
+		/**
+		 * queues a single command with one response (e.g. a get command).
+		 * Like queryDeferred, but once the reply arrives the handler is called to read the response
+		 */
+		void queryAsync(uint8_t commandId, const TraCIBuffer& buf, ResponseHandler handler);
+
+		/**
+		 * sends all queued commands in a single message, checks their status responses and delivers their responses
+		 */
+		void flush();
+
+		/**
+		 * returns the number of commands queued by queryDeferred or queryAsync that have not been sent yet
+		 */
+		size_t getDeferredCount() const { return deferred.size(); }
+
+		/**
+		 * returns the round trip statistics of the given command type
+		 */
+		const CommandStats& getCommandStats(uint8_t commandId) const { return commandStats[commandId]; }
+
+		/**
+		 * returns the number of messages exchanged with the TraCI server
+		 */
+		uint64_t getRoundTripCount() const { return roundTrips; }
+
 		/**
 		 * sends a message via TraCI (after adding the header)
 		 */
@@ -58,9 +139,47 @@ class TraCIConnection
 		std::list<TraCICoord> omnet2traci(const std::list<Coord>&) const;
 
 	private:
-		TraCIConnection(void*);
+		TraCIConnection(TraCITransport*);
+		TraCIConnection(TraCITraceReader*);
+
+		/**
+		 * sends the queued commands followed by the given one (if not empty) in a single message,
+		 * checks the status responses of all queued commands and returns the remaining reply
+		 */
+		TraCIBuffer exchange(const std::string& command);
+
+		/**
+		 * reads a status response for commandId from buf
+		 */
+		uint8_t readStatus(TraCIBuffer& buf, uint8_t commandId, std::string& description);
+
+		/**
+		 * returns the recorded reply to a single command when replaying a trace
+		 */
+		std::string replayReply(const std::string& command);
 
-		void* socketPtr;
+		/**
+		 * reads the trace up to the next time step, making its commands available to replayReply
+		 */
+		void loadReplayStep();
+
+		struct DeferredCommand {
+			uint8_t commandId;
+			std::string target; /* variable and object the command refers to, for error messages */
+			ResponseHandler handler; /* empty if the command has no response besides its status */
+		};
+
+		TraCITransport* transport; /* connection to the TraCI server, 0 when replaying */
+		std::string deferredCommands; /* commands queued by queryDeferred and queryAsync */
+		std::vector<DeferredCommand> deferred; /* the queued commands, in order */
+		CommandStats commandStats[256]; /* statistics by command identifier */
+		uint64_t roundTrips; /* number of messages exchanged */
+		TraCITraceWriter* recorder; /* trace being written, if any */
+		TraCITraceReader* replayer; /* trace being replayed instead of talking to a server, if any */
+		std::map<std::string, std::deque<std::string> > replayReplies; /* recorded replies of the current time step by command */
+		std::string replayStepCommand; /* next time step command of the replayed trace, empty at its end */
+		std::string replayStepReply; /* recorded reply to replayStepCommand */
+		uint64_t replayIgnored; /* number of commands not replayed */
 		TraCICoord netbounds1; /* network boundaries as reported by TraCI (x1, y1) */
 		TraCICoord netbounds2; /* network boundaries as reported by TraCI (x2, y2) */
 		int margin;
@@ -23,6 +23,7 @@
 #include <sstream>
 
 #include "veins/modules/mobility/traci/TraCIMobility.h"
+#include "veins/base/connectionManager/BaseConnectionManager.h"
 
 using Veins::TraCIMobility;
 
@@ -73,6 +74,13 @@ void TraCIMobility::initialize(int stage)
 		BaseMobility::initialize(stage);
 
 		antennaPositionOffset = par("antennaPositionOffset").doubleValue();
+		positionTolerance = par("positionTolerance").doubleValue();
+		BaseConnectionManager* cc = FindModule<BaseConnectionManager*>::findGlobalModule();
+		maxDrift = cc ? cc->getConnectionSlack() / 8 : 0;
+		// without slack the connections are exact; let them lag behind by the tolerance already accepted for positions
+		if (maxDrift <= 0) maxDrift = positionTolerance;
+		statsUpdatesPublished = 0;
+		statsUpdatesExtrapolated = 0;
 
 		currentPosXVec.setName("posx");
 		currentPosYVec.setName("posy");
@@ -118,12 +126,28 @@ void TraCIMobility::finish()
 	statistics.stopTime = simTime();
 
 	// statistics.recordScalars(*this);
+	if (positionTolerance > 0)
+	{
+		recordScalar("positionUpdatesPublished", statsUpdatesPublished);
+		recordScalar("positionUpdatesExtrapolated", statsUpdatesExtrapolated);
+	}
 
 	isPreInitialized = false;
 
 	BaseModule::finish();
 }
 
+void TraCIMobility::recycle()
+{
+	delete vehicleCommandInterface;
+	vehicleCommandInterface = 0;
+}
+
+void TraCIMobility::reinitialize(int stage)
+{
+	initialize(stage);
+}
+
 void TraCIMobility::preInitialize(std::string external_id, const Coord& position, std::string road_id, double speed, double angle)
 {
 	commandInterface = getManager()->getCommandInterface();
@@ -179,6 +203,14 @@ void TraCIMobility::updatePosition()
 	Coord nextPos = calculateAntennaPosition(roadPosition);
 	nextPos.z = move.getCurrentPosition().z;
 
+	// leave the position to the extrapolation of the last published one, if close enough
+	if ((positionTolerance > 0) && (statistics.startTime != simTime()) && !needsPublishing(nextPos))
+	{
+		statsUpdatesExtrapolated++;
+		return;
+	}
+	statsUpdatesPublished++;
+
 	// keep statistics (relative to last step)
 	if (statistics.startTime != simTime()) {
 		simtime_t updateInterval = simTime() - this->lastUpdate;
@@ -215,6 +247,17 @@ void TraCIMobility::updatePosition()
 	BaseMobility::updatePosition();
 }
 
+bool TraCIMobility::needsPublishing(const Coord& nextPos) const
+{
+	Coord extrapolated = move.getPositionAt(simTime());
+	if (extrapolated.distance(nextPos) > positionTolerance) return true;
+
+	// connections of the connection manager follow published positions, they only cover drifting this far
+	if (extrapolated.distance(move.getStartPos()) > maxDrift) return true;
+
+	return false;
+}
+
 void TraCIMobility::changeParkingState(bool newState)
 {
 	isParking = newState;
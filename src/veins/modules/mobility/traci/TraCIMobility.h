@@ -29,6 +29,7 @@
 #include <stdexcept>
 
 #include "veins/base/modules/BaseMobility.h"
+#include "veins/base/modules/RecyclableModule.h"
 #include "veins/base/utils/FindModule.h"
 #include "veins/modules/mobility/traci/TraCIScenarioManager.h"
 #include "veins/modules/mobility/traci/TraCICommandInterface.h"
@@ -50,7 +51,7 @@
  * @ingroup mobility
  */
 namespace Veins {
-class TraCIMobility : public BaseMobility
+class TraCIMobility : public BaseMobility, public RecyclableModule
 {
 public:
 	class Statistics
@@ -76,6 +77,11 @@ public:
 	virtual void initialize(int) override;
 	virtual void finish() override;
 
+	/** releases the per-vehicle command interface created by preInitialize() */
+	virtual void recycle() override;
+	/** re-runs initialize(), preInitialize() must have been called for the new vehicle first */
+	virtual void reinitialize(int stage) override;
+
 	virtual void updatePosition() override;
 
 	void preInitialize(std::string external_id, const Coord& position, std::string road_id = "", double speed = -1, double angle = -1);
@@ -85,6 +91,8 @@ public:
 
 	double getAntennaPositionOffset() const { return antennaPositionOffset; }
 	Coord getPositionAt(const simtime_t& t) const { return move.getPositionAt(t); }
+	/** returns the last published position, or its linear extrapolation to now if positionTolerance is set */
+	virtual Coord getCurrentPosition() const override { return (positionTolerance > 0) ? move.getPositionAt(simTime()) : move.getStartPos(); }
 	bool getParkingState() const { return isParking; }
 	bool getAtIntersection() const { return atIntersection; }
 	std::string getRoadId() const
@@ -138,6 +146,10 @@ private:
 	bool isPreInitialized; /**< true if preInitialize() has been called immediately before initialize() */
 
 	double antennaPositionOffset; /**< front offset for the antenna on this car */
+	double positionTolerance; /**< how far a reported position may deviate from the extrapolated one before it is published (0: publish every update) */
+	double maxDrift; /**< how far the extrapolated position may move away from the published one before it is published (an eighth of the connection manager's connectionSlack, or positionTolerance if there is no slack) */
+	long statsUpdatesPublished; /**< number of position updates published */
+	long statsUpdatesExtrapolated; /**< number of position updates covered by extrapolation instead */
 
 	simtime_t lastUpdate; /**< updated by nextPosition() */
 	Coord roadPosition; /**< position of front bumper, updated by nextPosition() */
@@ -169,6 +181,9 @@ private:
 	 */
 	double calculateCO2emission(double v, double a) const;
 
+	/** returns whether a reported antenna position needs to be published or is close enough to the extrapolation of the last published one */
+	bool needsPublishing(const Coord& nextPos) const;
+
 	/** Calculates where the antenna of this car is, given its front bumper position. */
 	Coord calculateAntennaPosition(const Coord& vehiclePos) const;
 };
@@ -0,0 +1,143 @@
+//
+// Copyright (C) 2018 Xu Le <xmutongxinXuLe@163.com>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include <cmath>
+#include <algorithm>
+
+#include "veins/modules/mobility/traci/TraCIRegionOfInterest.h"
+
+namespace Veins {
+
+void TraCIRegionOfInterest::clear() {
+	roads.clear();
+	rectangles.clear();
+	indexValid = false;
+}
+
+void TraCIRegionOfInterest::addRoad(const std::string& roadId) {
+	roads.insert(roadId);
+}
+
+void TraCIRegionOfInterest::addRectangle(const TraCICoord& corner1, const TraCICoord& corner2) {
+	rectangles.push_back(Rectangle(TraCICoord(std::min(corner1.x, corner2.x), std::min(corner1.y, corner2.y)), TraCICoord(std::max(corner1.x, corner2.x), std::max(corner1.y, corner2.y))));
+	indexValid = false;
+}
+
+void TraCIRegionOfInterest::buildIndex() const {
+	indexValid = true;
+	cells.clear();
+	if (rectangles.empty()) return;
+
+	bounds = rectangles.front();
+	for (std::vector<Rectangle>::const_iterator i = rectangles.begin(); i != rectangles.end(); ++i) {
+		bounds.first.x = std::min(bounds.first.x, i->first.x);
+		bounds.first.y = std::min(bounds.first.y, i->first.y);
+		bounds.second.x = std::max(bounds.second.x, i->second.x);
+		bounds.second.y = std::max(bounds.second.y, i->second.y);
+	}
+
+	// about one rectangle per cell
+	columns = rows = std::max<size_t>(1, static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(rectangles.size())))));
+	cellWidth = std::max((bounds.second.x - bounds.first.x) / columns, 1e-9);
+	cellHeight = std::max((bounds.second.y - bounds.first.y) / rows, 1e-9);
+	cells.resize(columns * rows);
+
+	for (size_t i = 0; i < rectangles.size(); ++i) {
+		size_t column1, row1, column2, row2;
+		cellRange(rectangles[i], column1, row1, column2, row2);
+		for (size_t row = row1; row <= row2; ++row) {
+			for (size_t column = column1; column <= column2; ++column) {
+				cells[row * columns + column].push_back(i);
+			}
+		}
+	}
+}
+
+bool TraCIRegionOfInterest::cellRange(const Rectangle& box, size_t& column1, size_t& row1, size_t& column2, size_t& row2) const {
+	if (box.second.x < bounds.first.x || box.first.x > bounds.second.x || box.second.y < bounds.first.y || box.first.y > bounds.second.y) return false;
+	column1 = std::min(columns - 1, static_cast<size_t>(std::max(0.0, (box.first.x - bounds.first.x) / cellWidth)));
+	row1 = std::min(rows - 1, static_cast<size_t>(std::max(0.0, (box.first.y - bounds.first.y) / cellHeight)));
+	column2 = std::min(columns - 1, static_cast<size_t>(std::max(0.0, (box.second.x - bounds.first.x) / cellWidth)));
+	row2 = std::min(rows - 1, static_cast<size_t>(std::max(0.0, (box.second.y - bounds.first.y) / cellHeight)));
+	return true;
+}
+
+bool TraCIRegionOfInterest::inRectangles(const TraCICoord& position) const {
+	if (rectangles.empty()) return false;
+	if (!indexValid) buildIndex();
+
+	size_t column, row, column2, row2;
+	if (!cellRange(Rectangle(position, position), column, row, column2, row2)) return false;
+	const std::vector<size_t>& cell = cells[row * columns + column];
+	for (std::vector<size_t>::const_iterator i = cell.begin(); i != cell.end(); ++i) {
+		const Rectangle& r = rectangles[*i];
+		if ((position.x >= r.first.x) && (position.y >= r.first.y) && (position.x <= r.second.x) && (position.y <= r.second.y)) return true;
+	}
+	return false;
+}
+
+bool TraCIRegionOfInterest::segmentIntersects(const TraCICoord& a, const TraCICoord& b, const Rectangle& r) const {
+	// Liang-Barsky clipping of a + t * (b - a), t in [0, 1]
+	double t0 = 0;
+	double t1 = 1;
+	double d[2] = {b.x - a.x, b.y - a.y};
+	double lower[2] = {r.first.x - a.x, r.first.y - a.y};
+	double upper[2] = {r.second.x - a.x, r.second.y - a.y};
+	for (int axis = 0; axis < 2; ++axis) {
+		if (d[axis] == 0) {
+			if (lower[axis] > 0 || upper[axis] < 0) return false;
+			continue;
+		}
+		double ta = lower[axis] / d[axis];
+		double tb = upper[axis] / d[axis];
+		if (ta > tb) std::swap(ta, tb);
+		t0 = std::max(t0, ta);
+		t1 = std::min(t1, tb);
+		if (t0 > t1) return false;
+	}
+	return true;
+}
+
+bool TraCIRegionOfInterest::intersectsRectangles(const std::list<TraCICoord>& shape) const {
+	if (rectangles.empty() || shape.empty()) return false;
+	if (!indexValid) buildIndex();
+
+	std::list<TraCICoord>::const_iterator next = shape.begin();
+	std::list<TraCICoord>::const_iterator current = next++;
+	if (next == shape.end()) return inRectangles(*current);
+
+	for (; next != shape.end(); current = next++) {
+		Rectangle box(TraCICoord(std::min(current->x, next->x), std::min(current->y, next->y)), TraCICoord(std::max(current->x, next->x), std::max(current->y, next->y)));
+		size_t column1, row1, column2, row2;
+		if (!cellRange(box, column1, row1, column2, row2)) continue;
+		for (size_t row = row1; row <= row2; ++row) {
+			for (size_t column = column1; column <= column2; ++column) {
+				const std::vector<size_t>& cell = cells[row * columns + column];
+				for (std::vector<size_t>::const_iterator i = cell.begin(); i != cell.end(); ++i) {
+					if (segmentIntersects(*current, *next, rectangles[*i])) return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+}
@@ -0,0 +1,88 @@
+//
+// Copyright (C) 2018 Xu Le <xmutongxinXuLe@163.com>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#ifndef VEINS_MOBILITY_TRACI_TRACIREGIONOFINTEREST_H_
+#define VEINS_MOBILITY_TRACI_TRACIREGIONOFINTEREST_H_
+
+#include <set>
+#include <list>
+#include <vector>
+#include <string>
+#include <utility>
+
+#include "veins/modules/mobility/traci/TraCICoord.h"
+
+namespace Veins {
+
+/**
+ * region of interest of a TraCIScenarioManager: a set of roads and a set of rectangles (in TraCI coordinates).
+ *
+ * Rectangles are indexed by a uniform grid over their bounding box, so that membership tests stay cheap for many rectangles.
+ */
+class TraCIRegionOfInterest
+{
+	public:
+		TraCIRegionOfInterest() : indexValid(false), columns(0), rows(0), cellWidth(0), cellHeight(0) {}
+
+		void clear();
+		void addRoad(const std::string& roadId);
+		void addRectangle(const TraCICoord& corner1, const TraCICoord& corner2);
+
+		/** returns whether the region is restricted at all (if not, everything is inside) */
+		bool hasConstraints() const { return !roads.empty() || !rectangles.empty(); }
+
+		const std::set<std::string>& getRoads() const { return roads; }
+		bool hasRectangles() const { return !rectangles.empty(); }
+
+		bool onRoads(const std::string& roadId) const { return roads.find(roadId) != roads.end(); }
+		bool inRectangles(const TraCICoord& position) const;
+
+		/** returns whether any point of the polyline (e.g. a lane shape) lies within one of the rectangles */
+		bool intersectsRectangles(const std::list<TraCICoord>& shape) const;
+
+		/** returns whether a vehicle at this position on this road is inside the region */
+		bool isInside(const TraCICoord& position, const std::string& roadId) const {
+			return !hasConstraints() || onRoads(roadId) || inRectangles(position);
+		}
+
+	protected:
+		typedef std::pair<TraCICoord, TraCICoord> Rectangle; /**< lower left and upper right corner */
+
+		void buildIndex() const;
+		/** returns the cell range (inclusive) covered by the given bounding box, false if it misses the grid */
+		bool cellRange(const Rectangle& box, size_t& column1, size_t& row1, size_t& column2, size_t& row2) const;
+		bool segmentIntersects(const TraCICoord& a, const TraCICoord& b, const Rectangle& r) const;
+
+		std::set<std::string> roads;
+		std::vector<Rectangle> rectangles;
+
+		mutable bool indexValid;
+		mutable Rectangle bounds; /**< bounding box of all rectangles */
+		mutable size_t columns;
+		mutable size_t rows;
+		mutable double cellWidth;
+		mutable double cellHeight;
+		mutable std::vector<std::vector<size_t> > cells; /**< indices of the rectangles overlapping each cell, row by row */
+};
+
+}
+
+#endif /* VEINS_MOBILITY_TRACI_TRACIREGIONOFINTEREST_H_ */
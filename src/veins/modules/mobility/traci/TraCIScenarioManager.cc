@@ -22,6 +22,7 @@
 #include <vector>
 #include <algorithm>
 #include <stdexcept>
+#include <chrono>
 
 #include "veins/modules/mobility/traci/TraCIScenarioManager.h"
 #include "veins/modules/mobility/traci/TraCICommandInterface.h"
@@ -29,6 +30,8 @@
 #include "veins/modules/mobility/traci/TraCIMobility.h"
 #include "veins/modules/obstacle/ObstacleControl.h"
 #include "veins/modules/mobility/traci/TraCIScenarioManagerInet.h"
+#include "veins/base/utils/StartupProfiler.h"
+#include "veins/base/modules/RecyclableModule.h"
 
 using Veins::TraCIScenarioManager;
 using Veins::TraCIBuffer;
@@ -36,6 +39,28 @@ using Veins::TraCICoord;
 
 Define_Module(Veins::TraCIScenarioManager);
 
+namespace {
+	/** appends mod and all its submodules to modules, parents before children (the order of callInitialize) */
+	void collectModules(cModule* mod, std::vector<cModule*>& modules)
+	{
+		modules.push_back(mod);
+		for (cModule::SubmoduleIterator iter(mod); !iter.end(); iter++)
+		{
+			collectModules(SUBMODULE_ITERATOR_TO_MODULE(iter), modules);
+		}
+	}
+
+	/** returns whether mod is host or one of its (direct or indirect) submodules */
+	bool isInside(const cModule* mod, const cModule* host)
+	{
+		for (; mod; mod = mod->getParentModule())
+		{
+			if (mod == host) return true;
+		}
+		return false;
+	}
+}
+
 TraCIScenarioManager::TraCIScenarioManager() : myAddVehicleTimer(0), mobRng(0), connection(0), connectAndStartTrigger(0), executeOneTimestepTrigger(0), world(0), cc(0)
 {
 }
@@ -175,6 +200,7 @@ void TraCIScenarioManager::parseModuleTypes()
 
 void TraCIScenarioManager::initialize(int stage)
 {
+	Veins::StartupProfiler::Scope profilerScope(getClassName(), "initialize", stage);
 	cSimpleModule::initialize(stage);
 
 	if (stage == 0)
@@ -204,16 +230,16 @@ void TraCIScenarioManager::initialize(int stage)
 	myAddVehicleTimer = new cMessage("myAddVehicleTimer");
 
 	// parse roiRoads
-	roiRoads.clear();
+	roi.clear();
 	std::istringstream roiRoads_i(roiRoads_s);
 	std::string road;
 	while (std::getline(roiRoads_i, road, ' '))
 	{
-		roiRoads.push_back(road);
+		if (road.empty()) continue;
+		roi.addRoad(road);
 	}
 
 	// parse roiRects
-	roiRects.clear();
 	std::istringstream roiRects_i(roiRects_s);
 	std::string rect;
 	while (std::getline(roiRects_i, rect, ' '))
@@ -226,11 +252,23 @@ void TraCIScenarioManager::initialize(int stage)
 		double x2; rect_i >> x2; ASSERT(rect_i);
 		char c3; rect_i >> c3; ASSERT(rect_i);
 		double y2; rect_i >> y2; ASSERT(rect_i);
-		roiRects.push_back(std::pair<TraCICoord, TraCICoord>(TraCICoord(x1, y1), TraCICoord(x2, y2)));
+		roi.addRectangle(TraCICoord(x1, y1), TraCICoord(x2, y2));
 	}
+	roiSubscriptions = par("roiSubscriptions").boolValue() && roi.hasConstraints();
+	roiVehicles.clear();
+	statsVehicleUpdates = 0;
+	statsVehicleUpdateBytes = 0;
+	statsVehicleUpdatesOutsideRoi = 0;
+	statsVehicleUpdatesAvoided = 0;
 
 	nextNodeVectorIndex = 0;
 	hosts.clear();
+	moduleRecyclingPoolSize = par("moduleRecyclingPoolSize").longValue();
+	modulePool.clear();
+	statsModulesCreated = 0;
+	statsModulesRecycled = 0;
+	statsCreateTime = 0;
+	statsRecycleTime = 0;
 	subscribedVehicles.clear();
 	activeVehicleCount = 0;
 	parkingVehicleCount = 0;
@@ -258,11 +296,58 @@ void TraCIScenarioManager::finish()
 	if (connection)
 	{
 		TraCIBuffer buf = connection->query(CMD_CLOSE, TraCIBuffer());
+
+		recordScalar("traciRoundTrips", connection->getRoundTripCount());
+		if (connection->isReplaying()) recordScalar("traciReplayIgnoredCommands", connection->getReplayIgnoredCount());
+		for (int commandId = 0; commandId < 256; ++commandId)
+		{
+			const TraCIConnection::CommandStats& stats = connection->getCommandStats(commandId);
+			if (stats.count == 0) continue;
+			char name[64];
+			snprintf(name, sizeof(name), "traciCommandCount_0x%02x", commandId);
+			recordScalar(name, stats.count);
+			snprintf(name, sizeof(name), "traciCommandBatched_0x%02x", commandId);
+			recordScalar(name, stats.batched);
+			snprintf(name, sizeof(name), "traciCommandLatency_0x%02x", commandId);
+			recordScalar(name, stats.totalLatency / stats.count, "s");
+		}
+	}
+
+	recordScalar("vehicleUpdates", statsVehicleUpdates);
+	recordScalar("vehicleUpdateBytes", statsVehicleUpdateBytes);
+	if (roi.hasConstraints())
+	{
+		recordScalar("vehicleUpdatesOutsideRoi", statsVehicleUpdatesOutsideRoi);
+		if (roiSubscriptions)
+		{
+			// bytes are estimated from the mean size of the vehicle updates actually received
+			recordScalar("vehicleUpdatesAvoided", statsVehicleUpdatesAvoided);
+			recordScalar("vehicleUpdateBytesAvoided", statsVehicleUpdates ? statsVehicleUpdatesAvoided * (static_cast<double>(statsVehicleUpdateBytes) / statsVehicleUpdates) : 0);
+		}
 	}
+
+	recordScalar("modulesCreated", statsModulesCreated);
+	recordScalar("modulesRecycled", statsModulesRecycled);
+	if (statsModulesCreated > 0) recordScalar("moduleCreateTime", statsCreateTime / statsModulesCreated, "s");
+	if (statsModulesRecycled > 0) recordScalar("moduleRecycleTime", statsRecycleTime / statsModulesRecycled, "s");
+
+	// nothing left to reuse parked hosts for
+	moduleRecyclingPoolSize = 0;
 	while (hosts.begin() != hosts.end())
 	{
 		deleteManagedModule(hosts.begin()->first);
 	}
+	for (std::map<std::pair<cModuleType*, std::string>, std::list<cModule*> >::iterator i = modulePool.begin(); i != modulePool.end(); ++i)
+	{
+		for (std::list<cModule*>::iterator j = i->second.begin(); j != i->second.end(); ++j)
+		{
+			(*j)->deleteModule();
+		}
+	}
+	modulePool.clear();
+
+	// covers network setup and all vehicle insertions of this run
+	Veins::StartupProfiler::getInstance().writeReport();
 }
 
 void TraCIScenarioManager::handleMessage(cMessage *msg)
@@ -279,8 +364,9 @@ void TraCIScenarioManager::handleSelfMsg(cMessage *msg)
 {
 	if (msg == connectAndStartTrigger)
 	{
-		connection = TraCIConnection::connect(host.c_str(), port);
+		connection = createConnection();
 		commandIfc = new TraCICommandInterface(*connection);
+		commandIfc->setNetworkCacheEnabled(par("cacheNetwork"));
 		initTraCI();
 	}
 	else if (msg == executeOneTimestepTrigger)
@@ -333,6 +419,7 @@ void TraCIScenarioManager::handleSelfMsg(cMessage *msg)
 // name: host;Car;i=vehicle.gif
 void TraCIScenarioManager::addModule(std::string nodeId, std::string type, std::string name, std::string displayString, const Coord& position, std::string road_id, double speed, double angle)
 {
+	Veins::StartupProfiler::Scope profilerScope(getClassName(), "addModule");
 
 	if (hosts.find(nodeId) != hosts.end()) error("tried adding duplicate module");
 
@@ -348,7 +435,7 @@ void TraCIScenarioManager::addModule(std::string nodeId, std::string type, std::
 		return;
 	}
 
-	int32_t nodeVectorIndex = nextNodeVectorIndex++;
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
 
 	cModule* parentmod = getParentModule();
 	if (!parentmod) error("Parent Module not found");
@@ -356,12 +443,24 @@ void TraCIScenarioManager::addModule(std::string nodeId, std::string type, std::
 	cModuleType* nodeType = cModuleType::get(type.c_str());
 	if (!nodeType) error("Module Type \"%s\" not found", type.c_str());
 
-	//TODO: this trashes the vectsize member of the cModule, although nobody seems to use it
-	cModule* mod = nodeType->create(name.c_str(), parentmod, nodeVectorIndex, nodeVectorIndex);
-	mod->finalizeParameters();
-	mod->getDisplayString().parse(displayString.c_str());
-	mod->buildInside();
-	mod->scheduleStart(simTime() + updateInterval);
+	cModule* mod = takeParkedModule(nodeType, name);
+	bool recycled = (mod != nullptr);
+	if (recycled)
+	{
+		// keeps name, index and addresses of its previous life
+		mod->getDisplayString().parse(displayString.c_str());
+	}
+	else
+	{
+		int32_t nodeVectorIndex = nextNodeVectorIndex++;
+
+		//TODO: this trashes the vectsize member of the cModule, although nobody seems to use it
+		mod = nodeType->create(name.c_str(), parentmod, nodeVectorIndex, nodeVectorIndex);
+		mod->finalizeParameters();
+		mod->getDisplayString().parse(displayString.c_str());
+		mod->buildInside();
+		mod->scheduleStart(simTime() + updateInterval);
+	}
 
 	// pre-initialize TraCIMobility
 	for (cModule::SubmoduleIterator iter(mod); !iter.end(); iter++)
@@ -373,7 +472,8 @@ void TraCIScenarioManager::addModule(std::string nodeId, std::string type, std::
 		mm->preInitialize(nodeId, position, road_id, speed, angle);
 	}
 
-	mod->callInitialize();
+	if (recycled) reinitializeModule(mod);
+	else mod->callInitialize();
 	hosts[nodeId] = mod;
 
 	// post-initialize TraCIMobility
@@ -384,6 +484,18 @@ void TraCIScenarioManager::addModule(std::string nodeId, std::string type, std::
 		if (!mm) continue;
 		mm->updatePosition();
 	}
+
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	if (recycled)
+	{
+		++statsModulesRecycled;
+		statsRecycleTime += elapsed;
+	}
+	else
+	{
+		++statsModulesCreated;
+		statsCreateTime += elapsed;
+	}
 }
 
 cModule* TraCIScenarioManager::getManagedModule(std::string nodeId)
@@ -409,29 +521,121 @@ void TraCIScenarioManager::deleteManagedModule(std::string nodeId)
 
 	hosts.erase(nodeId);
 	mod->callFinish();
-	mod->deleteModule();
+	if (!parkModule(mod)) mod->deleteModule();
 }
 
-bool TraCIScenarioManager::isInRegionOfInterest(const TraCICoord& position, std::string road_id, double speed, double angle)
+bool TraCIScenarioManager::parkModule(cModule* mod)
 {
-	if ((roiRoads.size() == 0) && (roiRects.size() == 0)) return true;
-	if (roiRoads.size() > 0)
+	if (moduleRecyclingPoolSize == 0) return false;
+
+	std::list<cModule*>& pool = modulePool[std::make_pair(mod->getModuleType(), std::string(mod->getName()))];
+	if (pool.size() >= moduleRecyclingPoolSize) return false;
+
+	std::vector<cModule*> modules;
+	collectModules(mod, modules);
+	for (std::vector<cModule*>::const_iterator i = modules.begin(); i != modules.end(); ++i)
 	{
-		for (std::list<std::string>::const_iterator i = roiRoads.begin(); i != roiRoads.end(); ++i)
+		if ((*i)->isSimple() && !dynamic_cast<RecyclableModule*>(*i)) return false;
+	}
+
+	for (std::vector<cModule*>::const_iterator i = modules.begin(); i != modules.end(); ++i)
+	{
+		cModule* m = *i;
+
+		// not every module unsubscribes in finish(), but initialize() will subscribe again
+		std::vector<simsignal_t> signals = m->getLocalListenedSignals();
+		for (std::vector<simsignal_t>::const_iterator signal = signals.begin(); signal != signals.end(); ++signal)
+		{
+			std::vector<cIListener*> listeners = m->getLocalSignalListeners(*signal);
+			for (std::vector<cIListener*>::const_iterator listener = listeners.begin(); listener != listeners.end(); ++listener)
+			{
+				if (isInside(dynamic_cast<cModule*>(*listener), mod)) m->unsubscribe(*signal, *listener);
+			}
+		}
+
+		// likewise for WATCHes, which would otherwise show up once per life
+		for (int k = m->defaultListSize() - 1; k >= 0; --k)
 		{
-			if (road_id == *i)
-				return true;
+			if (cWatchBase* watch = dynamic_cast<cWatchBase*>(m->defaultListGet(k))) delete watch;
 		}
 	}
-	if (roiRects.size() > 0)
+
+	// drop messages still underway to the host, self-messages are only descheduled as their owners hold on to them.
+	// Messages scheduled by the host's modules are not tracked anywhere else, so this walks the whole FES once per
+	// parked host; the per-event test is kept to an arrival module ID lookup so the walk stays cheap next to the
+	// module deletion and re-creation it saves.
+	std::vector<int> moduleIds;
+	moduleIds.reserve(modules.size());
+	for (std::vector<cModule*>::const_iterator i = modules.begin(); i != modules.end(); ++i)
+	{
+		if ((*i)->isSimple()) moduleIds.push_back((*i)->getId());
+	}
+	std::sort(moduleIds.begin(), moduleIds.end());
+
+	cFutureEventSet* fes = getSimulation()->getFES();
+	std::vector<cMessage*> pending;
+	for (int i = 0; i < fes->getLength(); ++i)
+	{
+		cEvent* event = fes->get(i);
+		if (!event->isMessage()) continue;
+		cMessage* msg = static_cast<cMessage*>(event);
+		if (std::binary_search(moduleIds.begin(), moduleIds.end(), msg->getArrivalModuleId())) pending.push_back(msg);
+	}
+	for (std::vector<cMessage*>::const_iterator i = pending.begin(); i != pending.end(); ++i)
 	{
-		for (std::list<std::pair<TraCICoord, TraCICoord> >::const_iterator i = roiRects.begin(); i != roiRects.end(); ++i)
+		fes->remove(*i);
+		if ((*i)->isSelfMessage()) continue;
+		take(*i);
+		delete *i;
+	}
+
+	for (std::vector<cModule*>::const_iterator i = modules.begin(); i != modules.end(); ++i)
+	{
+		if (!(*i)->isSimple()) continue;
+		cContextSwitcher context(*i);
+		dynamic_cast<RecyclableModule*>(*i)->recycle();
+	}
+
+	pool.push_back(mod);
+	return true;
+}
+
+cModule* TraCIScenarioManager::takeParkedModule(cModuleType* nodeType, std::string name)
+{
+	std::map<std::pair<cModuleType*, std::string>, std::list<cModule*> >::iterator i = modulePool.find(std::make_pair(nodeType, name));
+	if (i == modulePool.end() || i->second.empty()) return nullptr;
+
+	cModule* mod = i->second.front();
+	i->second.pop_front();
+	return mod;
+}
+
+void TraCIScenarioManager::reinitializeModule(cModule* mod)
+{
+	std::vector<cModule*> modules;
+	collectModules(mod, modules);
+
+	int numStages = 0;
+	for (std::vector<cModule*>::const_iterator i = modules.begin(); i != modules.end(); ++i)
+	{
+		numStages = std::max(numStages, (*i)->numInitStages());
+	}
+
+	// same order as callInitialize: stage by stage, parents before children
+	for (int stage = 0; stage < numStages; ++stage)
+	{
+		for (std::vector<cModule*>::const_iterator i = modules.begin(); i != modules.end(); ++i)
 		{
-			if ((position.x >= i->first.x) && (position.y >= i->first.y) && (position.x <= i->second.x) && (position.y <= i->second.y))
-				return true;
+			if (!(*i)->isSimple() || stage >= (*i)->numInitStages()) continue;
+			cContextSwitcher context(*i);
+			dynamic_cast<RecyclableModule*>(*i)->reinitialize(stage);
 		}
 	}
-	return false;
+}
+
+bool TraCIScenarioManager::isInRegionOfInterest(const TraCICoord& position, std::string road_id, double speed, double angle)
+{
+	return roi.isInside(position, road_id);
 }
 
 uint32_t TraCIScenarioManager::getCurrentTimeMs()
@@ -439,8 +643,19 @@ uint32_t TraCIScenarioManager::getCurrentTimeMs()
 	return static_cast<uint32_t>(round(simTime().dbl() * 1000));
 }
 
+TraCIConnection* TraCIScenarioManager::createConnection()
+{
+	return TraCIConnection::connect(host.c_str(), port);
+}
+
 void TraCIScenarioManager::initTraCI()
 {
+    Veins::StartupProfiler::Scope profilerScope(getClassName(), "initTraCI");
+
+    // start recording here, so that a subclass' own handshake (e.g. with sumo-launchd) is not part of the trace
+    std::string recordTrace = hasPar("recordTrace") ? par("recordTrace").stdstringValue() : "";
+    if (!recordTrace.empty()) connection->startRecording(recordTrace);
+
     {
         std::pair<uint32_t, std::string> version = getCommandInterface()->getVersion();
         uint32_t apiVersion = version.first;
@@ -474,6 +689,12 @@ void TraCIScenarioManager::initTraCI()
             EV << "WARNING: Playground size (" << world->getPgs()->x << ", " << world->getPgs()->y << ") might be too small for vehicle at network bounds (" << connection->traci2omnet(netbounds2).x << ", " << connection->traci2omnet(netbounds1).y << ")" << endl;
     }
 
+    {
+        // pre-load static lane and junction data (needs the network boundaries for coordinate conversion)
+        cXMLElement* roadNetwork = par("roadNetwork").xmlValue();
+        if (roadNetwork && roadNetwork->getFirstChild()) commandIfc->preloadNetwork(roadNetwork);
+    }
+
     {
         // subscribe to list of departed and arrived vehicles, as well as simulation time
         uint32_t beginTime = 0;
@@ -492,6 +713,12 @@ void TraCIScenarioManager::initTraCI()
         ASSERT(buf.eof());
     }
 
+    if (roiSubscriptions)
+    {
+        // only vehicles on roads of the region of interest are of interest
+        subscribeToRoiRoads();
+    }
+    else
     {
         // subscribe to list of vehicle ids
         uint32_t beginTime = 0;
@@ -533,10 +760,17 @@ void TraCIScenarioManager::executeOneTimestep()
 		insertVehicles();
 		TraCIBuffer buf = connection->query(CMD_SIMSTEP2, TraCIBuffer() << targetTime);
 
+		roiVehicles.clear();
 		uint32_t count; buf >> count;
 		EV << "Getting " << count << " subscription results" << endl;
 		for (uint32_t i = 0; i < count; ++i)
 			processSubcriptionResult(buf);
+
+		if (roiSubscriptions)
+		{
+			updateVehicleSubscriptions(roiVehicles, true);
+			if (drivingVehicleCount > subscribedVehicles.size()) statsVehicleUpdatesAvoided += drivingVehicleCount - subscribedVehicles.size();
+		}
 	}
 
 	if (!autoShutdownTriggered)
@@ -614,6 +848,116 @@ void TraCIScenarioManager::unsubscribeFromVehicleVariables(std::string vehicleId
 	ASSERT(buf.eof());
 }
 
+void TraCIScenarioManager::updateVehicleSubscriptions(const std::set<std::string>& vehicles, bool leftRoi)
+{
+	// check for vehicles that need subscribing to
+	std::set<std::string> needSubscribe;
+	std::set_difference(vehicles.begin(), vehicles.end(), subscribedVehicles.begin(), subscribedVehicles.end(), std::inserter(needSubscribe, needSubscribe.begin()));
+	for (std::set<std::string>::const_iterator i = needSubscribe.begin(); i != needSubscribe.end(); ++i)
+	{
+		subscribedVehicles.insert(*i);
+		subscribeToVehicleVariables(*i);
+	}
+
+	// check for vehicles that need unsubscribing from
+	std::set<std::string> needUnsubscribe;
+	std::set_difference(subscribedVehicles.begin(), subscribedVehicles.end(), vehicles.begin(), vehicles.end(), std::inserter(needUnsubscribe, needUnsubscribe.begin()));
+	for (std::set<std::string>::const_iterator i = needUnsubscribe.begin(); i != needUnsubscribe.end(); ++i)
+	{
+		subscribedVehicles.erase(*i);
+		unsubscribeFromVehicleVariables(*i);
+
+		if (!leftRoi) continue;
+
+		// parking vehicles are not on any road, but keep their hosts
+		cModule* mod = getManagedModule(*i);
+		bool isParking = false;
+		if (mod)
+		{
+			for (cModule::SubmoduleIterator iter(mod); !iter.end(); iter++)
+			{
+				TraCIMobility* mm = dynamic_cast<TraCIMobility*>(SUBMODULE_ITERATOR_TO_MODULE(iter));
+				if (mm && mm->getParkingState()) isParking = true;
+			}
+			if (isParking) continue;
+			deleteManagedModule(*i);
+			EV << "Vehicle #" << *i << " left region of interest" << endl;
+		}
+		else if (unEquippedHosts.find(*i) != unEquippedHosts.end())
+		{
+			unEquippedHosts.erase(*i);
+			EV << "Vehicle (unequipped) # " << *i << " left region of interest" << endl;
+		}
+	}
+}
+
+std::set<std::string> TraCIScenarioManager::getRoiRoads()
+{
+	std::set<std::string> roads = roi.getRoads();
+	if (roi.hasRectangles())
+	{
+		// vehicles drive along the lane shapes, so only roads with a lane touching a rectangle can hold vehicles inside it
+		const std::list<std::string>& laneIds = commandIfc->getLaneIds();
+		for (std::list<std::string>::const_iterator i = laneIds.begin(); i != laneIds.end(); ++i)
+		{
+			if (!roi.intersectsRectangles(connection->omnet2traci(commandIfc->lane(*i).getShape()))) continue;
+			// SUMO names lanes <road id>_<lane index>
+			roads.insert(i->substr(0, i->rfind('_')));
+		}
+	}
+	return roads;
+}
+
+void TraCIScenarioManager::subscribeToRoiRoads()
+{
+	std::set<std::string> roads = getRoiRoads();
+	EV << "Subscribing to vehicles on " << roads.size() << " roads of the region of interest" << endl;
+
+	uint32_t beginTime = 0;
+	uint32_t endTime = 0x7FFFFFFF;
+	uint8_t variableNumber = 1;
+	uint8_t variable1 = LAST_STEP_VEHICLE_ID_LIST;
+	for (std::set<std::string>::const_iterator i = roads.begin(); i != roads.end(); ++i)
+	{
+		connection->queryAsync(CMD_SUBSCRIBE_EDGE_VARIABLE, TraCIBuffer() << beginTime << endTime << *i << variableNumber << variable1, [this](TraCIBuffer& buf) { processSubcriptionResult(buf); });
+	}
+	connection->flush();
+
+	updateVehicleSubscriptions(roiVehicles, true);
+}
+
+void TraCIScenarioManager::processRoadSubscription(std::string objectId, TraCIBuffer& buf)
+{
+	uint8_t variableNumber_resp; buf >> variableNumber_resp;
+	for (uint8_t j = 0; j < variableNumber_resp; ++j)
+	{
+		uint8_t variable1_resp; buf >> variable1_resp;
+		uint8_t isokay; buf >> isokay;
+		if (isokay != RTYPE_OK)
+		{
+			uint8_t varType; buf >> varType;
+			ASSERT(varType == TYPE_STRING);
+			std::string errormsg; buf >> errormsg;
+			error("TraCI server reported error subscribing to vehicles on road \"%s\" (\"%s\").", objectId.c_str(), errormsg.c_str());
+		}
+		else if (variable1_resp == LAST_STEP_VEHICLE_ID_LIST)
+		{
+			uint8_t varType; buf >> varType;
+			ASSERT(varType == TYPE_STRINGLIST);
+			uint32_t count; buf >> count;
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				std::string idstring; buf >> idstring;
+				roiVehicles.insert(idstring);
+			}
+		}
+		else
+		{
+			error("Received unhandled road subscription result");
+		}
+	}
+}
+
 void TraCIScenarioManager::processSimSubscription(std::string objectId, TraCIBuffer& buf)
 {
 	uint8_t variableNumber_resp; buf >> variableNumber_resp;
@@ -814,24 +1158,7 @@ void TraCIScenarioManager::processVehicleSubscription(std::string objectId, TraC
 				drivingVehicles.insert(idstring);
 			}
 
-			// check for vehicles that need subscribing to
-			std::set<std::string> needSubscribe;
-			std::set_difference(drivingVehicles.begin(), drivingVehicles.end(), subscribedVehicles.begin(), subscribedVehicles.end(), std::inserter(needSubscribe, needSubscribe.begin()));
-			for (std::set<std::string>::const_iterator i = needSubscribe.begin(); i != needSubscribe.end(); ++i)
-			{
-				subscribedVehicles.insert(*i);
-				subscribeToVehicleVariables(*i);
-			}
-
-			// check for vehicles that need unsubscribing from
-			std::set<std::string> needUnsubscribe;
-			std::set_difference(subscribedVehicles.begin(), subscribedVehicles.end(), drivingVehicles.begin(), drivingVehicles.end(), std::inserter(needUnsubscribe, needUnsubscribe.begin()));
-			for (std::set<std::string>::const_iterator i = needUnsubscribe.begin(); i != needUnsubscribe.end(); ++i)
-			{
-				subscribedVehicles.erase(*i);
-				unsubscribeFromVehicleVariables(*i);
-			}
-
+			updateVehicleSubscriptions(drivingVehicles, false);
 		}
 		else if (variable1_resp == VAR_POSITION)
 		{
@@ -892,6 +1219,7 @@ void TraCIScenarioManager::processVehicleSubscription(std::string objectId, TraC
 	bool inRoi = isInRegionOfInterest(TraCICoord(px, py), edge, speed, angle);
 	if (!inRoi)
 	{
+		statsVehicleUpdatesOutsideRoi++;
 		if (mod)
 		{
 			deleteManagedModule(objectId);
@@ -978,7 +1306,13 @@ void TraCIScenarioManager::processSubcriptionResult(TraCIBuffer& buf)
 	std::string objectId_resp; buf >> objectId_resp;
 
 	if (commandId_resp == RESPONSE_SUBSCRIBE_VEHICLE_VARIABLE)
+	{
+		statsVehicleUpdates++;
+		statsVehicleUpdateBytes += cmdLengthExt_resp;
 		processVehicleSubscription(objectId_resp, buf);
+	}
+	else if (commandId_resp == RESPONSE_SUBSCRIBE_EDGE_VARIABLE)
+		processRoadSubscription(objectId_resp, buf);
 	else if (commandId_resp == RESPONSE_SUBSCRIBE_SIM_VARIABLE)
 		processSimSubscription(objectId_resp, buf);
 	else
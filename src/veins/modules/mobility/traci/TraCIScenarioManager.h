@@ -36,6 +36,7 @@
 #include "veins/modules/mobility/traci/TraCIColor.h"
 #include "veins/modules/mobility/traci/TraCIConnection.h"
 #include "veins/modules/mobility/traci/TraCICoord.h"
+#include "veins/modules/mobility/traci/TraCIRegionOfInterest.h"
 
 /**
  * @brief
@@ -103,6 +104,9 @@ protected:
     /** initialize interaction with TraCI when the simulation begins. */
     virtual void initTraCI();
 
+	/** opens the connection to the TraCI server. */
+	virtual TraCIConnection* createConnection();
+
 	/** read and execute all commands for the next timestep. */
 	void executeOneTimestep();
 
@@ -111,6 +115,16 @@ protected:
 	cModule* getManagedModule(std::string nodeId);
 	void deleteManagedModule(std::string nodeId);
 
+	/**
+	 * parks a finished host in the module pool instead of deleting it.
+	 * Returns false if the pool is disabled or full, or if not all of the host's simple modules are RecyclableModules.
+	 */
+	bool parkModule(cModule* mod);
+	/** returns a parked host of the given type and name, or 0 if there is none. */
+	cModule* takeParkedModule(cModuleType* nodeType, std::string name);
+	/** runs the RecyclableModule::reinitialize stages on all simple modules of a host taken from the pool. */
+	void reinitializeModule(cModule* mod);
+
 	/** returns true if this vehicle is Unequipped. */
 	bool isModuleUnequipped(std::string nodeId);
 
@@ -128,8 +142,18 @@ protected:
 
 	void subscribeToVehicleVariables(std::string vehicleId);
 	void unsubscribeFromVehicleVariables(std::string vehicleId);
+	/**
+	 * subscribes to the vehicles given and unsubscribes from all others.
+	 * If leftRoi is set, hosts of driving vehicles that are no longer given are deleted (they left the region of interest)
+	 */
+	void updateVehicleSubscriptions(const std::set<std::string>& vehicles, bool leftRoi);
+	/** returns the roads a vehicle must be on to be inside the region of interest */
+	std::set<std::string> getRoiRoads();
+	/** subscribes to the vehicles on all roads of the region of interest instead of to all vehicles */
+	void subscribeToRoiRoads();
 	void processSimSubscription(std::string objectId, TraCIBuffer& buf);
 	void processVehicleSubscription(std::string objectId, TraCIBuffer& buf);
+	void processRoadSubscription(std::string objectId, TraCIBuffer& buf);
 	void processSubcriptionResult(TraCIBuffer& buf);
 
 	/**
@@ -167,14 +191,25 @@ protected:
 
 	bool autoShutdown; /**< Shutdown module as soon as no more vehicles are in the simulation */
 	double penetrationRate;
-	std::list<std::string> roiRoads; /**< which roads (e.g. "hwy1 hwy2") are considered to consitute the region of interest, if not empty */
-	std::list<std::pair<TraCICoord, TraCICoord> > roiRects; /**< which rectangles (e.g. "0,0-10,10 20,20-30,30) are considered to consitute the region of interest, if not empty */
+	TraCIRegionOfInterest roi; /**< which roads (e.g. "hwy1 hwy2") and rectangles (e.g. "0,0-10,10 20,20-30,30") are considered to consitute the region of interest, if any */
+	bool roiSubscriptions; /**< whether to subscribe only to vehicles on roads of the region of interest (instead of to all vehicles) */
+	std::set<std::string> roiVehicles; /**< vehicles on the roads of the region of interest in the current time step */
+	uint64_t statsVehicleUpdates; /**< number of vehicle subscription results received */
+	uint64_t statsVehicleUpdateBytes; /**< size of the vehicle subscription results received */
+	uint64_t statsVehicleUpdatesOutsideRoi; /**< number of vehicle subscription results received for vehicles outside the region of interest */
+	uint64_t statsVehicleUpdatesAvoided; /**< number of vehicle subscription results not received because the vehicle was not on a road of the region of interest */
 
 	TraCIConnection* connection;
 	TraCICommandInterface* commandIfc;
 
 	size_t nextNodeVectorIndex; /**< next OMNeT++ module vector index to use */
 	std::map<std::string, cModule*> hosts; /**< vector of all hosts managed by us */
+	size_t moduleRecyclingPoolSize; /**< how many deleted hosts to keep for reuse per module type and name (0: recycling disabled) */
+	std::map<std::pair<cModuleType*, std::string>, std::list<cModule*> > modulePool; /**< parked hosts by module type and name */
+	long statsModulesCreated; /**< number of hosts created by addModule */
+	long statsModulesRecycled; /**< number of hosts addModule took from the pool */
+	double statsCreateTime; /**< wall clock time spent in addModule creating hosts (in s) */
+	double statsRecycleTime; /**< wall clock time spent in addModule reusing hosts (in s) */
 	std::set<std::string> unEquippedHosts;
 	std::set<std::string> subscribedVehicles; /**< all vehicles we have already subscribed to */
 	uint32_t activeVehicleCount; /**< number of vehicles, be it parking or driving **/
@@ -0,0 +1,41 @@
+//
+// Copyright (C) 2018 Xu Le <xmutongxinXuLe@163.com>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "veins/modules/mobility/traci/TraCIScenarioManagerReplay.h"
+
+using Veins::TraCIScenarioManagerReplay;
+using Veins::TraCIConnection;
+
+Define_Module(Veins::TraCIScenarioManagerReplay);
+
+void TraCIScenarioManagerReplay::initialize(int stage)
+{
+	if (stage == 1)
+	{
+		traceFile = par("traceFile").stdstringValue();
+		if (traceFile.empty()) error("No TraCI trace to replay, set parameter traceFile");
+	}
+	TraCIScenarioManager::initialize(stage);
+}
+
+TraCIConnection* TraCIScenarioManagerReplay::createConnection()
+{
+	return TraCIConnection::replay(traceFile.c_str());
+}
@@ -0,0 +1,71 @@
+//
+// Copyright (C) 2018 Xu Le <xmutongxinXuLe@163.com>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#ifndef WORLD_TRACI_TRACISCENARIOMANAGERREPLAY_H
+#define WORLD_TRACI_TRACISCENARIOMANAGERREPLAY_H
+
+#include <omnetpp.h>
+
+#include "veins/modules/mobility/traci/TraCIScenarioManager.h"
+
+/**
+ * @brief
+ * Replays a TraCI trace recorded by TraCIScenarioManagerLaunchd (parameter recordTrace) instead of connecting to SUMO.
+ *
+ * Vehicles are created, moved and deleted exactly as in the recorded run, so many variations of the
+ * network parameters can run in parallel on the same mobility without SUMO processes.
+ * Queries must match those of the recorded run (in the same time step), commands that would change the
+ * traffic are logged and ignored.
+ *
+ * All other functionality is provided by the TraCIScenarioManager.
+ *
+ * @author Xu Le
+ *
+ * @see TraCIScenarioManager
+ * @see TraCIScenarioManagerLaunchd
+ *
+ */
+namespace Veins {
+
+class TraCIScenarioManagerReplay : public TraCIScenarioManager
+{
+public:
+	TraCIScenarioManagerReplay() : TraCIScenarioManager() {}
+
+	virtual void initialize(int stage) override;
+
+protected:
+	std::string traceFile; /**< TraCI trace to replay */
+
+	/** opens the trace instead of a connection to a TraCI server. */
+	virtual TraCIConnection* createConnection() override;
+};
+
+class TraCIScenarioManagerReplayAccess
+{
+public:
+	TraCIScenarioManagerReplay* get() {
+		return FindModule<TraCIScenarioManagerReplay*>::findGlobalModule();
+	};
+};
+
+}
+
+#endif
@@ -0,0 +1,60 @@
+//
+// Copyright (C) 2018 Xu Le <xmutongxinXuLe@163.com>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "veins/modules/mobility/traci/TraCITrace.h"
+
+namespace Veins {
+
+TraCITraceWriter::TraCITraceWriter(const std::string& fileName) : fileName(fileName), out(fileName.c_str(), std::ios::binary | std::ios::trunc) {
+	if (!out) throw cRuntimeError("Could not create TraCI trace file %s", fileName.c_str());
+
+	// same header as a BinaryCacheWriter, so that BinaryCacheReader can map the file
+	uint32_t magic = TRACI_TRACE_MAGIC;
+	uint32_t version = TRACI_TRACE_VERSION;
+	uint64_t hash = 0;
+	out.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+	out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+	out.write(reinterpret_cast<const char*>(&hash), sizeof(hash));
+}
+
+void TraCITraceWriter::add(const std::string& command, const std::string& reply) {
+	putString(command);
+	putString(reply);
+	if (!out) throw cRuntimeError("Could not write TraCI trace file %s", fileName.c_str());
+}
+
+void TraCITraceWriter::putString(const std::string& s) {
+	uint32_t length = s.size();
+	out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+	out.write(s.data(), s.size());
+}
+
+TraCITraceReader::TraCITraceReader(const std::string& fileName) {
+	if (!reader.open(fileName, TRACI_TRACE_MAGIC, TRACI_TRACE_VERSION, 0)) throw cRuntimeError("Could not open TraCI trace file %s", fileName.c_str());
+}
+
+bool TraCITraceReader::next(std::string& command, std::string& reply) {
+	if (reader.eof()) return false;
+	command = reader.getString();
+	reply = reader.getString();
+	return true;
+}
+
+}
@@ -0,0 +1,75 @@
+//
+// Copyright (C) 2018 Xu Le <xmutongxinXuLe@163.com>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#ifndef VEINS_MOBILITY_TRACI_TRACITRACE_H_
+#define VEINS_MOBILITY_TRACI_TRACITRACE_H_
+
+#include <string>
+#include <fstream>
+
+#include "veins/modules/utility/BinaryCache.h"
+
+namespace Veins {
+
+/**
+ * A TraCI trace is the sequence of all commands sent to a TraCI server, each with the part of the reply belonging to it
+ * (its status response and, if any, its response). It starts with a BinaryCache header, followed by one
+ * (uint32 length, command bytes, uint32 length, reply bytes) record per command.
+ */
+const uint32_t TRACI_TRACE_MAGIC = 0x54524354;
+const uint32_t TRACI_TRACE_VERSION = 1;
+
+/**
+ * appends commands and replies to a TraCI trace file as they are exchanged
+ */
+class TraCITraceWriter
+{
+	public:
+		/** creates the trace file, throws if it cannot be written */
+		TraCITraceWriter(const std::string& fileName);
+
+		void add(const std::string& command, const std::string& reply);
+
+	private:
+		void putString(const std::string& s);
+
+		std::string fileName;
+		std::ofstream out;
+};
+
+/**
+ * reads a TraCI trace file front to back from a memory mapping
+ */
+class TraCITraceReader
+{
+	public:
+		/** opens the trace file, throws if it is missing or not a TraCI trace */
+		TraCITraceReader(const std::string& fileName);
+
+		/** reads the next command and its reply, returns false at the end of the trace */
+		bool next(std::string& command, std::string& reply);
+
+	private:
+		BinaryCacheReader reader;
+};
+
+}
+
+#endif /* VEINS_MOBILITY_TRACI_TRACITRACE_H_ */
@@ -0,0 +1,334 @@
+//
+// Copyright (C) 2018 Xu Le <xmutongxinXuLe@163.com>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#define WANT_WINSOCK2
+#include <platdep/sockets.h>
+#if defined(_WIN32) || defined(__WIN32__) || defined(WIN32) || defined(__CYGWIN__) || defined(_WIN64)
+#include <ws2tcpip.h>
+#define VEINS_TRACI_NO_LOCAL_TRANSPORTS
+#else
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <arpa/inet.h>
+#include <sys/un.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <new>
+#include <sstream>
+
+#include "veins/modules/mobility/traci/TraCITransport.h"
+#include "veins/modules/mobility/traci/TraCIConnection.h"
+#include "veins/modules/mobility/traci/TraCIConstants.h"
+
+#define MYDEBUG EV
+
+namespace Veins {
+
+namespace {
+
+/**
+ * TCP or Unix domain stream socket
+ */
+class SocketTransport : public TraCITransport
+{
+	public:
+		SocketTransport(SOCKET s) : s(s) {}
+		virtual ~SocketTransport() { closesocket(s); }
+
+		virtual void send(const char* data, size_t length) override {
+			size_t bytesWritten = 0;
+			while (bytesWritten < length) {
+				int sentBytes = ::send(s, data + bytesWritten, length - bytesWritten, 0);
+				if (sentBytes > 0) {
+					bytesWritten += sentBytes;
+				} else {
+					if (sock_errno() == EINTR) continue;
+					if (sock_errno() == EAGAIN) continue;
+					throw cRuntimeError("Connection to TraCI server lost. Check your server's log. Error message: %d: %s", sock_errno(), strerror(sock_errno()));
+				}
+			}
+		}
+
+		virtual void receive(char* data, size_t length) override {
+			size_t bytesRead = 0;
+			while (bytesRead < length) {
+				int receivedBytes = ::recv(s, data + bytesRead, length - bytesRead, 0);
+				if (receivedBytes > 0) {
+					bytesRead += receivedBytes;
+				} else if (receivedBytes == 0) {
+					throw cRuntimeError("Connection to TraCI server closed unexpectedly. Check your server's log");
+				} else {
+					if (sock_errno() == EINTR) continue;
+					if (sock_errno() == EAGAIN) continue;
+					throw cRuntimeError("Connection to TraCI server lost. Check your server's log. Error message: %d: %s", sock_errno(), strerror(sock_errno()));
+				}
+			}
+		}
+
+#ifndef VEINS_TRACI_NO_LOCAL_TRANSPORTS
+		/** returns whether the peer has closed the connection, without blocking */
+		bool isClosed() {
+			char c;
+			return ::recv(s, &c, 1, MSG_PEEK | MSG_DONTWAIT) == 0;
+		}
+#endif
+
+	private:
+		SOCKET s;
+};
+
+SocketTransport* connectTcp(const std::string& host, int port) {
+	in_addr addr;
+	struct hostent* host_ent;
+	struct in_addr saddr;
+
+	saddr.s_addr = inet_addr(host.c_str());
+	if (saddr.s_addr != static_cast<unsigned int>(-1)) {
+		addr = saddr;
+	} else if ((host_ent = gethostbyname(host.c_str()))) {
+		addr = *((struct in_addr*) host_ent->h_addr_list[0]);
+	} else {
+		throw cRuntimeError("Invalid TraCI server address: %s", host.c_str());
+	}
+
+	sockaddr_in address;
+	memset((char*) &address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = addr.s_addr;
+
+	SOCKET s = ::socket(AF_INET, SOCK_STREAM, 0);
+	if (s < 0) throw cRuntimeError("Could not create socket to connect to TraCI server");
+
+	if (::connect(s, (sockaddr const*) &address, sizeof(address)) < 0) {
+		closesocket(s);
+		throw cRuntimeError("Could not connect to TraCI server. Make sure it is running and not behind a firewall. Error message: %d: %s", sock_errno(), strerror(sock_errno()));
+	}
+
+	{
+		int x = 1;
+		::setsockopt(s, IPPROTO_TCP, TCP_NODELAY, (const char*) &x, sizeof(x));
+	}
+
+	return new SocketTransport(s);
+}
+
+#ifndef VEINS_TRACI_NO_LOCAL_TRANSPORTS
+SocketTransport* connectUnix(const std::string& path) {
+	sockaddr_un address;
+	memset((char*) &address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (path.size() >= sizeof(address.sun_path)) throw cRuntimeError("Unix domain socket path too long: %s", path.c_str());
+	strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+	SOCKET s = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	if (s < 0) throw cRuntimeError("Could not create Unix domain socket to connect to TraCI server");
+
+	if (::connect(s, (sockaddr const*) &address, sizeof(address)) < 0) {
+		closesocket(s);
+		throw cRuntimeError("Could not connect to TraCI server at Unix domain socket %s. Make sure it is running. Error message: %d: %s", path.c_str(), sock_errno(), strerror(sock_errno()));
+	}
+
+	return new SocketTransport(s);
+}
+
+/**
+ * two ring buffers in a shared memory segment, see TraCITransport.h for the layout
+ */
+class SharedMemoryTransport : public TraCITransport
+{
+	public:
+		SharedMemoryTransport(SocketTransport* control, char* segment) : control(control), segment(segment) {}
+
+		virtual ~SharedMemoryTransport() {
+			munmap(segment, SHM_OFFSET_DATA + 2 * SHM_CAPACITY);
+			delete control;
+		}
+
+		virtual void send(const char* data, size_t length) override {
+			std::atomic<uint64_t>& head = at(SHM_OFFSET_TO_SERVER_HEAD);
+			std::atomic<uint64_t>& tail = at(SHM_OFFSET_TO_SERVER_TAIL);
+			char* ring = segment + SHM_OFFSET_DATA;
+
+			uint64_t written = head.load(std::memory_order_relaxed);
+			size_t spins = 0;
+			while (length > 0) {
+				uint64_t space = SHM_CAPACITY - (written - tail.load(std::memory_order_acquire));
+				if (space == 0) {
+					wait(spins);
+					continue;
+				}
+				spins = 0;
+				size_t offset = written % SHM_CAPACITY;
+				size_t n = std::min<uint64_t>(std::min<uint64_t>(space, length), SHM_CAPACITY - offset);
+				memcpy(ring + offset, data, n);
+				written += n;
+				data += n;
+				length -= n;
+				head.store(written, std::memory_order_release);
+			}
+		}
+
+		virtual void receive(char* data, size_t length) override {
+			std::atomic<uint64_t>& head = at(SHM_OFFSET_TO_CLIENT_HEAD);
+			std::atomic<uint64_t>& tail = at(SHM_OFFSET_TO_CLIENT_TAIL);
+			const char* ring = segment + SHM_OFFSET_DATA + SHM_CAPACITY;
+
+			uint64_t read = tail.load(std::memory_order_relaxed);
+			size_t spins = 0;
+			while (length > 0) {
+				uint64_t available = head.load(std::memory_order_acquire) - read;
+				if (available == 0) {
+					wait(spins);
+					continue;
+				}
+				spins = 0;
+				size_t offset = read % SHM_CAPACITY;
+				size_t n = std::min<uint64_t>(std::min<uint64_t>(available, length), SHM_CAPACITY - offset);
+				memcpy(data, ring + offset, n);
+				read += n;
+				data += n;
+				length -= n;
+				tail.store(read, std::memory_order_release);
+			}
+		}
+
+	private:
+		std::atomic<uint64_t>& at(size_t offset) {
+			return *reinterpret_cast<std::atomic<uint64_t>*>(segment + offset);
+		}
+
+		/** spins first (a TraCI step usually answers within microseconds) if there is a core to spare, then yields and finally sleeps */
+		void wait(size_t& spins) {
+			static const size_t spinLimit = std::thread::hardware_concurrency() > 1 ? 1000 : 0;
+			++spins;
+			if (spins < spinLimit) return;
+			if (spins % 1000 == 0 && control->isClosed()) throw cRuntimeError("Connection to TraCI server closed unexpectedly. Check your server's log");
+			if (spins < 100000) std::this_thread::yield();
+			else std::this_thread::sleep_for(std::chrono::microseconds(50));
+		}
+
+		SocketTransport* control; /**< Unix domain socket the segment was announced on, closing it ends the session */
+		char* segment;
+};
+
+TraCITransport* connectSharedMemory(const std::string& path) {
+	SocketTransport* control = connectUnix(path);
+
+	static unsigned counter = 0;
+	std::ostringstream name;
+	name << "/veins-traci-" << getpid() << "-" << counter++;
+
+	size_t size = SHM_OFFSET_DATA + 2 * SHM_CAPACITY;
+	int fd = shm_open(name.str().c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+	if (fd < 0) {
+		delete control;
+		throw cRuntimeError("Could not create shared memory segment %s: %s", name.str().c_str(), strerror(errno));
+	}
+	void* mapped = MAP_FAILED;
+	if (ftruncate(fd, size) == 0) mapped = mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (mapped == MAP_FAILED) {
+		shm_unlink(name.str().c_str());
+		delete control;
+		throw cRuntimeError("Could not map shared memory segment %s: %s", name.str().c_str(), strerror(errno));
+	}
+
+	char* segment = static_cast<char*>(mapped);
+	uint32_t magic = SHM_MAGIC;
+	uint32_t version = SHM_VERSION;
+	uint64_t capacity = SHM_CAPACITY;
+	memcpy(segment, &magic, sizeof(magic));
+	memcpy(segment + sizeof(magic), &version, sizeof(version));
+	memcpy(segment + sizeof(magic) + sizeof(version), &capacity, sizeof(capacity));
+	new (segment + SHM_OFFSET_TO_SERVER_HEAD) std::atomic<uint64_t>(0);
+	new (segment + SHM_OFFSET_TO_SERVER_TAIL) std::atomic<uint64_t>(0);
+	new (segment + SHM_OFFSET_TO_CLIENT_HEAD) std::atomic<uint64_t>(0);
+	new (segment + SHM_OFFSET_TO_CLIENT_TAIL) std::atomic<uint64_t>(0);
+
+	// announce the segment on the socket and wait for the server to map it
+	uint8_t result = RTYPE_ERR;
+	std::string description;
+	try {
+		std::string command = makeTraCICommand(CMD_SHM_ATTACH, TraCIBuffer() << name.str());
+		std::string message = (TraCIBuffer() << static_cast<uint32_t>(sizeof(uint32_t) + command.size())).str() + command;
+		control->send(message.data(), message.size());
+
+		char lengthBuf[sizeof(uint32_t)];
+		control->receive(lengthBuf, sizeof(lengthBuf));
+		uint32_t length; TraCIBuffer(std::string(lengthBuf, sizeof(lengthBuf))) >> length;
+		std::string reply(length - sizeof(uint32_t), '\0');
+		control->receive(&reply[0], reply.size());
+
+		TraCIBuffer obuf(reply);
+		uint8_t cmdLength; obuf >> cmdLength;
+		uint8_t commandResp; obuf >> commandResp;
+		obuf >> result;
+		obuf >> description;
+		if (commandResp != CMD_SHM_ATTACH) result = RTYPE_ERR;
+	}
+	catch (...) {
+		shm_unlink(name.str().c_str());
+		munmap(segment, size);
+		delete control;
+		throw;
+	}
+	shm_unlink(name.str().c_str());
+
+	if (result != RTYPE_OK) {
+		munmap(segment, size);
+		delete control;
+		throw cRuntimeError("TraCI server at %s does not support shared memory transport (\"%s\")", path.c_str(), description.c_str());
+	}
+
+	return new SharedMemoryTransport(control, segment);
+}
+#endif
+
+}
+
+TraCITransport* TraCITransport::connect(const std::string& host, int port) {
+	if (initsocketlibonce() != 0) throw cRuntimeError("Could not init socketlib");
+
+	if (host.compare(0, 5, "unix:") == 0 || host.compare(0, 4, "shm:") == 0) {
+#ifdef VEINS_TRACI_NO_LOCAL_TRANSPORTS
+		throw cRuntimeError("TraCI transport \"%s\" is not supported on this platform", host.c_str());
+#else
+		if (host.compare(0, 5, "unix:") == 0) {
+			MYDEBUG << "Connecting to TraCI server via Unix domain socket " << host.substr(5) << endl;
+			return connectUnix(host.substr(5));
+		}
+		MYDEBUG << "Connecting to TraCI server via shared memory, set up at " << host.substr(4) << endl;
+		return connectSharedMemory(host.substr(4));
+#endif
+	}
+
+	MYDEBUG << "Connecting to TraCI server via TCP " << host << ":" << port << endl;
+	return connectTcp(host, port);
+}
+
+}
@@ -0,0 +1,77 @@
+//
+// Copyright (C) 2018 Xu Le <xmutongxinXuLe@163.com>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#ifndef VEINS_MOBILITY_TRACI_TRACITRANSPORT_H_
+#define VEINS_MOBILITY_TRACI_TRACITRANSPORT_H_
+
+#include <string>
+#include <cstddef>
+#include <stdint.h>
+
+#include "veins/base/utils/MiXiMDefs.h"
+
+namespace Veins {
+
+/**
+ * byte stream between TraCIConnection and a TraCI server
+ */
+class TraCITransport
+{
+	public:
+		/**
+		 * opens the transport selected by host:
+		 *
+		 *   "unix:<path>"  Unix domain socket at path (port is ignored)
+		 *   "shm:<path>"   shared memory ring buffers, set up via the Unix domain socket at path (port is ignored)
+		 *   anything else  TCP connection to host:port
+		 */
+		static TraCITransport* connect(const std::string& host, int port);
+
+		virtual ~TraCITransport() {}
+
+		/** sends all length bytes of data, throws if the connection is lost */
+		virtual void send(const char* data, size_t length) = 0;
+
+		/** receives exactly length bytes into data, throws if the connection is lost */
+		virtual void receive(char* data, size_t length) = 0;
+};
+
+/**
+ * Layout of a shared memory transport segment, to be kept in sync with sumo-launchd.py.
+ *
+ * The client creates the segment, announces its name with CMD_SHM_ATTACH on the Unix domain socket
+ * and unlinks it once the server acknowledged. Each direction is a single-producer single-consumer ring of
+ * SHM_CAPACITY bytes: the producer advances head after writing, the consumer advances tail after reading
+ * (both are total byte counts, stored as native 64 bit integers in their own cache lines).
+ * The socket stays open for the session, closing it ends the session.
+ */
+const uint8_t CMD_SHM_ATTACH = 0x76;
+const uint32_t SHM_MAGIC = 0x4d485356;
+const uint32_t SHM_VERSION = 1;
+const size_t SHM_CAPACITY = 1 << 20;
+const size_t SHM_OFFSET_TO_SERVER_HEAD = 64;
+const size_t SHM_OFFSET_TO_SERVER_TAIL = 128;
+const size_t SHM_OFFSET_TO_CLIENT_HEAD = 192;
+const size_t SHM_OFFSET_TO_CLIENT_TAIL = 256;
+const size_t SHM_OFFSET_DATA = 4096; /**< to-server ring, followed by the to-client ring */
+
+}
+
+#endif /* VEINS_MOBILITY_TRACI_TRACITRANSPORT_H_ */
@@ -0,0 +1,69 @@
+//
+// Copyright (C) 2018 Xu Le <xmutongxinXuLe@163.com>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include <chrono>
+#include <algorithm>
+
+#include "veins/modules/mobility/traci/TraCITransportBenchmark.h"
+#include "veins/modules/mobility/traci/TraCIConnection.h"
+#include "veins/modules/mobility/traci/TraCIConstants.h"
+
+using Veins::TraCITransportBenchmark;
+using Veins::TraCIConnection;
+using Veins::TraCIBuffer;
+
+Define_Module(Veins::TraCITransportBenchmark);
+
+void TraCITransportBenchmark::initialize(int stage) {
+	if (stage != 0) return;
+
+	count = 0;
+	totalLatency = 0;
+	maxLatency = 0;
+	bytes = 0;
+
+	std::string host = par("host").stdstringValue();
+	int port = par("port");
+	long rounds = par("count");
+
+	TraCIConnection* connection = TraCIConnection::connect(host.c_str(), port);
+	uint32_t requestSize = sizeof(uint32_t) + Veins::makeTraCICommand(CMD_GETVERSION).size();
+	for (; count < rounds; ++count) {
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		TraCIBuffer buf = connection->query(CMD_GETVERSION);
+		double latency = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		totalLatency += latency;
+		maxLatency = std::max(maxLatency, latency);
+		// status response (7 bytes) and header precede the version response
+		bytes += requestSize + sizeof(uint32_t) + 7 + buf.str().size();
+	}
+	delete connection;
+
+	EV_INFO << "TraCI transport " << host << ": " << count << " round trips, mean latency " << (count ? totalLatency / count * 1e6 : 0) << " us" << endl;
+}
+
+void TraCITransportBenchmark::finish() {
+	recordScalar("roundTrips", count);
+	recordScalar("meanLatency", count ? totalLatency / count : 0, "s");
+	recordScalar("maxLatency", maxLatency, "s");
+	recordScalar("messagesPerSecond", totalLatency > 0 ? count / totalLatency : 0);
+	recordScalar("bytesPerSecond", totalLatency > 0 ? bytes / totalLatency : 0);
+}
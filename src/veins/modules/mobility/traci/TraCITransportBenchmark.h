@@ -0,0 +1,59 @@
+//
+// Copyright (C) 2018 Xu Le <xmutongxinXuLe@163.com>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#ifndef WORLD_TRACI_TRACITRANSPORTBENCHMARK_H
+#define WORLD_TRACI_TRACITRANSPORTBENCHMARK_H
+
+#include <omnetpp.h>
+
+#include "veins/base/utils/MiXiMDefs.h"
+
+/**
+ * @brief
+ * Measures round trip latency and throughput of a TraCI transport.
+ *
+ * Sends count CMD_GETVERSION queries to the TraCI server at host:port during initialization
+ * and records latency and throughput as scalars. sumo-launchd.py answers these itself (without
+ * starting SUMO), so running it with host set to 127.0.0.1, unix:PATH and shm:PATH against
+ * a launcher started with --unix PATH compares the transports on the loopback.
+ *
+ * @author Xu Le
+ *
+ * @see TraCITransport
+ *
+ */
+namespace Veins {
+
+class TraCITransportBenchmark : public cSimpleModule
+{
+public:
+	virtual void initialize(int stage) override;
+	virtual void finish() override;
+
+protected:
+	long count; /**< number of round trips completed */
+	double totalLatency; /**< sum of round trip times (in s) */
+	double maxLatency; /**< longest round trip time (in s) */
+	uint64_t bytes; /**< bytes sent and received, including message headers */
+};
+
+}
+
+#endif
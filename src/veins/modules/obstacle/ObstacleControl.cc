@@ -20,15 +20,26 @@
 #include <sstream>
 #include <map>
 #include <set>
+#include <memory>
 
 #include "veins/modules/obstacle/ObstacleControl.h"
+#include "veins/modules/utility/BinaryCache.h"
+#include "veins/base/utils/StartupProfiler.h"
 
 using Veins::ObstacleControl;
+using Veins::Obstacle;
+
+namespace {
+	const uint32_t CACHE_MAGIC = 0x4f425356; // "VSBO"
+	const uint32_t CACHE_VERSION = 1;
+}
 
 Define_Module(Veins::ObstacleControl);
 
 void ObstacleControl::initialize(int stage)
 {
+	Veins::StartupProfiler::Scope profilerScope(getClassName(), "initialize", stage);
+
 	if (stage == 1)
 	{
 		obstacles.clear();
@@ -39,7 +50,20 @@ void ObstacleControl::initialize(int stage)
 
 		obstaclesXml = par("obstacles");
 
+		std::string cacheDir = par("cacheDir").stdstringValue();
+		if (cacheDir.empty()) {
+			addFromXml(obstaclesXml);
+			return;
+		}
+
+		uint64_t xmlHash = Veins::hashXmlContent(obstaclesXml);
+		std::string cacheFile = Veins::binaryCacheFileName(cacheDir, "obstacles", xmlHash);
+		if (loadCache(cacheFile, xmlHash)) {
+			EV << "ObstacleControl loaded obstacles from cache " << cacheFile << endl;
+			return;
+		}
 		addFromXml(obstaclesXml);
+		if (!saveCache(cacheFile, xmlHash)) EV_WARN << "ObstacleControl could not write obstacle cache " << cacheFile << endl;
 	}
 }
 
@@ -146,6 +170,16 @@ void ObstacleControl::add(Obstacle obstacle)
 {
 	Obstacle* o = new Obstacle(obstacle);
 
+	addToGrid(o);
+
+	// visualize using AnnotationManager
+	if (annotations) o->visualRepresentation = annotations->drawPolygon(o->getShape(), "red", annotationGroup);
+
+	cacheEntries.clear();
+}
+
+void ObstacleControl::addToGrid(Obstacle* o)
+{
 	size_t fromRow = std::max(0, int(o->getBboxP1().x / GRIDCELL_SIZE));
 	size_t toRow = std::max(0, int(o->getBboxP2().x / GRIDCELL_SIZE));
 	size_t fromCol = std::max(0, int(o->getBboxP1().y / GRIDCELL_SIZE));
@@ -157,11 +191,123 @@ void ObstacleControl::add(Obstacle obstacle)
 			(obstacles[col])[row].push_back(o);
 		}
 	}
+}
 
-	// visualize using AnnotationManager
-	if (annotations) o->visualRepresentation = annotations->drawPolygon(o->getShape(), "red", annotationGroup);
+/**
+ * cache layout (after the BinaryCacheWriter header):
+ *
+ * uint32 #types, per type: id, dB per cut, dB per meter
+ * uint32 #obstacles, per obstacle: id, type, uint32 #coords, aligned double[2 * #coords]
+ * uint32 #grid columns, per column: uint32 #rows, per cell: uint32 #entries, aligned uint32[#entries] obstacle indices
+ */
+bool ObstacleControl::loadCache(const std::string& fileName, uint64_t xmlHash)
+{
+	Veins::BinaryCacheReader reader;
+	if (!reader.open(fileName, CACHE_MAGIC, CACHE_VERSION, xmlHash)) return false;
+
+	uint32_t numTypes = reader.get<uint32_t>();
+	for (uint32_t i = 0; i < numTypes; ++i) {
+		std::string id = reader.getString();
+		perCut[id] = reader.get<double>();
+		perMeter[id] = reader.get<double>();
+	}
+
+	// obstacles are owned here until the grid is complete, so that a truncated cache does not leak them
+	uint32_t numObstacles = reader.get<uint32_t>();
+	std::vector<std::unique_ptr<Obstacle> > loaded;
+	loaded.reserve(numObstacles);
+	for (uint32_t i = 0; i < numObstacles; ++i) {
+		std::string id = reader.getString();
+		std::string type = reader.getString();
+		uint32_t numCoords = reader.get<uint32_t>();
+		const double* xy = reader.getArray<double>(2 * numCoords);
+
+		Obstacle::Coords shape;
+		shape.reserve(numCoords);
+		for (uint32_t j = 0; j < numCoords; ++j) shape.push_back(Coord(xy[2*j], xy[2*j+1]));
+
+		loaded.push_back(std::unique_ptr<Obstacle>(new Obstacle(id, type, getAttenuationPerCut(type), getAttenuationPerMeter(type))));
+		loaded.back()->setShape(shape);
+	}
+
+	// the grid is restored as stored instead of re-bucketing every obstacle
+	uint32_t numCols = reader.get<uint32_t>();
+	Obstacles grid(numCols);
+	for (uint32_t col = 0; col < numCols; ++col) {
+		uint32_t numRows = reader.get<uint32_t>();
+		grid[col].resize(numRows);
+		for (uint32_t row = 0; row < numRows; ++row) {
+			uint32_t numEntries = reader.get<uint32_t>();
+			const uint32_t* entries = reader.getArray<uint32_t>(numEntries);
+			for (uint32_t k = 0; k < numEntries; ++k) {
+				if (entries[k] >= loaded.size()) throw cRuntimeError("obstacle cache %s is corrupt", fileName.c_str());
+				(grid[col])[row].push_back(loaded[entries[k]].get());
+			}
+		}
+	}
+
+	// the grid owns the obstacles from now on
+	obstacles.swap(grid);
+	for (std::vector<std::unique_ptr<Obstacle> >::iterator i = loaded.begin(); i != loaded.end(); ++i) {
+		Obstacle* o = i->release();
+		if (annotations) o->visualRepresentation = annotations->drawPolygon(o->getShape(), "red", annotationGroup);
+	}
 
 	cacheEntries.clear();
+	return true;
+}
+
+bool ObstacleControl::saveCache(const std::string& fileName, uint64_t xmlHash) const
+{
+	Veins::BinaryCacheWriter writer(CACHE_MAGIC, CACHE_VERSION, xmlHash);
+
+	writer.put(static_cast<uint32_t>(perCut.size()));
+	for (std::map<std::string, double>::const_iterator i = perCut.begin(); i != perCut.end(); ++i) {
+		writer.putString(i->first);
+		writer.put(i->second);
+		std::map<std::string, double>::const_iterator j = perMeter.find(i->first);
+		writer.put(j != perMeter.end() ? j->second : 0.0);
+	}
+
+	// number obstacles in order of first appearance in the grid
+	std::map<const Obstacle*, uint32_t> indices;
+	std::vector<const Obstacle*> ordered;
+	for (Obstacles::const_iterator i = obstacles.begin(); i != obstacles.end(); ++i) {
+		for (ObstacleGridRow::const_iterator j = i->begin(); j != i->end(); ++j) {
+			for (ObstacleGridCell::const_iterator k = j->begin(); k != j->end(); ++k) {
+				if (indices.insert(std::make_pair(*k, static_cast<uint32_t>(ordered.size()))).second) ordered.push_back(*k);
+			}
+		}
+	}
+
+	writer.put(static_cast<uint32_t>(ordered.size()));
+	std::vector<double> xy;
+	for (std::vector<const Obstacle*>::const_iterator i = ordered.begin(); i != ordered.end(); ++i) {
+		const Obstacle::Coords& shape = (*i)->getShape();
+		writer.putString((*i)->getId());
+		writer.putString((*i)->getType());
+		writer.put(static_cast<uint32_t>(shape.size()));
+		xy.clear();
+		for (Obstacle::Coords::const_iterator c = shape.begin(); c != shape.end(); ++c) {
+			xy.push_back(c->x);
+			xy.push_back(c->y);
+		}
+		writer.putArray(xy.data(), xy.size());
+	}
+
+	writer.put(static_cast<uint32_t>(obstacles.size()));
+	std::vector<uint32_t> entries;
+	for (Obstacles::const_iterator i = obstacles.begin(); i != obstacles.end(); ++i) {
+		writer.put(static_cast<uint32_t>(i->size()));
+		for (ObstacleGridRow::const_iterator j = i->begin(); j != i->end(); ++j) {
+			entries.clear();
+			for (ObstacleGridCell::const_iterator k = j->begin(); k != j->end(); ++k) entries.push_back(indices.find(*k)->second);
+			writer.put(static_cast<uint32_t>(entries.size()));
+			writer.putArray(entries.data(), entries.size());
+		}
+	}
+
+	return writer.save(fileName);
 }
 
 void ObstacleControl::erase(const Obstacle* obstacle)
@@ -189,18 +335,44 @@ double ObstacleControl::calculateAttenuation(const Coord& senderPos, const Coord
 {
 	Enter_Method_Silent();
 
+	checkAttenuationConfigured();
+
+	// return cached result, if available
+	CacheKey cacheKey(senderPos, receiverPos);
+	CacheEntries::const_iterator cacheEntryIter = cacheEntries.find(cacheKey);
+	if (cacheEntryIter != cacheEntries.end()) return cacheEntryIter->second;
+
+	double factor = calculateUncachedAttenuation(senderPos, receiverPos, true);
+
+	// cache result
+	if (cacheEntries.size() >= 1000) cacheEntries.clear();
+	cacheEntries[cacheKey] = factor;
+
+	return factor;
+}
+
+double ObstacleControl::calculateAttenuationConcurrently(const Coord& senderPos, const Coord& receiverPos) const
+{
+	checkAttenuationConfigured();
+
+	CacheEntries::const_iterator cacheEntryIter = cacheEntries.find(CacheKey(senderPos, receiverPos));
+	if (cacheEntryIter != cacheEntries.end()) return cacheEntryIter->second;
+
+	return calculateUncachedAttenuation(senderPos, receiverPos, false);
+}
+
+void ObstacleControl::checkAttenuationConfigured() const
+{
 	if ((perCut.size() == 0) || (perMeter.size() == 0)) {
 		throw cRuntimeError("Unable to use SimpleObstacleShadowing: No obstacle types have been configured");
 	}
 	if (obstacles.size() == 0) {
 		throw cRuntimeError("Unable to use SimpleObstacleShadowing: No obstacles have been added");
 	}
+}
 
-	// return cached result, if available
-	CacheKey cacheKey(senderPos, receiverPos);
-	CacheEntries::const_iterator cacheEntryIter = cacheEntries.find(cacheKey);
-	if (cacheEntryIter != cacheEntries.end()) return cacheEntryIter->second;
-
+double ObstacleControl::calculateUncachedAttenuation(const Coord& senderPos, const Coord& receiverPos, bool annotate) const
+{
 	// calculate bounding box of transmission
 	Coord bboxP1 = Coord(std::min(senderPos.x, receiverPos.x), std::min(senderPos.y, receiverPos.y));
 	Coord bboxP2 = Coord(std::max(senderPos.x, receiverPos.x), std::max(senderPos.y, receiverPos.y));
@@ -235,7 +407,7 @@ double ObstacleControl::calculateAttenuation(const Coord& senderPos, const Coord
 				factor *= o->calculateAttenuation(senderPos, receiverPos);
 
 				// draw a "hit!" bubble
-				if (annotations && (factor != factorOld)) annotations->drawBubble(o->getBboxP1(), "hit");
+				if (annotate && annotations && (factor != factorOld)) annotations->drawBubble(o->getBboxP1(), "hit");
 
 				// bail if attenuation is already extremely high
 				if (factor < 1e-30) break;
@@ -244,10 +416,6 @@ double ObstacleControl::calculateAttenuation(const Coord& senderPos, const Coord
 		}
 	}
 
-	// cache result
-	if (cacheEntries.size() >= 1000) cacheEntries.clear();
-	cacheEntries[cacheKey] = factor;
-
 	return factor;
 }
 
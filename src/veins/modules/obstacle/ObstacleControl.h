@@ -51,8 +51,18 @@ public:
 	void handleSelfMsg(cMessage *msg);
 
 	void addFromXml(cXMLElement* xml);
+	/**
+	 * load obstacle types, obstacles and the grid from a binary cache written by saveCache, returns false if it does not exist or is stale
+	 */
+	bool loadCache(const std::string& fileName, uint64_t xmlHash);
+	/**
+	 * write obstacle types, obstacles and the grid to a binary cache keyed by the hash of the obstacles XML
+	 */
+	bool saveCache(const std::string& fileName, uint64_t xmlHash) const;
 	void addFromTypeAndShape(std::string id, std::string typeId, std::vector<Coord> shape);
 	void add(Obstacle obstacle);
+	/** put an obstacle into all grid cells its bounding box overlaps */
+	void addToGrid(Obstacle* o);
 	void erase(const Obstacle* obstacle);
 	bool isTypeSupported(std::string type);
 	double getAttenuationPerCut(std::string type);
@@ -62,6 +72,11 @@ public:
 	 * calculate additional attenuation by obstacles, return signal strength
 	 */
 	double calculateAttenuation(const Coord& senderPos, const Coord& receiverPos) const;
+	/**
+	 * same as calculateAttenuation, but safe to call from several threads at once: only reads the cache
+	 * and draws no annotations (so the main thread must not call calculateAttenuation meanwhile)
+	 */
+	double calculateAttenuationConcurrently(const Coord& senderPos, const Coord& receiverPos) const;
 
 protected:
 	struct CacheKey {
@@ -99,6 +114,11 @@ protected:
 	std::map<std::string, double> perCut;
 	std::map<std::string, double> perMeter;
 	mutable CacheEntries cacheEntries;
+
+	/** throws if obstacle shadowing cannot be calculated */
+	void checkAttenuationConfigured() const;
+	/** calculate attenuation by obstacles without using the cache, drawing annotations of hits if annotate is set */
+	double calculateUncachedAttenuation(const Coord& senderPos, const Coord& receiverPos, bool annotate) const;
 };
 
 class ObstacleControlAccess
@@ -46,7 +46,14 @@ simtime_t Decider80211p::processNewSignal(AirFrame* msg)
 	start.setTime(signal.getReceptionStart());
 	start.setArgValue(Dimension::frequency(), centerFrequency);
 
-	signalStates[frame] = EXPECT_END;
+	frame->setSignalState(EXPECT_END);
+
+	if (incrementalCca)
+	{
+		frame->setCcaPower(calcCcaPower(frame));
+		ccaPowerSum += frame->getCcaPower();
+		ccaFrames++;
+	}
 
 	double recvPower = signal.getReceivingPower()->getValue(start);
 
@@ -55,13 +62,14 @@ simtime_t Decider80211p::processNewSignal(AirFrame* msg)
 		// annotate the frame, so that we won't try decoding it at its end
 		frame->setUnderSensitivity(true);
 		// check channel busy status. a superposition of low power frames might turn channel status to busy
-		if (cca(simTime(), NULL) == false)
+		if ((!incrementalCca || isChannelIdle) && cca(simTime(), NULL) == false)
 			setChannelIdleStatus(false);
 		return signal.getReceptionEnd();
 	}
 	else
 	{
-		setChannelIdleStatus(false);
+		if (!incrementalCca || isChannelIdle)
+			setChannelIdleStatus(false);
 
 		if (phy11p->getRadioState() == Radio::TX)
 		{
@@ -93,9 +101,21 @@ simtime_t Decider80211p::processNewSignal(AirFrame* msg)
 	}
 }
 
+double Decider80211p::calcCcaPower(AirFrame* frame)
+{
+	Signal& signal = frame->getSignal();
+
+	// where cca() looks at the receiving power
+	Argument start(DimensionSet::timeFreqDomain());
+	start.setTime(signal.getReceptionStart());
+	start.setArgValue(Dimension::frequency(), centerFrequency - 5e6);
+
+	return signal.getReceivingPower()->getValue(start);
+}
+
 int Decider80211p::getSignalState(AirFrame* frame)
 {
-	return signalStates.find(frame) == signalStates.end() ? NEW : signalStates[frame];
+	return check_and_cast<AirFrame11p*>(frame)->getSignalState();
 }
 
 double Decider80211p::calcChannelSenseRSSI(simtime_t_cref start, simtime_t_cref end)
@@ -114,32 +134,39 @@ double Decider80211p::calcChannelSenseRSSI(simtime_t_cref start, simtime_t_cref
 	return rssi;
 }
 
-void Decider80211p::calculateSinrAndSnrMapping(AirFrame* frame, Mapping **sinrMap, Mapping **snrMap)
+void Decider80211p::calculateSinrAndSnrMin(AirFrame* frame, const Argument& min, const Argument& max, double* sinrMin, double* snrMin)
 {
-	/* calculate Noise-Strength-Mapping */
 	Signal& signal = frame->getSignal();
 
 	simtime_t start = signal.getReceptionStart();
 	simtime_t end   = signal.getReceptionEnd();
 
-	// call BaseDecider function to get Noise plus Interference mapping
-	Mapping* noiseInterferenceMap = calculateRSSIMapping(start, end, frame);
-	assert(noiseInterferenceMap);
-	// call calculateNoiseRSSIMapping() to get Noise only mapping
-	Mapping* noiseMap = calculateNoiseRSSIMapping(start, end, frame);
-	assert(noiseMap);
 	// get power map for frame currently under reception
 	ConstMapping* recvPowerMap = signal.getReceivingPower();
 	assert(recvPowerMap);
 
+	// call BaseDecider function to get Noise plus Interference mapping
+	Mapping* noiseInterferenceMap = calculateRSSIMapping(start, end, frame);
+	assert(noiseInterferenceMap);
+
 	// TODO: handle noise of zero (must not devide with zero!)
-	*sinrMap = MappingUtils::divide( *recvPowerMap, *noiseInterferenceMap, Argument::MappedZero() );
-	*snrMap = MappingUtils::divide( *recvPowerMap, *noiseMap, Argument::MappedZero() );
+	// only the minimum is needed, so divide lazily instead of creating the SINR mapping
+	*sinrMin = MappingUtils::findMin(QuotientMapping(*recvPowerMap, *noiseInterferenceMap, false, Argument::MappedZero()), min, max);
 
 	delete noiseInterferenceMap;
 	noiseInterferenceMap = 0;
-	delete noiseMap;
-	noiseMap = 0;
+
+	if (snrMin)
+	{
+		// call calculateNoiseRSSIMapping() to get Noise only mapping
+		Mapping* noiseMap = calculateNoiseRSSIMapping(start, end, frame);
+		assert(noiseMap);
+
+		*snrMin = MappingUtils::findMin(QuotientMapping(*recvPowerMap, *noiseMap, false, Argument::MappedZero()), min, max);
+
+		delete noiseMap;
+		noiseMap = 0;
+	}
 }
 
 Mapping* Decider80211p::calculateNoiseRSSIMapping(simtime_t_cref start, simtime_t_cref end, AirFrame *exclude)
@@ -179,18 +206,6 @@ Mapping* Decider80211p::calculateNoiseRSSIMapping(simtime_t_cref start, simtime_
 
 DeciderResult* Decider80211p::checkIfSignalOk(AirFrame* frame)
 {
-	Mapping *sinrMap = nullptr;
-	Mapping *snrMap = nullptr;
-
-	if (collectCollisionStats)
-	{
-		calculateSinrAndSnrMapping(frame, &sinrMap, &snrMap);
-		assert(snrMap);
-	}
-	else
-		sinrMap = calculateSnrMapping(frame);
-	assert(sinrMap);
-
 	Signal& s = frame->getSignal();
 	simtime_t start = s.getReceptionStart();
 	simtime_t end = s.getReceptionEnd();
@@ -210,8 +225,9 @@ DeciderResult* Decider80211p::checkIfSignalOk(AirFrame* frame)
 	max.setTime(end);
 	max.setArgValue(Dimension::frequency(), centerFrequency + 5e6);
 
-	double sinrMin = MappingUtils::findMin(*sinrMap, min, max);
-	double snrMin = collectCollisionStats ? MappingUtils::findMin(*snrMap, min, max) : 1e6;
+	double sinrMin;
+	double snrMin = 1e6;
+	calculateSinrAndSnrMin(frame, min, max, &sinrMin, collectCollisionStats ? &snrMin : nullptr);
 
 	ConstMappingIterator* bitrateIt = s.getBitrate()->createConstIterator();
 	bitrateIt->next(); // iterate to payload bitrate indicator
@@ -252,9 +268,6 @@ DeciderResult* Decider80211p::checkIfSignalOk(AirFrame* frame)
 		ASSERT2(false, "Impossible packet result returned by packetOk(). Check the code.");
 	}
 
-	delete sinrMap;
-	if (snrMap)
-		delete snrMap;
 	return result;
 }
 
@@ -326,6 +339,22 @@ enum Decider80211p::PACKET_OK_RESULT Decider80211p::packetOk(double sinrMin, dou
 
 bool Decider80211p::cca(simtime_t_cref time, AirFrame* exclude)
 {
+	if (incrementalCca)
+	{
+		ccaComputationsAvoided++;
+
+		double power = ccaPowerSum;
+		if (exclude)
+			power -= check_and_cast<AirFrame11p*>(exclude)->getCcaPower();
+
+		ConstMapping* thermalNoise = phy->getThermalNoise(time, time);
+		if (thermalNoise)
+			power += thermalNoise->getValue(Argument(time));
+
+		DBG_D11P << power << " > " << ccaThreshold << " = " << (bool)(power > ccaThreshold) << std::endl;
+		return power < ccaThreshold;
+	}
+
 	AirFrameVector airFrames;
 
 	// collect all AirFrames that intersect with [start, end]
@@ -405,7 +434,16 @@ simtime_t Decider80211p::processSignalEnd(AirFrame* msg)
 	bool whileSending = false, notSynchronized = false;
 
 	// remove this frame from our current signals
-	signalStates.erase(frame);
+	frame->setSignalState(NEW);
+
+	if (incrementalCca)
+	{
+		ccaPowerSum -= frame->getCcaPower();
+		frame->setCcaPower(0);
+		// start over from zero, without the rounding errors of adding and subtracting, once the channel is empty
+		if (--ccaFrames == 0)
+			ccaPowerSum = 0;
+	}
 
 	DeciderResult* result;
 
@@ -511,6 +549,27 @@ void Decider80211p::setChannelIdleStatus(bool isIdle)
 void Decider80211p::changeFrequency(double freq)
 {
 	centerFrequency = freq;
+
+	if (incrementalCca)
+	{
+		// the frames currently received have another receiving power on the new frequency
+		AirFrameVector airFrames;
+		getChannelInfo(simTime(), simTime(), airFrames);
+
+		ccaPowerSum = 0;
+		for (AirFrameVector::const_iterator it = airFrames.begin(); it != airFrames.end(); ++it)
+		{
+			AirFrame11p* frame = check_and_cast<AirFrame11p*>(*it);
+			if (frame->getSignalState() != EXPECT_END)
+				continue;
+
+			frame->setCcaPower(calcCcaPower(frame));
+			ccaPowerSum += frame->getCcaPower();
+		}
+
+		// the MAC takes the new channel as idle, so the next busy channel has to be notified again
+		isChannelIdle = true;
+	}
 }
 
 double Decider80211p::getCCAThreshold()
@@ -557,6 +616,8 @@ void Decider80211p::finish()
 	// phy->recordScalar("busyTime", myBusyTime / totalTime.dbl());
 	if (collectCollisionStats)
 		phy->recordScalar("ncollisions", collisions);
+	if (incrementalCca)
+		phy->recordScalar("ccaComputationsAvoided", ccaComputationsAvoided);
 }
 
 Decider80211p::~Decider80211p()
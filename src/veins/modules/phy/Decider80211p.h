@@ -107,7 +107,6 @@ protected:
 
     std::string myPath;
     Decider80211pToPhy80211pInterface* phy11p;
-    std::map<AirFrame*,int> signalStates;
 
     /** @brief enable/disable statistics collection for collisions
      *
@@ -123,6 +122,25 @@ protected:
     /** @brief notify PHY-RXSTART.indication  */
     bool notifyRxStart;
 
+    /** @brief maintain the CCA energy sum at frame start and end instead of summing up all frames at every CCA
+     *
+     * Every frame adds its receiving power at the start of its reception to the sum,
+     * so CCA only decides like the full computation if the receiving power of a frame
+     * does not change during its reception (e.g., with path loss and obstacle shadowing,
+     * but not with fading). The MAC is then only notified of the channel turning busy
+     * if it was idle before.
+     */
+    bool incrementalCca;
+
+    /** @brief receiving power of all frames currently received, for incremental CCA */
+    double ccaPowerSum;
+
+    /** @brief number of frames adding to ccaPowerSum */
+    unsigned int ccaFrames;
+
+    /** @brief number of CCAs decided on ccaPowerSum instead of summing up all frames */
+    long ccaComputationsAvoided;
+
 protected:
     /**
      * @brief Checks a mapping against a specific threshold (element-wise).
@@ -160,16 +178,19 @@ protected:
     virtual double calcChannelSenseRSSI(simtime_t_cref min, simtime_t_cref max);
 
     /**
-     * @brief Calculates a SNR-Mapping for a Signal.
+     * @brief Calculates the minimum SINR and SNR of a Signal between min and max.
      *
-     * This method works as the calculateSnrMapping of the BaseDecider class,
-     * but it return the mapping for both SNR and SINR. This method is used
-     * to determine the frame reception probability for both SNR and SINR
-     * values. In this way we can determine (still probabilistically) if
-     * a frame has been dropped due to low signal power or due to a collision
+     * This method works as finding the minimum of the calculateSnrMapping of the
+     * BaseDecider class, but it returns the minimum for both SINR and, if snrMin
+     * is not null, SNR. This method is used to determine the frame reception
+     * probability for both SNR and SINR values. In this way we can determine
+     * (still probabilistically) if a frame has been dropped due to low signal
+     * power or due to a collision
      *
+     * The minima are found on lazy quotients of the receiving power and the noise,
+     * without creating SINR or SNR mappings.
      */
-    virtual void calculateSinrAndSnrMapping(AirFrame* frame, Mapping **sinrMap, Mapping **snrMap);
+    virtual void calculateSinrAndSnrMin(AirFrame* frame, const Argument& min, const Argument& max, double* sinrMin, double* snrMin);
 
     /**
      * @brief Calculates a RSSI-Mapping (or Noise-Strength-Mapping) for a
@@ -184,6 +205,12 @@ protected:
      */
     Mapping* calculateNoiseRSSIMapping(simtime_t_cref start, simtime_t_cref end, AirFrame *frame);
 
+    /**
+     * @brief Returns the receiving power of the frame at the start of its reception
+     * where CCA measures it, for incremental CCA.
+     */
+    double calcCcaPower(AirFrame* frame);
+
 public:
     /**
      * @brief Initializes the Decider with a pointer to its PhyLayer and
@@ -196,7 +223,8 @@ public:
                   double centerFrequency,
                   int myIndex = -1,
                   bool collectCollisionStatistics = false,
-                  bool debug = false) :
+                  bool debug = false,
+                  bool incrementalCca = false) :
         BaseDecider(phy, sensitivity, myIndex, debug),
         ccaThreshold(ccaThreshold),
         allowTxDuringRx(allowTxDuringRx),
@@ -205,7 +233,11 @@ public:
         myStartTime(simTime().dbl()),
         collectCollisionStats(collectCollisionStatistics),
         collisions(0),
-		notifyRxStart(false)
+		notifyRxStart(false),
+        incrementalCca(incrementalCca),
+        ccaPowerSum(0),
+        ccaFrames(0),
+        ccaComputationsAvoided(0)
     {
         phy11p = dynamic_cast<Decider80211pToPhy80211pInterface*>(phy);
         assert(phy11p);
@@ -48,6 +48,7 @@ void PhyLayer80211p::initialize(int stage) {
 		ccaThreshold = pow(10, par("ccaThreshold").doubleValue() / 10);
 		allowTxDuringRx = par("allowTxDuringRx").boolValue();
 		collectCollisionStatistics = par("collectCollisionStatistics").boolValue();
+		incrementalCca = par("incrementalCca").boolValue();
 	}
 	BasePhyLayer::initialize(stage);
 	if (stage == 0) {
@@ -59,6 +60,17 @@ void PhyLayer80211p::initialize(int stage) {
 	}
 }
 
+void PhyLayer80211p::reinitialize(int stage) {
+	if (stage == 0) {
+		ccaThreshold = pow(10, par("ccaThreshold").doubleValue() / 10);
+		allowTxDuringRx = par("allowTxDuringRx").boolValue();
+		collectCollisionStatistics = par("collectCollisionStatistics").boolValue();
+		incrementalCca = par("incrementalCca").boolValue();
+	}
+	// the RadioStateAnalogueModel was erased from analogueModels in initialize(), so only radio and decider are renewed
+	BasePhyLayer::reinitialize(stage);
+}
+
 AnalogueModel* PhyLayer80211p::getAnalogueModelFromName(std::string name, ParameterMap& params)
 {
 	if (name == "SimplePathlossModel")
@@ -370,7 +382,7 @@ AnalogueModel* PhyLayer80211p::initializeSimpleObstacleShadowing(ParameterMap& p
 
 Decider* PhyLayer80211p::initializeDecider80211p(ParameterMap& params) {
 	double centerFreq = params["centerFrequency"];
-	Decider80211p* dec = new Decider80211p(this, sensitivity, ccaThreshold, allowTxDuringRx, centerFreq, findHost()->getIndex(), collectCollisionStatistics, coreDebug);
+	Decider80211p* dec = new Decider80211p(this, sensitivity, ccaThreshold, allowTxDuringRx, centerFreq, findHost()->getIndex(), collectCollisionStatistics, coreDebug, incrementalCca);
 	dec->setPath(getParentModule()->getFullPath());
 	return dec;
 }
@@ -52,6 +52,11 @@ class PhyLayer80211p : public BasePhyLayer, public Mac80211pToPhy11pInterface, p
 {
 public:
     void initialize(int stage);
+    /**
+     * @brief Re-reads the parameters the decider is built from before
+     * BasePhyLayer re-creates it.
+     */
+    virtual void reinitialize(int stage);
     /**
      * @brief Set the carrier sense threshold
      * @param ccaThreshold_dBm the cca threshold in dBm
@@ -84,6 +89,9 @@ protected:
      */
     bool allowTxDuringRx;
 
+    /** @brief maintain the CCA energy sum incrementally. See Decider80211p for details */
+    bool incrementalCca;
+
     enum ProtocolIds {
         IEEE_80211 = 12123
     };
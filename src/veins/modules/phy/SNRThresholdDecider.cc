@@ -171,15 +171,25 @@ simtime_t SNRThresholdDecider::canAnswerCSR(const CSRInfo& requestInfo) {
 	return answerTime;
 }
 
-simtime_t SNRThresholdDecider::processSignalEnd(AirFrame* frame)
+bool SNRThresholdDecider::checkIfFrameAboveThreshold(AirFrame* frame, simtime_t_cref start, simtime_t_cref end)
 {
-	assert(frame == currentSignal.first);
-	// here the Signal is finally processed
+	if (!debug) return isSnrAbove(frame, start, end, snrThreshold);
 
-	// first collect all necessary information
+	// create the SNR mapping to print its values while checking it
 	Mapping* snrMap = calculateSnrMapping(frame);
 	assert(snrMap);
 
+	bool aboveThreshold = checkIfAboveThreshold(snrMap, start, end);
+
+	delete snrMap;
+	return aboveThreshold;
+}
+
+simtime_t SNRThresholdDecider::processSignalEnd(AirFrame* frame)
+{
+	assert(frame == currentSignal.first);
+	// here the Signal is finally processed
+
 	const Signal& signal = frame->getSignal();
 	simtime_t start = signal.getReceptionStart();
 	simtime_t end = signal.getReceptionEnd();
@@ -189,9 +199,7 @@ simtime_t SNRThresholdDecider::processSignalEnd(AirFrame* frame)
 	// to reject reception of the signal.
 	// Since the default MiXiM-signal is still zero at its exact start and end, these points
 	// are ignored in the interval passed to the following method.
-	bool aboveThreshold = checkIfAboveThreshold(snrMap,
-												MappingUtils::post(start),
-												MappingUtils::pre(end));
+	bool aboveThreshold = checkIfFrameAboveThreshold(frame, MappingUtils::post(start), MappingUtils::pre(end));
 
 	// check if the snrMapping is above the Decider's specific threshold,
 	// i.e. the Decider has received it correctly
@@ -205,10 +213,6 @@ simtime_t SNRThresholdDecider::processSignalEnd(AirFrame* frame)
 		deciderEV << "SNR is below threshold("<<snrThreshold<<") -> dropped." << endl;
 	}
 
-	delete snrMap;
-	snrMap = 0;
-
-
 	// we have processed this AirFrame and we prepare to receive the next one
 	currentSignal.first = 0;
 
@@ -52,9 +52,22 @@ protected:
 	 * @return	true	, if every entry of the mapping is above threshold
 	 * 			false	, otherwise
 	 *
+	 * Only used by the default checkIfFrameAboveThreshold() with debug
+	 * output on, so it is not virtual; override checkIfFrameAboveThreshold()
+	 * to change the decision instead.
+	 */
+	bool checkIfAboveThreshold(Mapping* map, simtime_t_cref start, simtime_t_cref end);
+
+	/**
+	 * @brief Checks whether the SNR of a frame is above snrThreshold
+	 * during the passed interval; decides whether processSignalEnd()
+	 * sends the frame up.
 	 *
+	 * Without debug output this avoids building the SNR mapping; with
+	 * it, the mapping is built and checked by checkIfAboveThreshold()
+	 * so its values are printed.
 	 */
-	virtual bool checkIfAboveThreshold(Mapping* map, simtime_t_cref start, simtime_t_cref end);
+	virtual bool checkIfFrameAboveThreshold(AirFrame* frame, simtime_t_cref start, simtime_t_cref end);
 
 	/**
 	 * @brief Processes a new Signal. Returns the time it wants to
@@ -49,6 +49,9 @@ void BaseRSU::initialize(int stage)
 		U2URadius = BaseConnectionManager::maxInterferenceDistance2;
 
 		dataOnSch = par("dataOnSch").boolValue();
+		flowMode = par("flowMode").boolValue();
+		flowModel = flowMode ? new BackboneFlowModel(this, BaseRSUMsgKinds::FLOW_END_EVT, wiredHeaderLength) : nullptr;
+		wiredBits = 0;
 
 		whichSide = par("whichSide").longValue();
 
@@ -67,6 +70,15 @@ void BaseRSU::finish()
 {
 	EV << "base RSU module finish ..." << std::endl;
 
+	recordScalar("wiredBits", wiredBits);
+	if (flowModel != nullptr)
+	{
+		recordScalar("flowsStarted", flowModel->flowsStarted);
+		recordScalar("flowsCompleted", flowModel->flowsCompleted);
+		recordScalar("flowBytesCompleted", flowModel->bytesCompleted);
+		DELETE_SAFELY(flowModel);
+	}
+
 	// clear containers
 	for (itV = vehicles.begin(); itV != vehicles.end(); ++itV)
 		delete itV->second;
@@ -103,18 +115,21 @@ void BaseRSU::handleMessage(cMessage *msg)
 	else if (msg->getArrivalGateId() == wiredIn)
 	{
 		WiredMessage *wiredMsg = dynamic_cast<WiredMessage*>(msg);
+		wiredBits += wiredMsg->getBitLength() + 8*BackboneFlowModel::countReceived(wiredMsg);
 		handleWiredMsg(wiredMsg);
 		DELETE_SAFELY(wiredMsg);
 	}
 	else if (msg->getArrivalGateId() == westIn)
 	{
 		WiredMessage *wiredMsg = dynamic_cast<WiredMessage*>(msg);
+		wiredBits += wiredMsg->getBitLength() + 8*BackboneFlowModel::countReceived(wiredMsg);
 		handleWestMsg(wiredMsg);
 		DELETE_SAFELY(wiredMsg);
 	}
 	else if (msg->getArrivalGateId() == eastIn)
 	{
 		WiredMessage *wiredMsg = dynamic_cast<WiredMessage*>(msg);
+		wiredBits += wiredMsg->getBitLength() + 8*BackboneFlowModel::countReceived(wiredMsg);
 		handleEastMsg(wiredMsg);
 		DELETE_SAFELY(wiredMsg);
 	}
@@ -140,6 +155,12 @@ void BaseRSU::handleSelfMsg(cMessage *msg)
 		scheduleAt(simTime() + forgetMemoryInterval, forgetMemoryEvt);
 		break;
 	}
+	case BaseRSUMsgKinds::FLOW_END_EVT:
+	{
+		ASSERT(flowModel != nullptr);
+		flowModel->handleEndEvt(msg);
+		break;
+	}
 	default:
 		EV_WARN << "Warning: Got Self Message of unknown kind! Name: " << msg->getName() << endl;
 	}
@@ -155,6 +176,14 @@ void BaseRSU::handleLowerMsg(cMessage *msg)
 	//	EV << "unknown message (" << msg->getName() << ") received.\n";
 }
 
+void BaseRSU::sendBulk(int gateId, WiredMessage *wiredMsg, int64_t bytes)
+{
+	if (flowModel != nullptr)
+		flowModel->startFlow(gateId, wiredMsg, bytes);
+	else
+		BackboneFlowModel::sendPacket(this, gateId, wiredMsg, bytes, wiredHeaderLength);
+}
+
 void BaseRSU::prepareWSM(WaveShortMessage *wsm, int dataLength, t_channel channel, int priority, LAddress::L2Type recipient)
 {
 	ASSERT(wsm != nullptr);
@@ -22,6 +22,7 @@
 #include "veins/base/modules/BaseApplLayer.h"
 #include "veins/base/connectionManager/BaseConnectionManager.h"
 #include "veins/modules/utility/Utils.h"
+#include "veins/modules/utility/BackboneFlowModel.h"
 #include "veins/modules/messages/WiredMessage_m.h"
 #include "veins/modules/messages/BeaconMessage_m.h"
 #include "veins/modules/mac/ieee80211p/WaveAppToMac1609_4Interface.h"
@@ -44,6 +45,7 @@ public:
 	enum BaseRSUMsgKinds {
 		EXAMINE_VEHICLES_EVT = LAST_BASE_APPL_MESSAGE_KIND,
 		FORGET_MEMORY_EVT,
+		FLOW_END_EVT,
 		LAST_BASE_RSU_MESSAGE_KIND
 	};
 
@@ -77,6 +79,8 @@ protected:
 	void handleSouthMsg(WiredMessage *wiredMsg) { handleRSUMsg(wiredMsg, 4); }
 	/** @brief Handle west/east RSU messages, param 'direction': west is 1, east is 2, north is 3, south is 4. */
 	virtual void handleRSUMsg(WiredMessage *wiredMsg, int direction) {}
+	/** @brief Send a bulk transfer of 'bytes' bytes through wired output gate 'gateId', as a backbone flow in flow mode and as one data packet otherwise. */
+	void sendBulk(int gateId, WiredMessage *wiredMsg, int64_t bytes);
 
 	/** @brief wave short message factory method. */
 	void prepareWSM(WaveShortMessage *wsm, int dataLength, t_channel channel, int priority, LAddress::L2Type recipient=-1);
@@ -124,6 +128,7 @@ protected:
 	int wiredHeaderLength; ///< length of the IP packet header.
 
 	bool dataOnSch;   ///< whether send data on service channel.
+	bool flowMode;    ///< whether bulk wired transfers are represented as fluid flows rather than individual packets.
 
 	int whichSide;         ///< which side direction relative to road this RSU locate.
 
@@ -147,6 +152,8 @@ protected:
 
 	WaveAppToMac1609_4Interface *myMac;
 	Veins::AnnotationManager *annotations;
+	BackboneFlowModel *flowModel; ///< fluid model of bulk wired transfers, only exists in flow mode.
+	int64_t wiredBits; ///< number of bits received through wired gates, including the bytes of completed backbone flows.
 };
 
 #endif /* __BASERSU_H__ */
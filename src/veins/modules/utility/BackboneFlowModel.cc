@@ -0,0 +1,199 @@
+//
+// Copyright (C) 2018 Xu Le <xmutongxinXuLe@163.com>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "veins/modules/utility/BackboneFlowModel.h"
+
+BackboneFlowModel::BackboneFlowModel(cSimpleModule *owner, short endEvtKind, int headerLength)
+	: flowsStarted(0), flowsCompleted(0), bytesCompleted(0),
+	  owner(owner), endEvtKind(endEvtKind), headerLength(headerLength), nextFlowId(0)
+{
+	ASSERT(owner != nullptr);
+}
+
+BackboneFlowModel::~BackboneFlowModel()
+{
+	clear();
+}
+
+int BackboneFlowModel::startFlow(int gateId, WiredMessage *startMsg, int64_t bytes)
+{
+	ASSERT(startMsg != nullptr);
+	ASSERT(bytes > 0);
+
+	Flow *flow = new Flow;
+	flow->flowId = nextFlowId++;
+	flow->gateId = gateId;
+	flow->remainingBits = 8.0 * bytes;
+	flow->startAt = simTime();
+	flow->lastUpdate = simTime();
+	flow->endEvt = new cMessage("flow end evt", endEvtKind);
+	flow->endEvt->setContextPointer(flow);
+
+	startMsg->setControlCode(WiredMsgCC::START_TRANSMISSION);
+	startMsg->setFlowId(flow->flowId);
+	startMsg->setBytesNum(bytes);
+	startMsg->setBitLength(headerLength);
+	flow->endMsg = startMsg->dup();
+	flow->endMsg->setControlCode(WiredMsgCC::END_TRANSMISSION);
+
+	EV << "backbone flow " << flow->flowId << " of " << bytes << " bytes starts on gate " << owner->gate(gateId)->getFullName() << ".\n";
+
+	// the shares of the flows already on this link are recomputed before the new one joins
+	reshare(gateId);
+	links[gateId].push_back(flow);
+	flows.insert(std::pair<int, Flow*>(flow->flowId, flow));
+	reshare(gateId);
+
+	++flowsStarted;
+	sendWhenIdle(owner, startMsg, gateId);
+	return flow->flowId;
+}
+
+bool BackboneFlowModel::handleEndEvt(cMessage *msg)
+{
+	if (msg->getKind() != endEvtKind)
+		return false;
+
+	Flow *flow = static_cast<Flow*>(msg->getContextPointer());
+	std::map<int, Flow*>::iterator itF = flows.find(flow->flowId);
+	ASSERT(itF != flows.end() && itF->second->endEvt == msg);
+
+	int gateId = flow->gateId;
+	EV << "backbone flow " << flow->flowId << " completes after " << simTime() - flow->startAt << "s.\n";
+
+	++flowsCompleted;
+	bytesCompleted += flow->endMsg->getBytesNum();
+	sendWhenIdle(owner, flow->endMsg, gateId);
+	flow->endMsg = nullptr;
+
+	reshare(gateId);
+	removeFlow(itF);
+	reshare(gateId);
+	return true;
+}
+
+void BackboneFlowModel::abortFlow(int flowId)
+{
+	std::map<int, Flow*>::iterator itF = flows.find(flowId);
+	if (itF == flows.end())
+		return;
+
+	int gateId = itF->second->gateId;
+	reshare(gateId);
+	removeFlow(itF);
+	reshare(gateId);
+}
+
+simtime_t BackboneFlowModel::predictCompletion(int flowId) const
+{
+	std::map<int, Flow*>::const_iterator itF = flows.find(flowId);
+	if (itF == flows.end())
+		return SIMTIME_ZERO;
+	return itF->second->endEvt->getArrivalTime();
+}
+
+size_t BackboneFlowModel::activeFlows(int gateId) const
+{
+	std::map<int, std::list<Flow*> >::const_iterator itL = links.find(gateId);
+	return itL != links.end() ? itL->second.size() : 0;
+}
+
+void BackboneFlowModel::clear()
+{
+	while (!flows.empty())
+		removeFlow(flows.begin());
+	links.clear();
+}
+
+double BackboneFlowModel::capacityOf(int gateId) const
+{
+	cChannel *channel = owner->gate(gateId)->getTransmissionChannel();
+	if (channel == nullptr || channel->getNominalDatarate() <= 0)
+		throw cRuntimeError("backbone flow model requires a datarate channel on gate %s", owner->gate(gateId)->getFullName());
+	return channel->getNominalDatarate();
+}
+
+void BackboneFlowModel::reshare(int gateId)
+{
+	std::map<int, std::list<Flow*> >::iterator itL = links.find(gateId);
+	if (itL == links.end() || itL->second.empty())
+		return;
+
+	std::list<Flow*>& linkFlows = itL->second; // alias
+	const simtime_t now = simTime();
+	const double share = capacityOf(gateId) / linkFlows.size();
+	for (std::list<Flow*>::iterator itF = linkFlows.begin(); itF != linkFlows.end(); ++itF)
+	{
+		Flow *flow = *itF;
+		flow->remainingBits -= flow->rate * (now - flow->lastUpdate).dbl();
+		if (flow->remainingBits < 0.0)
+			flow->remainingBits = 0.0;
+		flow->lastUpdate = now;
+		flow->rate = share;
+
+		owner->cancelEvent(flow->endEvt);
+		owner->scheduleAt(now + flow->remainingBits / flow->rate, flow->endEvt);
+	}
+}
+
+void BackboneFlowModel::sendPacket(cSimpleModule *owner, int gateId, WiredMessage *dataMsg, int64_t bytes, int headerLength)
+{
+	ASSERT(dataMsg != nullptr);
+
+	dataMsg->setControlCode(WiredMsgCC::LAST_DATA_PACKET);
+	dataMsg->setBytesNum(bytes);
+	dataMsg->setBitLength(headerLength + 8*bytes);
+	sendWhenIdle(owner, dataMsg, gateId);
+}
+
+int64_t BackboneFlowModel::countReceived(WiredMessage *wiredMsg)
+{
+	if (wiredMsg->getFlowId() < 0)
+		return 0; // packet mode, the bit length already covers the payload
+
+	if (wiredMsg->getControlCode() == WiredMsgCC::START_TRANSMISSION)
+	{
+		EV << "backbone flow " << wiredMsg->getFlowId() << " of " << wiredMsg->getBytesNum() << " bytes starts arriving.\n";
+		return 0;
+	}
+	if (wiredMsg->getControlCode() == WiredMsgCC::END_TRANSMISSION)
+	{
+		EV << "backbone flow " << wiredMsg->getFlowId() << " has arrived completely.\n";
+		return wiredMsg->getBytesNum();
+	}
+	return 0;
+}
+
+void BackboneFlowModel::sendWhenIdle(cSimpleModule *owner, WiredMessage *msg, int gateId)
+{
+	cChannel *channel = owner->gate(gateId)->getTransmissionChannel();
+	simtime_t delay = SIMTIME_ZERO;
+	if (channel != nullptr && channel->getTransmissionFinishTime() > simTime())
+		delay = channel->getTransmissionFinishTime() - simTime();
+	owner->sendDelayed(msg, delay, gateId);
+}
+
+void BackboneFlowModel::removeFlow(std::map<int, Flow*>::iterator itF)
+{
+	Flow *flow = itF->second;
+	links[flow->gateId].remove(flow);
+	owner->cancelAndDelete(flow->endEvt);
+	delete flow->endMsg;
+	delete flow;
+	flows.erase(itF);
+}
@@ -0,0 +1,124 @@
+//
+// Copyright (C) 2018 Xu Le <xmutongxinXuLe@163.com>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#ifndef __BACKBONEFLOWMODEL_H__
+#define __BACKBONEFLOWMODEL_H__
+
+#include <map>
+#include <list>
+
+#include "veins/base/utils/MiXiMDefs.h"
+#include "veins/modules/messages/WiredMessage_m.h"
+
+/**
+ * @brief Fluid (flow-level) model of bulk transfers over the wired backbone.
+ *
+ * Instead of sending a bulk transfer as thousands of individual WiredMessages,
+ * the owner module hands it to this model which sends one START_TRANSMISSION
+ * message, computes the completion time analytically and sends one
+ * END_TRANSMISSION message carrying the total amount of bytes at that time.
+ *
+ * All flows leaving through the same output gate share the nominal datarate
+ * of the gate's channel equally (processor sharing), so the completion times
+ * of the remaining flows are recomputed whenever a flow starts or ends.
+ * Packet mode messages sent by the owner over the same gate are not taken
+ * into account by the bandwidth sharing.
+ *
+ * Owners route their bulk transfers through startFlow() in flow mode and
+ * through sendPacket() otherwise, receivers use countReceived() to account
+ * for the bytes a flow carries in addition to its control messages.
+ *
+ * @author Xu Le
+ * @ingroup waveAppLayer
+ */
+class BackboneFlowModel
+{
+public:
+	/** @brief The state of an active flow. */
+	class Flow
+	{
+	public:
+		Flow() : flowId(-1), gateId(-1), remainingBits(0.0), rate(0.0), endEvt(nullptr), endMsg(nullptr) {}
+
+		int flowId;    ///< identifier of this flow.
+		int gateId;    ///< the output gate this flow leaves through.
+		double remainingBits; ///< bits still to transmit as of lastUpdate.
+		double rate;   ///< current share of the link capacity in bps.
+		simtime_t startAt;    ///< when this flow started.
+		simtime_t lastUpdate; ///< when remainingBits was last brought up to date.
+		cMessage *endEvt;     ///< self message scheduled at the predicted completion time.
+		WiredMessage *endMsg; ///< END_TRANSMISSION message sent on completion.
+	};
+
+	/** @name constructor, destructor. */
+	///@{
+	BackboneFlowModel(cSimpleModule *owner, short endEvtKind, int headerLength);
+	~BackboneFlowModel();
+	///@}
+
+	/**
+	 * @brief Start a flow of 'bytes' bytes through output gate 'gateId'.
+	 *
+	 * 'startMsg' is sent immediately as START_TRANSMISSION, a duplicate of it
+	 * is sent as END_TRANSMISSION when the flow completes. Returns the flow ID.
+	 */
+	int startFlow(int gateId, WiredMessage *startMsg, int64_t bytes);
+	/** @brief Handle a self message of kind endEvtKind, returns false if the message does not belong to this model. */
+	bool handleEndEvt(cMessage *msg);
+	/** @brief Stop a flow without sending its END_TRANSMISSION message. */
+	void abortFlow(int flowId);
+	/** @brief Return the predicted completion time of a flow given the flows active now. */
+	simtime_t predictCompletion(int flowId) const;
+	/** @brief Return the number of flows currently leaving through output gate 'gateId'. */
+	size_t activeFlows(int gateId) const;
+	/** @brief Abort all active flows. */
+	void clear();
+
+	/** @brief Send a bulk transfer of 'bytes' bytes through output gate 'gateId' of 'owner' as one data packet, the packet mode counterpart of startFlow(). */
+	static void sendPacket(cSimpleModule *owner, int gateId, WiredMessage *dataMsg, int64_t bytes, int headerLength);
+	/** @brief Return the number of bytes a received wired message completes beyond its own bit length, i.e. the flow size on END_TRANSMISSION and 0 otherwise. */
+	static int64_t countReceived(WiredMessage *wiredMsg);
+
+	/** @name statistics. */
+	///@{
+	long flowsStarted;   ///< number of flows started.
+	long flowsCompleted; ///< number of flows completed.
+	int64_t bytesCompleted; ///< number of bytes carried by completed flows.
+	///@}
+
+private:
+	/** @brief Return the nominal datarate of the channel attached to output gate 'gateId'. */
+	double capacityOf(int gateId) const;
+	/** @brief Drain all flows of a link up to now and reschedule their completion events with the new fair share. */
+	void reshare(int gateId);
+	/** @brief Send a message through output gate 'gateId' of 'owner' as soon as its channel is free. */
+	static void sendWhenIdle(cSimpleModule *owner, WiredMessage *msg, int gateId);
+	/** @brief Remove a flow from its link and release its resources. */
+	void removeFlow(std::map<int, Flow*>::iterator itF);
+
+private:
+	cSimpleModule *owner; ///< the module scheduling the completion events and sending the control messages.
+	short endEvtKind;     ///< message kind of the completion events.
+	int headerLength;     ///< length of the control messages in bits.
+	int nextFlowId;       ///< identifier of the next started flow.
+
+	std::map<int /* gate ID */, std::list<Flow*> > links; ///< active flows grouped by output gate.
+	std::map<int /* flow ID */, Flow*> flows; ///< all active flows.
+};
+
+#endif /* __BACKBONEFLOWMODEL_H__ */
@@ -0,0 +1,195 @@
+//
+// BinaryCache - pre-parsed binary representation of XML inputs
+// Copyright (C) 2018 Xu Le <xmutongxinXuLe@163.com>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+#if defined(_WIN32) || defined(__WIN32__) || defined(WIN32) || defined(__CYGWIN__) || defined(_WIN64)
+#include <process.h>
+#define VEINS_BINARYCACHE_NO_MMAP
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "veins/modules/utility/BinaryCache.h"
+
+namespace Veins {
+
+namespace {
+	const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+	const uint64_t FNV_PRIME = 1099511628211ULL;
+
+	void hashBytes(uint64_t& hash, const char* s, size_t n) {
+		for (size_t i = 0; i < n; ++i) {
+			hash ^= static_cast<unsigned char>(s[i]);
+			hash *= FNV_PRIME;
+		}
+		// separator, so that "ab"+"c" and "a"+"bc" differ
+		hash ^= 0xff;
+		hash *= FNV_PRIME;
+	}
+
+	void hashString(uint64_t& hash, const char* s) {
+		hashBytes(hash, s ? s : "", s ? strlen(s) : 0);
+	}
+
+	void hashElement(uint64_t& hash, const cXMLElement* e) {
+		hashString(hash, e->getTagName());
+		cXMLAttributeMap attrs = e->getAttributes();
+		for (cXMLAttributeMap::const_iterator i = attrs.begin(); i != attrs.end(); ++i) {
+			hashString(hash, i->first.c_str());
+			hashString(hash, i->second.c_str());
+		}
+		hashString(hash, e->getNodeValue());
+		for (const cXMLElement* child = e->getFirstChild(); child; child = child->getNextSibling()) {
+			hashElement(hash, child);
+		}
+		hashString(hash, "/");
+	}
+
+	const size_t ALIGNMENT = 8;
+}
+
+uint64_t hashXmlContent(const cXMLElement* xml) {
+	uint64_t hash = FNV_OFFSET_BASIS;
+	if (xml) hashElement(hash, xml);
+	return hash;
+}
+
+std::string binaryCacheFileName(const std::string& dir, const std::string& prefix, uint64_t hash) {
+	std::ostringstream ss;
+	ss << dir;
+	if (!dir.empty() && dir[dir.size()-1] != '/') ss << '/';
+	ss << prefix << '-' << std::hex << std::setw(16) << std::setfill('0') << hash << ".bin";
+	return ss.str();
+}
+
+BinaryCacheWriter::BinaryCacheWriter(uint32_t magic, uint32_t version, uint64_t hash) {
+	put(magic);
+	put(version);
+	put(hash);
+}
+
+void BinaryCacheWriter::putString(const std::string& s) {
+	put(static_cast<uint32_t>(s.size()));
+	buf.append(s);
+}
+
+void BinaryCacheWriter::align() {
+	while (buf.size() % ALIGNMENT != 0) buf += '\0';
+}
+
+bool BinaryCacheWriter::save(const std::string& fileName) const {
+	std::ostringstream tmpName;
+#ifdef VEINS_BINARYCACHE_NO_MMAP
+	tmpName << fileName << ".tmp" << _getpid();
+#else
+	tmpName << fileName << ".tmp" << getpid();
+#endif
+	{
+		std::ofstream out(tmpName.str().c_str(), std::ios::binary | std::ios::trunc);
+		if (!out) return false;
+		out.write(buf.data(), buf.size());
+		if (!out) {
+			out.close();
+			std::remove(tmpName.str().c_str());
+			return false;
+		}
+	}
+#ifdef VEINS_BINARYCACHE_NO_MMAP
+	std::remove(fileName.c_str()); // rename does not replace an existing file on this platform
+#endif
+	// rename replaces an existing cache atomically, so readers see either the old or the new file
+	if (std::rename(tmpName.str().c_str(), fileName.c_str()) != 0) {
+		std::remove(tmpName.str().c_str());
+		return false;
+	}
+	return true;
+}
+
+BinaryCacheReader::BinaryCacheReader() : data(0), size(0), pos(0) {
+}
+
+BinaryCacheReader::~BinaryCacheReader() {
+	close();
+}
+
+bool BinaryCacheReader::open(const std::string& fileName, uint32_t magic, uint32_t version, uint64_t hash) {
+	close();
+
+#ifdef VEINS_BINARYCACHE_NO_MMAP
+	std::ifstream in(fileName.c_str(), std::ios::binary);
+	if (!in) return false;
+	std::ostringstream ss; ss << in.rdbuf();
+	contents = ss.str();
+	data = contents.data();
+	size = contents.size();
+#else
+	int fd = ::open(fileName.c_str(), O_RDONLY);
+	if (fd < 0) return false;
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0) {
+		::close(fd);
+		return false;
+	}
+	void* mapped = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (mapped == MAP_FAILED) return false;
+	data = static_cast<const char*>(mapped);
+	size = st.st_size;
+#endif
+	pos = 0;
+
+	if (size < sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint64_t)
+		|| get<uint32_t>() != magic || get<uint32_t>() != version || get<uint64_t>() != hash) {
+		close();
+		return false;
+	}
+	return true;
+}
+
+std::string BinaryCacheReader::getString() {
+	uint32_t n = get<uint32_t>();
+	if (pos + n > size) throw cRuntimeError("binary cache is truncated");
+	std::string s(data + pos, n);
+	pos += n;
+	return s;
+}
+
+void BinaryCacheReader::align() {
+	pos = (pos + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+void BinaryCacheReader::close() {
+#ifdef VEINS_BINARYCACHE_NO_MMAP
+	contents.clear();
+#else
+	if (data) munmap(const_cast<char*>(data), size);
+#endif
+	data = 0;
+	size = 0;
+	pos = 0;
+}
+
+}
@@ -0,0 +1,120 @@
+//
+// BinaryCache - pre-parsed binary representation of XML inputs
+// Copyright (C) 2018 Xu Le <xmutongxinXuLe@163.com>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#ifndef VEINS_UTILITY_BINARYCACHE_H
+#define VEINS_UTILITY_BINARYCACHE_H
+
+#include <string>
+#include <cstring>
+#include <stdint.h>
+
+#include "veins/base/utils/MiXiMDefs.h"
+
+namespace Veins {
+
+/**
+ * returns a 64 bit FNV-1a hash over tag names, attributes, values and children of an XML tree
+ */
+uint64_t hashXmlContent(const cXMLElement* xml);
+
+/**
+ * returns "<dir>/<prefix>-<hash as hex>.bin"
+ */
+std::string binaryCacheFileName(const std::string& dir, const std::string& prefix, uint64_t hash);
+
+/**
+ * builds a binary cache file in memory and atomically moves it to its final name.
+ *
+ * Every array is 8-byte aligned so that it can be used in place once the file is memory-mapped.
+ */
+class BinaryCacheWriter
+{
+	public:
+		BinaryCacheWriter(uint32_t magic, uint32_t version, uint64_t hash);
+
+		template<typename T> void put(const T& value) {
+			buf.append(reinterpret_cast<const char*>(&value), sizeof(T));
+		}
+		template<typename T> void putArray(const T* values, size_t count) {
+			align();
+			buf.append(reinterpret_cast<const char*>(values), count * sizeof(T));
+		}
+		void putString(const std::string& s);
+
+		/** writes to a temporary file first, so that concurrent runs never see a partially written cache */
+		bool save(const std::string& fileName) const;
+
+	private:
+		void align();
+
+		std::string buf;
+};
+
+/**
+ * memory-maps a binary cache file written by BinaryCacheWriter and reads it sequentially without copying.
+ *
+ * The mapping is released by the destructor, so a "binary cache is truncated" error does not leak it.
+ */
+class BinaryCacheReader
+{
+	public:
+		BinaryCacheReader();
+		~BinaryCacheReader();
+
+		/** returns false if the file does not exist or its header does not match magic, version and hash */
+		bool open(const std::string& fileName, uint32_t magic, uint32_t version, uint64_t hash);
+
+		template<typename T> T get() {
+			T value;
+			if (pos + sizeof(T) > size) throw cRuntimeError("binary cache is truncated");
+			memcpy(&value, data + pos, sizeof(T));
+			pos += sizeof(T);
+			return value;
+		}
+		/** returns a pointer into the mapped file */
+		template<typename T> const T* getArray(size_t count) {
+			align();
+			if (pos + count * sizeof(T) > size) throw cRuntimeError("binary cache is truncated");
+			const T* values = reinterpret_cast<const T*>(data + pos);
+			pos += count * sizeof(T);
+			return values;
+		}
+		std::string getString();
+
+		/** returns whether everything has been read */
+		bool eof() const { return pos >= size; }
+
+	private:
+		BinaryCacheReader(const BinaryCacheReader&);
+		BinaryCacheReader& operator=(const BinaryCacheReader&);
+
+		void align();
+		void close();
+
+		const char* data;
+		size_t size;
+		size_t pos;
+#if defined(_WIN32) || defined(__WIN32__) || defined(WIN32) || defined(__CYGWIN__) || defined(_WIN64)
+		std::string contents; /**< no mmap on this platform, the file is read instead */
+#endif
+};
+
+}
+
+#endif
@@ -0,0 +1,249 @@
+//
+// MappingBenchmark - micro-benchmarks of Mapping storage types and MappingUtils
+// Copyright (C) 2018 Xu Le <xmutongxinXuLe@163.com>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "veins/modules/utility/MappingBenchmark.h"
+#include "veins/base/phyLayer/MappingUtils.h"
+#include "veins/base/phyLayer/PhyUtils.h"
+
+using Veins::MappingBenchmark;
+
+Define_Module(Veins::MappingBenchmark);
+
+namespace {
+
+/** keeps the compiler from optimizing benchmarked results away */
+volatile double sink;
+
+}
+
+void MappingBenchmark::initialize(int stage) {
+	if (stage != 0) return;
+
+	repetitions = par("repetitions");
+
+	runArguments();
+
+	std::istringstream sizes(par("sizes").stdstringValue());
+	long size;
+	while (sizes >> size) {
+		run<MapStorage>("map", size);
+		run<SortedVectorStorage>("vector", size);
+		runRadioSwitching(size);
+	}
+}
+
+template<class Op> void MappingBenchmark::measure(const std::string& name, Op op) {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (long i = 0; i < repetitions; ++i) op();
+	double duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	recordScalar(name.c_str(), repetitions > 0 ? duration / repetitions : 0, "s");
+	EV_INFO << name << ": " << (repetitions > 0 ? duration / repetitions * 1e9 : 0) << " ns" << endl;
+}
+
+void MappingBenchmark::runArguments() {
+	const double centerFrequency = 5.89e9;
+
+	Argument a(DimensionSet::timeFreqDomain(), SimTime(3, SIMTIME_US));
+	a.setArgValue(Dimension::frequency(), centerFrequency);
+	Argument b(DimensionSet::timeFreqDomain(), SimTime(3, SIMTIME_US));
+	b.setArgValue(Dimension::frequency(), centerFrequency + 5e6);
+
+	measure("construct:argument:timeFreq", [&]() {
+		Argument st(DimensionSet::timeFreqDomain());
+		st.setTime(a.getTime());
+		st.setArgValue(Dimension::frequency(), centerFrequency);
+		sink = st.getArgValue(Dimension::frequency());
+	});
+	measure("copy:argument:timeFreq", [&]() {
+		Argument copy(a);
+		sink = copy.getArgValue(Dimension::frequency());
+	});
+	measure("compare:argument:timeFreq", [&]() { sink = (a < b) + a.isSamePosition(b) + (a == b); });
+	measure("getDimensions:argument:timeFreq", [&]() { sink = a.getDimensions().size(); });
+}
+
+template<class Storage> void MappingBenchmark::run(const char* storageName, long size) {
+	// entries every microsecond, like the power of a frame changing at symbol boundaries,
+	// and on three channels around 5.9 GHz for the frequency domain
+	const simtime_t step = SimTime(1, SIMTIME_US);
+	const double frequencies[] = { 5.86e9, 5.87e9, 5.88e9 };
+
+	TimeMapping<Linear, Storage> time1, time2;
+	MultiDimMapping<Linear, Storage> freq1(DimensionSet::timeFreqDomain()), freq2(DimensionSet::timeFreqDomain());
+	for (long i = 0; i < size; ++i) {
+		time1.setValue(Argument(step * i), 1 + i % 7);
+		time2.setValue(Argument(step * i + step / 2), 2 + i % 5);
+
+		for (size_t f = 0; f < sizeof(frequencies) / sizeof(frequencies[0]); ++f) {
+			Argument pos(DimensionSet::timeFreqDomain(), step * i);
+			pos.setArgValue(Dimension::frequency(), frequencies[f]);
+			freq1.setValue(pos, 1 + (i + f) % 7);
+			pos.setTime(step * i + step / 2);
+			freq2.setValue(pos, 2 + (i + f) % 5);
+		}
+	}
+
+	// positions to look up, spread over the whole signal
+	std::vector<Argument> timePositions;
+	std::vector<Argument> freqPositions;
+	for (long i = 0; i < 64; ++i) {
+		simtime_t t = step * intuniform(0, size * 4) / 4;
+		timePositions.push_back(Argument(t));
+		Argument pos(DimensionSet::timeFreqDomain(), t);
+		pos.setArgValue(Dimension::frequency(), frequencies[i % 3]);
+		freqPositions.push_back(pos);
+	}
+
+	std::string timeSuffix = std::string(":") + storageName + ":time:" + std::to_string(size);
+	std::string freqSuffix = std::string(":") + storageName + ":timeFreq:" + std::to_string(size);
+
+	size_t next = 0;
+	measure("getValue" + timeSuffix, [&]() { sink = time1.getValue(timePositions[next++ % timePositions.size()]); });
+	measure("getValue" + freqSuffix, [&]() { sink = freq1.getValue(freqPositions[next++ % freqPositions.size()]); });
+
+	measure("next" + timeSuffix, [&]() {
+		ConstMappingIterator* it = time1.createConstIterator();
+		while (it->hasNext()) it->next();
+		sink = it->getValue();
+		delete it;
+	});
+	measure("next" + freqSuffix, [&]() {
+		ConstMappingIterator* it = freq1.createConstIterator();
+		while (it->hasNext()) it->next();
+		sink = it->getValue();
+		delete it;
+	});
+
+	measure("add" + timeSuffix, [&]() { delete MappingUtils::add(time1, time2); });
+	measure("multiply" + timeSuffix, [&]() { delete MappingUtils::multiply(time1, time2); });
+	measure("divide" + timeSuffix, [&]() { delete MappingUtils::divide(time1, time2); });
+	measure("findMin" + timeSuffix, [&]() { sink = MappingUtils::findMin(time1); });
+
+	measure("add" + freqSuffix, [&]() { delete MappingUtils::add(freq1, freq2); });
+	measure("multiply" + freqSuffix, [&]() { delete MappingUtils::multiply(freq1, freq2); });
+	measure("divide" + freqSuffix, [&]() { delete MappingUtils::divide(freq1, freq2); });
+	measure("findMin" + freqSuffix, [&]() { sink = MappingUtils::findMin(freq1); });
+
+	// minimum of a quotient, once materialized and once lazily
+	const simtime_t end = step * size;
+	Argument timeFrom(step), timeTo(end);
+	measure("divideFindMin" + timeSuffix, [&]() {
+		Mapping* quotient = MappingUtils::divide(time1, time2, Argument::MappedZero());
+		sink = MappingUtils::findMin(*quotient, timeFrom, timeTo);
+		delete quotient;
+	});
+	measure("quotientFindMin" + timeSuffix, [&]() {
+		sink = MappingUtils::findMin(QuotientMapping(time1, time2, false, Argument::MappedZero()), timeFrom, timeTo);
+	});
+
+	// whether a quotient stays above a threshold, like SNRThresholdDecider decides on the SNR, once
+	// for a threshold it stays above (checking every entry) and once for one it soon drops below
+	measure("divideIsAbove" + timeSuffix, [&]() {
+		Mapping* quotient = MappingUtils::divide(time1, time2, Argument::MappedZero());
+		sink = MappingUtils::isAbove(*quotient, step, end, 0.1);
+		delete quotient;
+	});
+	measure("quotientIsAbove" + timeSuffix, [&]() {
+		sink = MappingUtils::isAbove(QuotientMapping(time1, time2, false, Argument::MappedZero()), step, end, 0.1);
+	});
+	measure("divideDrops" + timeSuffix, [&]() {
+		Mapping* quotient = MappingUtils::divide(time1, time2, Argument::MappedZero());
+		sink = MappingUtils::isAbove(*quotient, step, end, 1);
+		delete quotient;
+	});
+	measure("quotientDrops" + timeSuffix, [&]() {
+		sink = MappingUtils::isAbove(QuotientMapping(time1, time2, false, Argument::MappedZero()), step, end, 1);
+	});
+
+	Argument freqFrom(DimensionSet::timeFreqDomain(), step), freqTo(DimensionSet::timeFreqDomain(), end);
+	freqFrom.setArgValue(Dimension::frequency(), frequencies[0]);
+	freqTo.setArgValue(Dimension::frequency(), frequencies[2]);
+	measure("divideFindMin" + freqSuffix, [&]() {
+		Mapping* quotient = MappingUtils::divide(freq1, time2, Argument::MappedZero());
+		sink = MappingUtils::findMin(*quotient, freqFrom, freqTo);
+		delete quotient;
+	});
+	measure("quotientFindMin" + freqSuffix, [&]() {
+		sink = MappingUtils::findMin(QuotientMapping(freq1, time2, false, Argument::MappedZero()), freqFrom, freqTo);
+	});
+
+	// what Decider80211p::checkIfSignalOk does with the Arguments of a received frame
+	measure("checkIfSignalOk" + freqSuffix, [&]() {
+		Argument st(DimensionSet::timeFreqDomain());
+		st.setTime(SIMTIME_ZERO);
+		st.setArgValue(Dimension::frequency(), frequencies[1]);
+		double recvPower = freq1.getValue(st);
+
+		Argument min(DimensionSet::timeFreqDomain());
+		min.setTime(step);
+		min.setArgValue(Dimension::frequency(), frequencies[1] - 5e6);
+		Argument max(DimensionSet::timeFreqDomain());
+		max.setTime(end);
+		max.setArgValue(Dimension::frequency(), frequencies[1] + 5e6);
+		sink = recvPower + MappingUtils::findMin(freq1, min, max);
+	});
+}
+
+void MappingBenchmark::runRadioSwitching(long size) {
+	// the radio switches between receiving and sending every microsecond,
+	// while frames of 16 microseconds keep size switches tracked
+	const simtime_t step = SimTime(1, SIMTIME_US);
+	const long frameSteps = 16;
+
+	RadioStateAnalogueModel rsam(1, true, SIMTIME_ZERO);
+	for (long i = 1; i <= size; ++i) rsam.writeRecvEntry(step * i, i % 2);
+
+	std::vector<simtime_t> frameStarts;
+	for (long i = 0; i < 64; ++i) frameStarts.push_back(step * intuniform(0, size - 1) + step / 4);
+
+	std::string suffix = ":rsam:time:" + std::to_string(size);
+
+	size_t next = 0;
+	measure("getValue" + suffix, [&]() {
+		const simtime_t& start = frameStarts[next++ % frameStarts.size()];
+		RSAMMapping attenuation(&rsam, start, start + step * frameSteps);
+		sink = attenuation.getValue(Argument(start + step * frameSteps / 2));
+	});
+	measure("next" + suffix, [&]() {
+		const simtime_t& start = frameStarts[next++ % frameStarts.size()];
+		RSAMMapping attenuation(&rsam, start, start + step * frameSteps);
+		ConstMappingIterator* it = attenuation.createConstIterator();
+		double value = 0;
+		while (it->hasNext()) {
+			value += it->getValue();
+			it->next();
+		}
+		sink = value + it->getValue();
+		delete it;
+	});
+
+	// keeps size switches tracked, appending one and cleaning up the oldest
+	long switches = size;
+	measure("switch" + suffix, [&]() {
+		++switches;
+		rsam.writeRecvEntry(step * switches, switches % 2);
+		rsam.cleanUpUntil(step * (switches - size));
+	});
+}
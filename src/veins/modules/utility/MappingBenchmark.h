@@ -0,0 +1,76 @@
+//
+// MappingBenchmark - micro-benchmarks of Mapping storage types and MappingUtils
+// Copyright (C) 2018 Xu Le <xmutongxinXuLe@163.com>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#ifndef VEINS_MODULES_UTILITY_MAPPINGBENCHMARK_H
+#define VEINS_MODULES_UTILITY_MAPPINGBENCHMARK_H
+
+#include <string>
+
+#include <omnetpp.h>
+
+#include "veins/base/utils/MiXiMDefs.h"
+
+namespace Veins {
+
+/**
+ * @brief
+ * Measures the speed of Argument and Mapping operations for std::map and sorted vector storage.
+ *
+ * During initialization, times creating, copying and comparing time and frequency
+ * Arguments. Then builds signals of each of the configured sizes as TimeMappings
+ * (time domain) and MultiDimMappings (frequency and time domain) with MapStorage and
+ * SortedVectorStorage, and times getValue at random positions, iterating with next(),
+ * MappingUtils::add, multiply, divide and findMin, finding the minimum of a quotient
+ * and deciding whether it stays above a threshold (isAbove) with and without creating
+ * it (QuotientMapping), and the Argument handling of
+ * Decider80211p::checkIfSignalOk. Finally times looking up the attenuation of a
+ * frame in a RadioStateAnalogueModel tracking as many radio switches, and switching
+ * the radio while that many are tracked. Records the mean time per operation as
+ * scalars named "<operation>:<storage>:<domain>:<size>" ("<operation>:argument:<domain>"
+ * for Arguments, "rsam" as storage for the RadioStateAnalogueModel).
+ *
+ * @author Xu Le
+ *
+ * @see SortedVectorMap
+ *
+ */
+class MappingBenchmark : public cSimpleModule
+{
+public:
+	virtual void initialize(int stage) override;
+
+protected:
+	/** runs the benchmarks of Arguments alone */
+	void runArguments();
+
+	/** runs the benchmarks of a RadioStateAnalogueModel tracking size radio switches */
+	void runRadioSwitching(long size);
+
+	/** runs all benchmarks on signals of size entries with the given storage */
+	template<class Storage> void run(const char* storageName, long size);
+
+	/** calls op repetitions times and records the mean time per call */
+	template<class Op> void measure(const std::string& name, Op op);
+
+	long repetitions; /**< how often each operation is timed */
+};
+
+}
+
+#endif
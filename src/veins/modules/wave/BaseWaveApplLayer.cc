@@ -340,6 +340,18 @@ void BaseWaveApplLayer::handleParkingUpdate(cObject *obj)
 	}
 }
 
+void BaseWaveApplLayer::recycle()
+{
+	// finish() has already released timers, containers and signal subscriptions
+	delete passedMsg;
+	passedMsg = nullptr;
+}
+
+void BaseWaveApplLayer::reinitialize(int stage)
+{
+	initialize(stage);
+}
+
 BaseWaveApplLayer::~BaseWaveApplLayer()
 {
 	EV << "base wave appl layer module destructing ..." << std::endl;
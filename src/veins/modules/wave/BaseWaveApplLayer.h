@@ -22,6 +22,7 @@
 #define __BASEWAVEAPPLLAYER_H__
 
 #include "veins/base/modules/BaseApplLayer.h"
+#include "veins/base/modules/RecyclableModule.h"
 #include "veins/base/connectionManager/ChannelAccess.h"
 #include "veins/modules/utility/Consts80211p.h"
 #include "veins/modules/utility/Utils.h"
@@ -46,7 +47,7 @@
  * @see TraCIMobility
  * @see TraCICommandInterface
  */
-class BaseWaveApplLayer : public BaseApplLayer
+class BaseWaveApplLayer : public BaseApplLayer, public RecyclableModule
 {
 public:
 	/** @brief The message kinds this layer uses. */
@@ -79,6 +80,12 @@ public:
 	virtual void finish() override;
 	virtual void receiveSignal(cComponent* source, simsignal_t signalID, cObject* obj, cObject* details) override;
 
+	/** @name RecyclableModule implementation, derived classes owning more than finish() releases must extend recycle(). */
+	///@{
+	virtual void recycle() override;
+	virtual void reinitialize(int stage) override;
+	///@}
+
 protected:
 	/** @brief Called every time a message arrives(template method, subclass should not override it). */
 	virtual void handleMessage(cMessage *msg) override;
@@ -19,27 +19,49 @@
 
 #include <sstream>
 #include <cmath>
+#include <chrono>
 
 #include "veins/modules/world/annotations/AnnotationManager.h"
 #include "veins/modules/mobility/traci/TraCIScenarioManager.h"
 #include "veins/modules/mobility/traci/TraCICommandInterface.h"
+#include "veins/modules/utility/BinaryCache.h"
+#include "veins/base/utils/StartupProfiler.h"
 
 Define_Module(Veins::AnnotationManager);
 
 using Veins::TraCIScenarioManager;
 using Veins::TraCIScenarioManagerAccess;
 using Veins::AnnotationManager;
+using Veins::TraCICommandInterface;
 
 namespace {
     const short EVT_SCHEDULED_ERASE = 3;
+    const short EVT_FLUSH_TRACI = 4;
+
+    const uint32_t CACHE_MAGIC = 0x4e415356; // "VSAN"
+    const uint32_t CACHE_VERSION = 1;
+    enum CachedAnnotationKind { CACHED_POINT = 0, CACHED_LINE = 1, CACHED_POLYGON = 2 };
+
+    double elapsedSince(const std::chrono::steady_clock::time_point& start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
 }
 
 void AnnotationManager::initialize() {
+    Veins::StartupProfiler::Scope profilerScope(getClassName(), "initialize");
     EV << "AnnotationManager::initialize() called.\n";
 
     debug = par("debug").boolValue();
+    batchTraCICommands = par("batchTraCICommands").boolValue();
 
     scheduledEraseEvts.clear();
+    flushEvt = new cMessage("flush", EVT_FLUSH_TRACI);
+
+    pendingTraCICommands = 0;
+    statsShown = 0;
+    statsTraCIBatches = 0;
+    statsTraCICommands = 0;
+    statsDrawingTime = 0;
 
     annotations.clear();
     groups.clear();
@@ -51,12 +73,32 @@ void AnnotationManager::initialize() {
 #endif
 
     annotationsXml = par("annotations");
+
+    std::string cacheDir = par("cacheDir").stdstringValue();
+    if (cacheDir.empty()) {
+        addFromXml(annotationsXml);
+        return;
+    }
+
+    uint64_t xmlHash = Veins::hashXmlContent(annotationsXml);
+    std::string cacheFile = Veins::binaryCacheFileName(cacheDir, "annotations", xmlHash);
+    if (loadCache(cacheFile, xmlHash)) {
+        EV << "AnnotationManager loaded annotations from cache " << cacheFile << endl;
+        return;
+    }
     addFromXml(annotationsXml);
+    if (!saveCache(cacheFile, xmlHash)) EV_WARN << "AnnotationManager could not write annotation cache " << cacheFile << endl;
 }
 
 void AnnotationManager::finish() {
     EV << "AnnotationManager::finish() called.\n";
     hideAll();
+    flushTraCICommands();
+
+    recordScalar("annotationsShown", statsShown);
+    recordScalar("traciDrawingBatches", statsTraCIBatches);
+    recordScalar("traciDrawingCommands", statsTraCICommands);
+    recordScalar("drawingWallTime", statsDrawingTime, "s");
 }
 
 AnnotationManager::~AnnotationManager() {
@@ -67,6 +109,7 @@ AnnotationManager::~AnnotationManager() {
         scheduledEraseEvts.erase(scheduledEraseEvts.begin());
     }
     scheduledEraseEvts.clear();
+    cancelAndDelete(flushEvt);
 
     while (annotations.begin() != annotations.end()) {
         delete *annotations.begin();
@@ -103,6 +146,11 @@ void AnnotationManager::handleSelfMsg(cMessage *msg) {
         return;
     }
 
+    if (msg == flushEvt) {
+        flushTraCICommands();
+        return;
+    }
+
     error("unknown self message type");
 }
 
@@ -188,6 +236,84 @@ void AnnotationManager::addFromXml(cXMLElement* xml) {
 
 }
 
+/**
+ * cache layout (after the BinaryCacheWriter header):
+ *
+ * uint32 #annotations, per annotation: uint8 kind, color, text, uint32 #coords, aligned double[2 * #coords]
+ */
+bool AnnotationManager::loadCache(const std::string& fileName, uint64_t xmlHash) {
+    Veins::BinaryCacheReader reader;
+    if (!reader.open(fileName, CACHE_MAGIC, CACHE_VERSION, xmlHash)) return false;
+
+    uint32_t count = reader.get<uint32_t>();
+    for (uint32_t i = 0; i < count; ++i) {
+        uint8_t kind = reader.get<uint8_t>();
+        std::string color = reader.getString();
+        std::string text = reader.getString();
+        uint32_t numCoords = reader.get<uint32_t>();
+        const double* xy = reader.getArray<double>(2 * numCoords);
+
+        std::vector<Coord> coords;
+        coords.reserve(numCoords);
+        for (uint32_t j = 0; j < numCoords; ++j) coords.push_back(Coord(xy[2*j], xy[2*j+1]));
+
+        if ((kind == CACHED_POINT) && (numCoords == 1)) drawPoint(coords[0], color, text);
+        else if ((kind == CACHED_LINE) && (numCoords == 2)) drawLine(coords[0], coords[1], color);
+        else if (kind == CACHED_POLYGON) drawPolygon(coords, color);
+        else error("annotation cache %s is corrupt", fileName.c_str());
+    }
+
+    return true;
+}
+
+bool AnnotationManager::saveCache(const std::string& fileName, uint64_t xmlHash) const {
+    Veins::BinaryCacheWriter writer(CACHE_MAGIC, CACHE_VERSION, xmlHash);
+
+    writer.put(static_cast<uint32_t>(annotations.size()));
+    std::vector<double> xy;
+    for (Annotations::const_iterator i = annotations.begin(); i != annotations.end(); ++i) {
+        uint8_t kind;
+        std::string color;
+        std::string text;
+        xy.clear();
+
+        if (const Point* o = dynamic_cast<const Point*>(*i)) {
+            kind = CACHED_POINT;
+            color = o->color;
+            text = o->text;
+            xy.push_back(o->pos.x);
+            xy.push_back(o->pos.y);
+        }
+        else if (const Line* l = dynamic_cast<const Line*>(*i)) {
+            kind = CACHED_LINE;
+            color = l->color;
+            xy.push_back(l->p1.x);
+            xy.push_back(l->p1.y);
+            xy.push_back(l->p2.x);
+            xy.push_back(l->p2.y);
+        }
+        else if (const Polygon* p = dynamic_cast<const Polygon*>(*i)) {
+            kind = CACHED_POLYGON;
+            color = p->color;
+            for (std::list<Coord>::const_iterator c = p->coords.begin(); c != p->coords.end(); ++c) {
+                xy.push_back(c->x);
+                xy.push_back(c->y);
+            }
+        }
+        else {
+            return false;
+        }
+
+        writer.put(kind);
+        writer.putString(color);
+        writer.putString(text);
+        writer.put(static_cast<uint32_t>(xy.size() / 2));
+        writer.putArray(xy.data(), xy.size());
+    }
+
+    return writer.save(fileName);
+}
+
 AnnotationManager::Group* AnnotationManager::createGroup(std::string title) {
     Group* group = new Group(title);
     groups.push_back(group);
@@ -276,6 +402,43 @@ void AnnotationManager::scheduleErase(simtime_t deltaT, Annotation* annotation)
 
 }
 
+void AnnotationManager::scheduleFlush() {
+    Enter_Method_Silent();
+
+    if (!flushEvt->isScheduled()) scheduleAt(simTime(), flushEvt);
+}
+
+void AnnotationManager::flushTraCICommands() {
+    TraCIScenarioManager* traci = TraCIScenarioManagerAccess().get();
+    if (!traci || !traci->isConnected()) return;
+
+    if (pendingTraCICommands == 0) return;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    traci->getCommandInterface()->flush();
+    statsTraCIBatches++;
+    pendingTraCICommands = 0;
+    statsDrawingTime += elapsedSince(start);
+}
+
+TraCICommandInterface* AnnotationManager::beginTraCICommands() {
+    TraCIScenarioManager* traci = TraCIScenarioManagerAccess().get();
+    if (!traci || !traci->isConnected()) return 0;
+
+    TraCICommandInterface* traciIfc = traci->getCommandInterface();
+    traciIfc->setDeferSetCommands(batchTraCICommands);
+    return traciIfc;
+}
+
+void AnnotationManager::endTraCICommands(TraCICommandInterface* traciIfc, size_t count) {
+    traciIfc->setDeferSetCommands(false);
+    statsTraCICommands += count;
+    if (batchTraCICommands && count > 0) {
+        pendingTraCICommands += count;
+        scheduleFlush();
+    }
+}
+
 #if OMNETPP_CANVAS_VERSION == 0x20140709 || OMNETPP_VERSION >= 0x500
 #else
 cModule* AnnotationManager::createDummyModule(std::string displayString) {
@@ -330,17 +493,20 @@ void AnnotationManager::show(const Annotation* annotation) {
     if (annotation->dummyObjects.size() > 0) return;
 #endif
 
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    statsShown++;
+
     if (const Point* o = dynamic_cast<const Point*>(annotation)) {
 
         if (hasGUI()) {
             // no corresponding TkEnv representation
         }
 
-        TraCIScenarioManager* traci = TraCIScenarioManagerAccess().get();
-        if (traci && traci->isConnected()) {
+        if (TraCICommandInterface* traciIfc = beginTraCICommands()) {
             std::stringstream nameBuilder; nameBuilder << o->text << " " << getEnvir()->getUniqueNumber();
-            traci->getCommandInterface()->addPoi(nameBuilder.str(), "Annotation", TraCIColor::fromTkColor(o->color), 6, o->pos);
+            traciIfc->addPoi(nameBuilder.str(), "Annotation", TraCIColor::fromTkColor(o->color), 6, o->pos);
             annotation->traciPoiIds.push_back(nameBuilder.str());
+            endTraCICommands(traciIfc, 1);
         }
     }
     else if (const Line* l = dynamic_cast<const Line*>(annotation)) {
@@ -365,12 +531,12 @@ void AnnotationManager::show(const Annotation* annotation) {
 #endif
         }
 
-        TraCIScenarioManager* traci = TraCIScenarioManagerAccess().get();
-        if (traci && traci->isConnected()) {
+        if (TraCICommandInterface* traciIfc = beginTraCICommands()) {
             std::list<Coord> coords; coords.push_back(l->p1); coords.push_back(l->p2);
             std::stringstream nameBuilder; nameBuilder << "Annotation" << getEnvir()->getUniqueNumber();
-            traci->getCommandInterface()->addPolygon(nameBuilder.str(), "Annotation", TraCIColor::fromTkColor(l->color), false, 5, coords);
+            traciIfc->addPolygon(nameBuilder.str(), "Annotation", TraCIColor::fromTkColor(l->color), false, 5, coords);
             annotation->traciLineIds.push_back(nameBuilder.str());
+            endTraCICommands(traciIfc, 1);
         }
     }
     else if (const Polygon* p = dynamic_cast<const Polygon*>(annotation)) {
@@ -408,20 +574,24 @@ void AnnotationManager::show(const Annotation* annotation) {
 #endif
         }
 
-        TraCIScenarioManager* traci = TraCIScenarioManagerAccess().get();
-        if (traci && traci->isConnected()) {
+        if (TraCICommandInterface* traciIfc = beginTraCICommands()) {
             std::stringstream nameBuilder; nameBuilder << "Annotation" << getEnvir()->getUniqueNumber();
-            traci->getCommandInterface()->addPolygon(nameBuilder.str(), "Annotation", TraCIColor::fromTkColor(p->color), false, 4, p->coords);
+            traciIfc->addPolygon(nameBuilder.str(), "Annotation", TraCIColor::fromTkColor(p->color), false, 4, p->coords);
             annotation->traciPolygonsIds.push_back(nameBuilder.str());
+            endTraCICommands(traciIfc, 1);
         }
 
     }
     else {
         error("unknown Annotation type");
     }
+
+    statsDrawingTime += elapsedSince(start);
 }
 
 void AnnotationManager::hide(const Annotation* annotation) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
 #if OMNETPP_CANVAS_VERSION == 0x20140709 || OMNETPP_VERSION >= 0x500
     if (annotation->figure) {
         delete annotationLayer->removeFigure(annotation->figure);
@@ -435,24 +605,27 @@ void AnnotationManager::hide(const Annotation* annotation) {
     annotation->dummyObjects.clear();
 #endif
 
-    TraCIScenarioManager* traci = TraCIScenarioManagerAccess().get();
-    if (traci && traci->isConnected()) {
+    if (TraCICommandInterface* traciIfc = beginTraCICommands()) {
+        size_t count = annotation->traciPolygonsIds.size() + annotation->traciLineIds.size() + annotation->traciPoiIds.size();
         for (std::list<std::string>::const_iterator i = annotation->traciPolygonsIds.begin(); i != annotation->traciPolygonsIds.end(); ++i) {
             std::string id = *i;
-            traci->getCommandInterface()->polygon(id).remove(3);
+            traciIfc->polygon(id).remove(3);
         }
         annotation->traciPolygonsIds.clear();
         for (std::list<std::string>::const_iterator i = annotation->traciLineIds.begin(); i != annotation->traciLineIds.end(); ++i) {
             std::string id = *i;
-            traci->getCommandInterface()->polygon(id).remove(4);
+            traciIfc->polygon(id).remove(4);
         }
         annotation->traciLineIds.clear();
         for (std::list<std::string>::const_iterator i = annotation->traciPoiIds.begin(); i != annotation->traciPoiIds.end(); ++i) {
             std::string id = *i;
-            traci->getCommandInterface()->poi(id).remove(5);
+            traciIfc->poi(id).remove(5);
         }
         annotation->traciPoiIds.clear();
+        endTraCICommands(traciIfc, count);
     }
+
+    statsDrawingTime += elapsedSince(start);
 }
 
 void AnnotationManager::showAll(Group* group) {
@@ -31,6 +31,9 @@
  * manages annotations on the OMNeT++ canvas.
  */
 namespace Veins {
+
+class TraCICommandInterface;
+
 class AnnotationManager : public cSimpleModule
 {
 	public:
@@ -112,6 +115,7 @@ class AnnotationManager : public cSimpleModule
 				std::string title;
 		};
 
+		AnnotationManager() : flushEvt(0) {}
 		~AnnotationManager();
 		void initialize();
 		void finish();
@@ -142,13 +146,34 @@ class AnnotationManager : public cSimpleModule
 		void hideAll(Group* group = 0);
 
 	protected:
+		/** arranges for queued TraCI commands to be sent in one message at the end of the current time step */
+		void scheduleFlush();
+		/** sends all TraCI commands queued by show and hide */
+		void flushTraCICommands();
+		/** returns the TraCI command interface prepared for drawing commands, or 0 if not connected */
+		TraCICommandInterface* beginTraCICommands();
+		/** restores the command interface after 'count' drawing commands were issued */
+		void endTraCICommands(TraCICommandInterface* traciIfc, size_t count);
+		/** draws the annotations stored in a binary cache written by saveCache, returns false if it does not exist or is stale */
+		bool loadCache(const std::string& fileName, uint64_t xmlHash);
+		/** writes all current annotations to a binary cache keyed by the hash of the annotations XML */
+		bool saveCache(const std::string& fileName, uint64_t xmlHash) const;
+
 		typedef std::list<Annotation*> Annotations;
 		typedef std::list<Group*> Groups;
 
 		bool debug; /**< whether to emit debug messages */
+		bool batchTraCICommands; /**< whether TraCI drawing commands of one time step are coalesced into one message */
 		cXMLElement* annotationsXml; /**< annotations to add at startup */
 
 		std::list<cMessage*> scheduledEraseEvts;
+		cMessage* flushEvt; /**< self-message sending the queued TraCI commands of the current time step */
+		size_t pendingTraCICommands; /**< number of TraCI commands queued but not yet sent */
+
+		long statsShown; /**< number of annotations shown */
+		long statsTraCIBatches; /**< number of TraCI messages carrying queued drawing commands */
+		long statsTraCICommands; /**< number of TraCI drawing commands sent */
+		double statsDrawingTime; /**< wall clock time spent in show, hide and flushing (in s) */
 
 		Annotations annotations;
 		Groups groups;
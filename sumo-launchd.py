@@ -25,6 +25,12 @@
 For each incoming TCP connection the daemon receives a launch configuration.
 It starts SUMO accordingly, then proxies all TraCI Messages.
 
+If started with --unix PATH, the daemon also accepts connections on a Unix
+domain socket. On such a connection the client may first send CMD_SHM_ATTACH
+with the name of a shared memory segment; all further TraCI messages are then
+exchanged through the ring buffers in that segment (see TraCITransport.h).
+SUMO itself is always reached via TCP.
+
 The launch configuration must be sent in the very first TraCI message.
 This message must contain a single command, CMD_FILE_SEND and be used to 
 send a file named "sumo-launchd.launch.xml", which has the following 
@@ -55,12 +61,32 @@ import xml.dom.minidom
 import select
 import logging
 import atexit
+import mmap
+import ctypes
+import multiprocessing
 from optparse import OptionParser
 
 _API_VERSION = 1
 _LAUNCHD_VERSION = 'sumo-launchd.py 1.00'
 _CMD_GET_VERSION = 0x00
 _CMD_FILE_SEND = 0x75
+_CMD_SHM_ATTACH = 0x76
+
+# layout of a shared memory segment, to be kept in sync with TraCITransport.h
+_SHM_MAGIC = 0x4d485356
+_SHM_VERSION = 1
+_SHM_OFFSET_TO_SERVER_HEAD = 64
+_SHM_OFFSET_TO_SERVER_TAIL = 128
+_SHM_OFFSET_TO_CLIENT_HEAD = 192
+_SHM_OFFSET_TO_CLIENT_TAIL = 256
+_SHM_OFFSET_DATA = 4096
+
+_CPU_COUNT = multiprocessing.cpu_count()
+if os.name == 'posix':
+    _sched_yield = ctypes.CDLL(None).sched_yield
+else:
+    # no sched_yield outside POSIX; sleeping for zero seconds also gives up the time slice
+    _sched_yield = lambda: time.sleep(0)
 
 class UnusedPortLock:
     lock = thread.allocate_lock()
@@ -86,6 +112,105 @@ class UnusedPortLock:
             UnusedPortLock.lock.release()
             self.acquired = False
 
+class SharedMemoryConnection:
+    """
+    Server side of a shared memory transport, offering the subset of the socket interface used by this daemon.
+    The Unix domain socket the segment was announced on stays open; the session ends when the client closes it.
+    """
+
+    def __init__(self, control, name):
+        self.control = control
+        f = open(os.path.join("/dev/shm", name.lstrip("/")), "r+b")
+        try:
+            self.segment = mmap.mmap(f.fileno(), 0)
+        finally:
+            f.close()
+        (magic, version, capacity) = struct.unpack_from("=IIQ", self.segment, 0)
+        if magic != _SHM_MAGIC or version != _SHM_VERSION:
+            self.segment.close()
+            raise RuntimeError("Shared memory segment %s has unknown format" % name)
+        self.capacity = capacity
+        # head and tail are accessed as native 64 bit integers, so that each update is a single store
+        self.to_server_head = ctypes.c_uint64.from_buffer(self.segment, _SHM_OFFSET_TO_SERVER_HEAD)
+        self.to_server_tail = ctypes.c_uint64.from_buffer(self.segment, _SHM_OFFSET_TO_SERVER_TAIL)
+        self.to_client_head = ctypes.c_uint64.from_buffer(self.segment, _SHM_OFFSET_TO_CLIENT_HEAD)
+        self.to_client_tail = ctypes.c_uint64.from_buffer(self.segment, _SHM_OFFSET_TO_CLIENT_TAIL)
+        self.closed = False
+        self.spin_limit = 1000 if _CPU_COUNT > 1 else 0
+
+    def _wait(self):
+        """
+        Wait a little for the client, noting if it closed the control socket
+        """
+        (r, w, e) = select.select([self.control], [], [self.control], 0.0001)
+        if r or e:
+            try:
+                if self.control.recv(1, socket.MSG_PEEK) == "":
+                    self.closed = True
+            except socket.error:
+                self.closed = True
+
+    def available(self):
+        """
+        Return the number of bytes waiting to be received, or -1 if the client is gone
+        """
+        n = self.to_server_head.value - self.to_server_tail.value
+        if n == 0:
+            (r, w, e) = select.select([self.control], [], [self.control], 0)
+            if r or e:
+                self._wait()
+        if self.closed:
+            return -1
+        return n
+
+    def recv(self, bufsize, flags = 0):
+        spins = 0
+        while True:
+            n = self.available()
+            if n < 0:
+                return ""
+            if n > 0:
+                break
+            # requests usually follow within microseconds, so poll for a while (yielding if there is no core to spare) before sleeping
+            spins += 1
+            if spins > 10000:
+                self._wait()
+            elif spins > self.spin_limit:
+                _sched_yield()
+        tail = self.to_server_tail.value
+        offset = tail % self.capacity
+        n = min(n, bufsize, self.capacity - offset)
+        start = _SHM_OFFSET_DATA + offset
+        data = self.segment[start:start + n]
+        self.to_server_tail.value = tail + n
+        return data
+
+    def send(self, data, flags = 0):
+        head = self.to_client_head.value
+        while head - self.to_client_tail.value == self.capacity:
+            self._wait()
+            if self.closed:
+                raise socket.error("Shared memory client closed the connection")
+        offset = head % self.capacity
+        n = min(len(data), self.capacity - (head - self.to_client_tail.value), self.capacity - offset)
+        start = _SHM_OFFSET_DATA + self.capacity + offset
+        self.segment[start:start + n] = data[:n]
+        self.to_client_head.value = head + n
+        return n
+
+    def sendall(self, data, flags = 0):
+        while data:
+            data = data[self.send(data):]
+
+    def setsockopt(self, level, optname, value):
+        pass
+
+    def close(self):
+        del self.to_server_head, self.to_server_tail, self.to_client_head, self.to_client_tail
+        self.segment.close()
+        self.control.close()
+
+
 def find_unused_port():
     """
     Return an unused port number.
@@ -103,9 +228,13 @@ def forward_connection(client_socket, server_socket, process):
     Proxy connections until either socket runs out of data or process terminates.
     """
 
+    if isinstance(client_socket, SharedMemoryConnection):
+        return forward_shared_memory(client_socket, server_socket, process)
+
     logging.debug("Starting proxy mode")
 
-    client_socket.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+    if client_socket.family != socket.AF_UNIX:
+        client_socket.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
     server_socket.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
 
     do_exit = False
@@ -138,6 +267,44 @@ def forward_connection(client_socket, server_socket, process):
     logging.debug("Done with proxy mode")
 
 
+def forward_shared_memory(client_connection, server_socket, process):
+    """
+    Proxy a shared memory connection, polling it in between waiting for the socket
+    """
+
+    logging.debug("Starting shared memory proxy mode")
+
+    server_socket.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+
+    idle = 0
+    while True:
+        n = client_connection.available()
+        if n < 0:
+            break
+        if n > 0:
+            server_socket.sendall(client_connection.recv(65535))
+            idle = 0
+        else:
+            idle += 1
+            if idle <= 10000:
+                _sched_yield()
+
+        (r, w, e) = select.select([server_socket], [], [server_socket], 0 if idle <= 10000 else 0.0001)
+        if server_socket in e:
+            break
+        if server_socket in r:
+            try:
+                data = server_socket.recv(65535)
+            except:
+                break
+            if data == "":
+                break
+            client_connection.sendall(data)
+            idle = 0
+
+    logging.debug("Done with shared memory proxy mode")
+
+
 def parse_launch_configuration(launch_xml_string):
     """
     Returns tuple of options set in launch configuration
@@ -434,7 +601,50 @@ def handle_get_version(conn):
 
     # Send OK response and version info
     response = struct.pack("!iBBBiBBii", 4+1+1+1+4 + 1+1+4+4+len(_LAUNCHD_VERSION), 1+1+1+4, _CMD_GET_VERSION, 0x00, 0x00, 1+1+4+4+len(_LAUNCHD_VERSION), _CMD_GET_VERSION, _API_VERSION, len(_LAUNCHD_VERSION)) + _LAUNCHD_VERSION
-    conn.send(response)
+    conn.sendall(response)
+
+
+def recv_exactly(conn, length):
+    """
+    Read exactly length bytes from the connection, raising if it is closed first
+    """
+
+    buf = ""
+    while len(buf) < length:
+        data = conn.recv(length - len(buf))
+        if data == "":
+            raise RuntimeError("Connection closed by client")
+        buf += data
+    return buf
+
+
+def accept_shared_memory(conn):
+    """
+    If the first message on a Unix domain socket connection is CMD_SHM_ATTACH, attach to the announced
+    shared memory segment and return a connection using it. Otherwise return the socket unchanged.
+    """
+
+    head = conn.recv(6, socket.MSG_PEEK | socket.MSG_WAITALL)
+    if len(head) < 6 or ord(head[4]) == 0 or ord(head[5]) != _CMD_SHM_ATTACH:
+        return conn
+
+    msg_len = struct.unpack("!i", recv_exactly(conn, 4))[0] - 4
+    msg = recv_exactly(conn, msg_len)
+    name_len = struct.unpack("!i", msg[2:6])[0]
+    name = msg[6:6 + name_len]
+
+    logging.debug('Got CMD_SHM_ATTACH for "%s"' % name)
+
+    try:
+        shm = SharedMemoryConnection(conn, name)
+    except Exception, e:
+        description = str(e)
+        conn.send(struct.pack("!iBBBi", 4+1+1+1+4+len(description), 1+1+1+4+len(description), _CMD_SHM_ATTACH, 0xFF, len(description)) + description)
+        raise
+
+    # Send OK response
+    conn.send(struct.pack("!iBBBi", 4+1+1+1+4, 1+1+1+4, _CMD_SHM_ATTACH, 0x00, 0x00))
+    return shm
 
 
 def read_launch_config(conn):
@@ -442,64 +652,51 @@ def read_launch_config(conn):
     Read (and return) launch configuration from socket
     """
 
-    # Get TraCI message length
-    msg_len_buf = ""
-    while len(msg_len_buf) < 4:
-        msg_len_buf += conn.recv(4 - len(msg_len_buf))
-    msg_len = struct.unpack("!i", msg_len_buf)[0] - 4
+    while True:
+        # Get TraCI message length
+        msg_len = struct.unpack("!i", recv_exactly(conn, 4))[0] - 4
+
+        logging.debug("Got TraCI message of length %d" % msg_len)
 
-    logging.debug("Got TraCI message of length %d" % msg_len)
+        # Get TraCI command length
+        cmd_len = struct.unpack("!B", recv_exactly(conn, 1))[0] - 1
+        if cmd_len == -1:
+            cmd_len = struct.unpack("!i", recv_exactly(conn, 4))[0] - 5
 
-    # Get TraCI command length
-    cmd_len_buf = ""
-    cmd_len_buf += conn.recv(1)
-    cmd_len = struct.unpack("!B", cmd_len_buf)[0] - 1
-    if cmd_len == -1:
-        cmd_len_buf = ""
-        while len(cmd_len_buf) < 4:
-            cmd_len_buf += conn.recv(4 - len(cmd_len_buf))
-        cmd_len = struct.unpack("!i", cmd_len_buf)[0] - 5
+        logging.debug("Got TraCI command of length %d" % cmd_len)
 
-    logging.debug("Got TraCI command of length %d" % cmd_len)
+        # Get TraCI command ID
+        cmd_id = struct.unpack("!B", recv_exactly(conn, 1))[0]
 
-    # Get TraCI command ID
-    cmd_id_buf = ""
-    cmd_id_buf += conn.recv(1)
-    cmd_id = struct.unpack("!B", cmd_id_buf)[0]
+        logging.debug("Got TraCI command 0x%x" % cmd_id)
 
-    logging.debug("Got TraCI command 0x%x" % cmd_id)
+        if cmd_id != _CMD_GET_VERSION:
+            break
 
-    if cmd_id == _CMD_GET_VERSION:
         # handle get version command
         handle_get_version(conn)
         # ...and try reading the launch config again
-        return read_launch_config(conn)
-    elif cmd_id != _CMD_FILE_SEND:
+
+    if cmd_id != _CMD_FILE_SEND:
         raise RuntimeError("Expected CMD_FILE_SEND (0x%x), but got 0x%x" % (_CMD_FILE_SEND, cmd_id))
 
     # Get File name
-    fname_len_buf = ""
-    while len(fname_len_buf) < 4:
-        fname_len_buf += conn.recv(4 - len(fname_len_buf))
-    fname_len = struct.unpack("!i", fname_len_buf)[0]
-    fname = conn.recv(fname_len)
+    fname_len = struct.unpack("!i", recv_exactly(conn, 4))[0]
+    fname = recv_exactly(conn, fname_len)
     if fname != "sumo-launchd.launch.xml":
         raise RuntimeError('Launch configuration must be named "sumo-launchd.launch.xml", got "%s" instead.' % fname)
 
     logging.debug('Got CMD_FILE_SEND for "%s"' % fname)
 
     # Get File contents
-    data_len_buf = ""
-    while len(data_len_buf) < 4:
-        data_len_buf += conn.recv(4 - len(data_len_buf))
-    data_len = struct.unpack("!i", data_len_buf)[0]
-    data = conn.recv(data_len)
+    data_len = struct.unpack("!i", recv_exactly(conn, 4))[0]
+    data = recv_exactly(conn, data_len)
 
     logging.debug('Got CMD_FILE_SEND with data "%s"' % data)
 
     # Send OK response
     response = struct.pack("!iBBBi", 4+1+1+1+4, 1+1+1+4, _CMD_FILE_SEND, 0x00, 0x00)
-    conn.send(response)
+    conn.sendall(response)
     
     return data
         
@@ -509,9 +706,11 @@ def handle_connection(sumo_command, shlex, conn, addr, keep_temp):
     Handle incoming connection.
     """
 
-    logging.debug("Handling connection from %s on port %d" % addr)
+    logging.debug("Handling connection from %s" % describe_peer(addr))
 
     try:
+        if conn.family == socket.AF_UNIX:
+            conn = accept_shared_memory(conn)
         data = read_launch_config(conn)
         handle_launch_configuration(sumo_command, shlex, data, conn, keep_temp)
 
@@ -519,13 +718,23 @@ def handle_connection(sumo_command, shlex, conn, addr, keep_temp):
         logging.error("Aborting on error: %s" % e)
     
     finally:
-        logging.debug("Closing connection from %s on port %d" % addr)
+        logging.debug("Closing connection from %s" % describe_peer(addr))
         conn.close()
 
 
-def wait_for_connections(sumo_command, shlex, sumo_port, bind_address, do_daemonize, do_kill, pidfile, keep_temp):
+def describe_peer(addr):
     """
-    Open TCP socket, wait for connections, call handle_connection for each
+    Return a printable description of the address of a connected client
+    """
+
+    if isinstance(addr, tuple):
+        return "%s on port %d" % addr
+    return "Unix domain socket"
+
+
+def wait_for_connections(sumo_command, shlex, sumo_port, bind_address, unix_path, do_daemonize, do_kill, pidfile, keep_temp):
+    """
+    Open TCP socket (and Unix domain socket, if requested), wait for connections, call handle_connection for each
     """
    
     if do_kill:
@@ -536,6 +745,16 @@ def wait_for_connections(sumo_command, shlex, sumo_port, bind_address, do_daemon
     listener.bind((bind_address, sumo_port))
     listener.listen(5)
     logging.info("Listening on port %d" % sumo_port)
+    listeners = [listener]
+
+    if unix_path:
+        if os.path.exists(unix_path):
+            os.unlink(unix_path)
+        unix_listener = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        unix_listener.bind(unix_path)
+        unix_listener.listen(5)
+        logging.info("Listening on Unix domain socket %s" % unix_path)
+        listeners.append(unix_listener)
 
     if do_daemonize:
         logging.info("Detaching to run as daemon")
@@ -543,9 +762,11 @@ def wait_for_connections(sumo_command, shlex, sumo_port, bind_address, do_daemon
 
     try:
         while True:
-            conn, addr = listener.accept()
-            logging.debug("Connection from %s on port %d" % addr)
-            thread.start_new_thread(handle_connection, (sumo_command, shlex, conn, addr, keep_temp))
+            (r, w, e) = select.select(listeners, [], [])
+            for l in r:
+                conn, addr = l.accept()
+                logging.debug("Connection from %s" % describe_peer(addr))
+                thread.start_new_thread(handle_connection, (sumo_command, shlex, conn, addr, keep_temp))
     
     except exceptions.SystemExit:
         logging.warning("Killed.")
@@ -559,7 +780,10 @@ def wait_for_connections(sumo_command, shlex, sumo_port, bind_address, do_daemon
     finally:
         # clean up
         logging.info("Shutting down.")
-        listener.close()
+        for l in listeners:
+            l.close()
+        if unix_path and os.path.exists(unix_path):
+            os.unlink(unix_path)
 
 
 def check_kill_daemon(pidfile):
@@ -637,6 +861,7 @@ def main():
     parser.add_option("-c", "--command", dest="command", default="sumo", help="run SUMO as COMMAND [default: %default]", metavar="COMMAND")
     parser.add_option("-s", "--shlex", dest="shlex", default=False, action="store_true", help="treat command as shell string to execute, replace {} with command line parameters [default: no]")
     parser.add_option("-p", "--port", dest="port", type="int", default=9999, action="store", help="listen for connections on PORT [default: %default]", metavar="PORT")
+    parser.add_option("-u", "--unix", dest="unix", default=None, help="also listen for connections on Unix domain socket PATH, which also offers the shared memory transport [default: no]", metavar="PATH")
     parser.add_option("-b", "--bind", dest="bind", default="127.0.0.1", help="bind to ADDRESS [default: %default]", metavar="ADDRESS")
     parser.add_option("-L", "--logfile", dest="logfile", default=os.path.join(tempfile.gettempdir(), "sumo-launchd.log"), help="log messages to LOGFILE [default: %default]", metavar="LOGFILE")
     parser.add_option("-v", "--verbose", dest="count_verbose", default=0, action="count", help="increase verbosity [default: don't log infos, debug]")
@@ -662,7 +887,7 @@ def main():
         logging.warning("Superfluous command line arguments: \"%s\"" % " ".join(args))
 
     # this is where we'll spend our time
-    wait_for_connections(options.command, options.shlex, options.port, options.bind, options.daemonize, options.kill, options.pidfile, options.keep_temp)
+    wait_for_connections(options.command, options.shlex, options.port, options.bind, options.unix, options.daemonize, options.kill, options.pidfile, options.keep_temp)
 
 
 # Start main() when run interactively